@@ -0,0 +1,133 @@
+#ifndef ALGORITHM_HPP
+#define ALGORITHM_HPP
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+#include "Blas1.hpp"
+#include "ThreadPool.hpp"
+
+
+
+namespace Mat
+{
+
+	//How forEach, doForEveryEntry, transform and (map)reduce run: Sequential in the calling thread, or Parallel on the library
+	//thread pool (small operands still run in the calling thread). With Parallel, the callable is invoked from several
+	//threads at once, so it must not modify shared state without synchronisation
+	enum class Execution
+	{
+		Sequential,
+		Parallel
+	};
+
+
+
+	namespace Kernel
+	{
+
+		//Elementwise operations with Execution::Parallel are split into tasks of this many entries
+		const std::size_t ElementwiseGrain = 1 << 14;
+
+
+		//Calls body(begin, end) for consecutive ranges covering [0, n), on the thread pool if execution says so and n is large enough
+		template <typename Body> void forRanges(std::size_t n, Execution execution, Body const & body)
+		{
+			ThreadPool& pool = ThreadPool::instance();
+			if ((execution == Execution::Sequential) || (n < 2 * ElementwiseGrain) || (pool.getThreadCount() == 1))
+			{
+				body(0, n);
+				return;
+			}
+			pool.parallelFor(0, n, ElementwiseGrain, body);
+		}
+
+
+		//Calls f(a[i]) for all n entries
+		template <typename T, typename F> void forEach(std::size_t n, T* a, F & f, Execution execution)
+		{
+			forRanges(n, execution, [&](std::size_t begin, std::size_t end)
+			{
+				for (std::size_t i = begin; i < end; ++i)
+				{
+					f(a[i]);
+				}
+			});
+		}
+
+
+		//Computes dst[i] = f(a[i]) for all n entries (dst may be a)
+		template <typename T, typename U, typename F> void transform(std::size_t n, T const * a, U* dst, F & f, Execution execution)
+		{
+			forRanges(n, execution, [&](std::size_t begin, std::size_t end)
+			{
+				for (std::size_t i = begin; i < end; ++i)
+				{
+					dst[i] = f(a[i]);
+				}
+			});
+		}
+
+
+		//Computes dst[i] = f(a[i], b[i]) for all n entries (dst may be a or b)
+		template <typename T1, typename T2, typename U, typename F> void transform(std::size_t n, T1 const * a, T2 const * b, U* dst, F & f, Execution execution)
+		{
+			forRanges(n, execution, [&](std::size_t begin, std::size_t end)
+			{
+				for (std::size_t i = begin; i < end; ++i)
+				{
+					dst[i] = f(a[i], b[i]);
+				}
+			});
+		}
+
+
+		//Folds map(a[0]), ..., map(a[n - 1]) into init with op
+		//The entries are folded in chunks of ReductionChunk entries (each starting with its first mapped entry), and the chunk results
+		//are folded into init in order. Chunks are the same for both kinds of execution, so sequential and parallel runs give identical
+		//results for every thread count; op only has to be associative for the result to equal a plain left fold
+		template <typename R, typename T, typename Map, typename Op> R mapReduce(std::size_t n, T const * a, R init, Map & map, Op & op, Execution execution)
+		{
+			auto chunkValue = [&](std::size_t chunk) -> R
+			{
+				std::size_t const begin = chunk * ReductionChunk;
+				std::size_t const end = std::min(n, begin + ReductionChunk);
+				R partial = map(a[begin]);
+				for (std::size_t i = begin + 1; i < end; ++i)
+				{
+					partial = op(partial, map(a[i]));
+				}
+				return partial;
+			};
+
+			std::size_t const chunkCount = (n + ReductionChunk - 1) / ReductionChunk;
+			ThreadPool& pool = ThreadPool::instance();
+			if ((execution == Execution::Sequential) || (chunkCount < 2) || (pool.getThreadCount() == 1))
+			{
+				for (std::size_t chunk = 0; chunk < chunkCount; ++chunk)
+				{
+					init = op(init, chunkValue(chunk));
+				}
+				return init;
+			}
+
+			std::vector<R> partials(chunkCount);
+			pool.run(chunkCount, [&](std::size_t chunk)
+			{
+				partials[chunk] = chunkValue(chunk);
+			});
+			for (R const & partial : partials)
+			{
+				init = op(init, partial);
+			}
+			return init;
+		}
+
+
+
+	} //Namespace: Kernel
+
+} //Namespace: Mat
+
+#endif //ALGORITHM_HPP
@@ -0,0 +1,51 @@
+#include "AlignedAllocator.hpp"
+
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+
+namespace Mat
+{
+
+	//////////////////////
+	//Aligned heap memory
+
+	void* alignedAllocate(std::size_t bytes, std::size_t alignment)
+	{
+		if (bytes == 0)
+		{
+			bytes = alignment;
+		}
+#ifdef _WIN32
+		void* ptr = _aligned_malloc(bytes, alignment);
+		if (ptr == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+#else
+		void* ptr = nullptr;
+		if (posix_memalign(&ptr, alignment, bytes) != 0)
+		{
+			throw std::bad_alloc();
+		}
+#endif
+		return ptr;
+	}
+
+
+	void alignedFree(void* ptr)
+	{
+#ifdef _WIN32
+		_aligned_free(ptr);
+#else
+		std::free(ptr);
+#endif
+	}
+
+
+
+} //Namespace: Mat
+
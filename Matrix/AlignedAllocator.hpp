@@ -0,0 +1,118 @@
+#ifndef ALIGNEDALLOCATOR_HPP
+#define ALIGNEDALLOCATOR_HPP
+
+#include <cstddef>
+#include <new>
+#include <limits>
+#include <type_traits>
+
+#include "MemoryResource.hpp"
+#include "Profiler.hpp"
+
+
+
+namespace Mat
+{
+	//Alignment (in bytes) of every buffer allocated for Matrix and Vector (one cache line, enough for AVX-512 loads)
+	const std::size_t BufferAlignment = 64;
+
+
+	//Allocates bytes bytes aligned to alignment (throws std::bad_alloc on failure)
+	void* alignedAllocate(std::size_t bytes, std::size_t alignment);
+
+	//Frees memory obtained from alignedAllocate
+	void alignedFree(void* ptr);
+
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template AlignedAllocator, which hands out storage aligned to BufferAlignment from a MemoryResource
+	//A default constructed allocator uses the default resource of the calling thread at that moment.
+	//The resource moves and swaps along with the storage; copies of a container allocate from the current default resource
+	template <typename T> class AlignedAllocator
+	{
+	public:
+		typedef T value_type;
+		typedef std::size_t size_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef std::false_type propagate_on_container_copy_assignment;
+		typedef std::true_type propagate_on_container_move_assignment;
+		typedef std::true_type propagate_on_container_swap;
+
+		template <typename S> struct rebind
+		{
+			typedef AlignedAllocator<S> other;
+		};
+
+	private:
+		MemoryResource* mResource;
+
+	public:
+		AlignedAllocator()
+			: mResource(getDefaultResource())
+		{
+		}
+
+
+		AlignedAllocator(MemoryResource* resource)
+			: mResource((resource != nullptr) ? resource : getHeapResource())
+		{
+		}
+
+
+		template <typename S> AlignedAllocator(AlignedAllocator<S> const & other)
+			: mResource(other.getResource())
+		{
+		}
+
+
+		MemoryResource* getResource() const
+		{
+			return mResource;
+		}
+
+
+		AlignedAllocator<T> select_on_container_copy_construction() const
+		{
+			return AlignedAllocator<T>();
+		}
+
+
+		T* allocate(std::size_t n)
+		{
+			if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+			{
+				throw std::bad_alloc();
+			}
+			//Recorded here rather than in MemoryResource::allocate, where resources refilling from an upstream resource would count twice
+#ifdef MATRIX_ENABLE_PROFILING
+			Profiling::recordAllocation(n * sizeof(T));
+#endif
+			return static_cast<T*>(mResource->allocate(n * sizeof(T), BufferAlignment));
+		}
+
+
+		void deallocate(T* ptr, std::size_t n)
+		{
+			mResource->deallocate(ptr, n * sizeof(T), BufferAlignment);
+		}
+
+
+		template <typename S> bool operator==(AlignedAllocator<S> const & other) const
+		{
+			return mResource == other.getResource();
+		}
+
+
+		template <typename S> bool operator!=(AlignedAllocator<S> const & other) const
+		{
+			return mResource != other.getResource();
+		}
+
+	}; //Class Template: AlignedAllocator
+
+
+
+} //Namespace: Mat
+
+#endif //ALIGNEDALLOCATOR_HPP
+
@@ -0,0 +1,74 @@
+#ifndef ALLOCATIONCOUNTER_HPP
+#define ALLOCATIONCOUNTER_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <atomic>
+#include <new>
+
+
+
+//Replaces the global operator new and delete with versions that count every allocation of the program (thread-safe),
+//for benchmarks and tests that check how often a code path allocates. Matrix and Vector buffers do not go through operator new;
+//count them with a Mat::CountingResource. Replacement functions cannot be inline, so include this header in exactly one
+//translation unit of an executable, and never in the library
+
+
+
+namespace Mat
+{
+
+	//Returns the counter of the operator new replacements below
+	inline std::atomic<std::size_t>& operatorNewCounter()
+	{
+		static std::atomic<std::size_t> counter(0);
+		return counter;
+	}
+
+
+	//Returns the number of calls of operator new (and new[]) since the start of the program
+	inline std::size_t getOperatorNewCount()
+	{
+		return operatorNewCounter().load();
+	}
+
+} //Namespace: Mat
+
+
+
+void* operator new(std::size_t size)
+{
+	++Mat::operatorNewCounter();
+	if (void* pointer = std::malloc((size == 0) ? 1 : size))
+	{
+		return pointer;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+	return ::operator new(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+#endif //ALLOCATIONCOUNTER_HPP
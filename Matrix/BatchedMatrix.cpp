@@ -0,0 +1,26 @@
+#include "BatchedMatrix.hpp"
+
+
+
+namespace Mat
+{
+
+	//////////////////////////////////////////
+	//Struct IncompatibleBatchSizesException
+
+	IncompatibleBatchSizesException::IncompatibleBatchSizesException(std::string const & _message, std::size_t _count1, std::size_t _count2)
+		: message(_message), count1(_count1), count2(_count2)
+	{}
+
+
+
+	/////////////////////////////////////
+	//Struct InvalidBatchIndexException
+
+	InvalidBatchIndexException::InvalidBatchIndexException(std::string const & _message, std::size_t _index)
+		: message(_message), index(_index)
+	{}
+
+
+
+} //Namespace: Mat
@@ -0,0 +1,766 @@
+#ifndef BATCHED_MATRIX_HPP
+#define BATCHED_MATRIX_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#include "AlignedAllocator.hpp"
+#include "Matrix.hpp"
+#include "ThreadPool.hpp"
+
+
+
+namespace Mat
+{
+	namespace Kernel
+	{
+
+		//Number of matrices interleaved in one block of a batch: every entry of a block is stored as BatchLanes consecutive
+		//values (one per matrix), so the kernels below run the same operation on BatchLanes matrices in one vectorizable loop
+		const unsigned int BatchLanes = 16;
+
+		//Batches are split into chunks of about this many entries for the thread pool; smaller batches stay serial
+		const std::size_t BatchGrainEntries = std::size_t(1) << 15;
+
+
+		//Calls body(blockBegin, blockEnd) for all blocks, in parallel if there are enough entries
+		template <typename Body> void batchParallelFor(std::size_t blocks, std::size_t entriesPerBlock, Body const & body)
+		{
+			std::size_t const grain = std::max<std::size_t>(1, BatchGrainEntries / std::max<std::size_t>(entriesPerBlock * BatchLanes, 1));
+			if (blocks <= grain)
+			{
+				body(std::size_t(0), blocks);
+				return;
+			}
+			ThreadPool::instance().parallelFor(0, blocks, grain, body);
+		}
+
+
+		//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		//Struct Template BatchedDeterminant, which writes the determinants of BatchLanes N x N matrices to det
+		//a[i] points to the BatchLanes values of entry i (row-major). Up to 4 x 4 the Laplace expansion runs on whole lanes
+		//(exact for integers), larger matrices go through FixedDeterminant one by one
+		template <typename T, unsigned int N, bool Small = (N <= 4)> struct BatchedDeterminant
+		{
+			static void compute(T const * const * a, T* det)
+			{
+				for (unsigned int l = 0; l < BatchLanes; ++l)
+				{
+					T matrix[N * N];
+					for (unsigned int i = 0; i < N * N; ++i)
+					{
+						matrix[i] = a[i][l];
+					}
+					det[l] = FixedDeterminant<T, N>::compute(matrix);
+				}
+			}
+		};
+
+		template <typename T> struct BatchedDeterminant<T, 1, true>
+		{
+			static void compute(T const * const * a, T* det)
+			{
+				std::copy(a[0], a[0] + BatchLanes, det);
+			}
+		};
+
+		template <typename T> struct BatchedDeterminant<T, 2, true>
+		{
+			static void compute(T const * const * a, T* det)
+			{
+				T const * a0 = a[0];
+				T const * a1 = a[1];
+				T const * a2 = a[2];
+				T const * a3 = a[3];
+				for (unsigned int l = 0; l < BatchLanes; ++l)
+				{
+					det[l] = a0[l] * a3[l] - a1[l] * a2[l];
+				}
+			}
+		};
+
+		//Laplace expansion along the first row (minors only select lanes, nothing is copied)
+		template <typename T, unsigned int N> struct BatchedDeterminant<T, N, true>
+		{
+			static void compute(T const * const * a, T* det)
+			{
+				T sum[BatchLanes] = {};
+				unroll<N>([&](unsigned int col)
+				{
+					T const * minor[(N - 1) * (N - 1)];
+					for (unsigned int y = 0; y < N - 1; ++y)
+					{
+						for (unsigned int x = 0; x < N - 1; ++x)
+						{
+							minor[y * (N - 1) + x] = a[(y + 1) * N + ((x < col) ? x : x + 1)];
+						}
+					}
+					T minorDet[BatchLanes];
+					BatchedDeterminant<T, N - 1>::compute(minor, minorDet);
+					T const * first = a[col];
+					if (col % 2 == 0)
+					{
+						for (unsigned int l = 0; l < BatchLanes; ++l)
+						{
+							sum[l] += first[l] * minorDet[l];
+						}
+					}
+					else
+					{
+						for (unsigned int l = 0; l < BatchLanes; ++l)
+						{
+							sum[l] -= first[l] * minorDet[l];
+						}
+					}
+				});
+				std::copy(sum, sum + BatchLanes, det);
+			}
+		};
+
+	} //Namespace: Kernel
+
+
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Struct IncompatibleBatchSizesException, which can be thrown if two batches do not hold the same number of items
+	struct IncompatibleBatchSizesException
+	{
+		std::string message;
+		std::size_t count1;
+		std::size_t count2;
+		IncompatibleBatchSizesException(std::string const & _message, std::size_t _count1, std::size_t _count2);
+	};
+
+
+	////////////////////////////////////////////////////////////////////////////////////////////////
+	//Struct InvalidBatchIndexException, which can be thrown if an index does not address a batch item
+	struct InvalidBatchIndexException
+	{
+		std::string message;
+		std::size_t index;
+		InvalidBatchIndexException(std::string const & _message, std::size_t _index);
+	};
+
+
+
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template BatchedMatrix, which stores count M x N matrices in structure-of-arrays blocks of Kernel::BatchLanes:
+	//entry (x, y) of matrix i lives at data()[((i / BatchLanes) * M * N + y * N + x) * BatchLanes + i % BatchLanes].
+	//The last block is padded with zeros. Operations run on whole blocks, vectorized across the matrices, and in parallel
+	template <typename T, unsigned int M, unsigned int N> class BatchedMatrix
+	{
+	public:
+		typedef T ValueType;
+		typedef std::vector<T, AlignedAllocator<T>> Buffer;
+		static const unsigned int Lanes = Kernel::BatchLanes;
+		static const std::size_t BlockEntries = static_cast<std::size_t>(M) * N * Kernel::BatchLanes;
+
+	private:
+		std::size_t mCount;
+		Buffer mData;
+
+	public:
+		//Standard constructor constructs an empty batch
+		BatchedMatrix()
+			: mCount(0), mData()
+		{}
+
+
+		//Constructor that constructs count matrices with every entry set to value
+		explicit BatchedMatrix(std::size_t count, T const & value = T())
+			: mCount(count), mData(BatchedMatrix::getBlockCount(count) * BlockEntries, value)
+		{
+			this->clearPadding();
+		}
+
+
+		//Constructor that constructs count matrices with value, allocated from resource instead of the default resource
+		BatchedMatrix(std::size_t count, T const & value, MemoryResource* resource)
+			: mCount(count), mData(BatchedMatrix::getBlockCount(count) * BlockEntries, value, AlignedAllocator<T>(resource))
+		{
+			this->clearPadding();
+		}
+
+
+		//Destructor and all other constructors stay default!
+
+
+	public:
+		//Returns the number of matrices
+		std::size_t getCount() const
+		{
+			return mCount;
+		}
+
+
+		//Returns the size of every matrix
+		static MatrixSize getSize()
+		{
+			return MN(M, N);
+		}
+
+
+		//Returns the number of blocks of Lanes matrices
+		std::size_t getBlockCount() const
+		{
+			return BatchedMatrix::getBlockCount(mCount);
+		}
+
+
+		//Returns the memory resource the storage was allocated from
+		MemoryResource* getMemoryResource() const
+		{
+			return mData.get_allocator().getResource();
+		}
+
+
+		//Gives direct access to the interleaved storage
+		T* data()
+		{
+			return mData.data();
+		}
+
+
+		//Gives direct constant access to the interleaved storage
+		T const * data() const
+		{
+			return mData.data();
+		}
+
+
+		//Returns a pointer to the Lanes values of entry (row-major index) entry in block block (no bounds check)
+		T* lanePtr(std::size_t block, unsigned int entry)
+		{
+			return mData.data() + (block * M * N + entry) * Lanes;
+		}
+
+
+		//Returns a constant pointer to the Lanes values of entry entry in block block (no bounds check)
+		T const * lanePtr(std::size_t block, unsigned int entry) const
+		{
+			return mData.data() + (block * M * N + entry) * Lanes;
+		}
+
+
+		//Gives access to entry pos of matrix index
+		T& at(std::size_t index, MatrixEntry const & pos)
+		{
+			this->checkIndex(index, pos, "BatchedMatrix<T, M, N>::at(std::size_t index, MatrixEntry const & pos)");
+			return mData[this->getOffset(index, pos.y(), pos.x())];
+		}
+
+
+		//Gives constant access to entry pos of matrix index
+		T const & at(std::size_t index, MatrixEntry const & pos) const
+		{
+			this->checkIndex(index, pos, "BatchedMatrix<T, M, N>::at(std::size_t index, MatrixEntry const & pos) const");
+			return mData[this->getOffset(index, pos.y(), pos.x())];
+		}
+
+
+		//Gives access to the entry in row row and column column of matrix index, bounds are only checked in debug builds
+		T& operator()(std::size_t index, unsigned int row, unsigned int column)
+		{
+#ifdef MATRIX_DEBUG_CHECKS
+			this->checkIndex(index, MN(row, column), "BatchedMatrix<T, M, N>::operator()(std::size_t index, unsigned int row, unsigned int column)");
+#endif
+			return mData[this->getOffset(index, row, column)];
+		}
+
+
+		//Gives constant access to the entry in row row and column column of matrix index, bounds are only checked in debug builds
+		T const & operator()(std::size_t index, unsigned int row, unsigned int column) const
+		{
+#ifdef MATRIX_DEBUG_CHECKS
+			this->checkIndex(index, MN(row, column), "BatchedMatrix<T, M, N>::operator()(std::size_t index, unsigned int row, unsigned int column) const");
+#endif
+			return mData[this->getOffset(index, row, column)];
+		}
+
+
+		//Returns a copy of matrix index
+		Matrix<T, M, N> get(std::size_t index) const
+		{
+			this->checkIndex(index, MN(0, 0), "BatchedMatrix<T, M, N>::get(std::size_t index) const");
+			Matrix<T, M, N> matrix;
+			for (unsigned int e = 0; e < M * N; ++e)
+			{
+				matrix.data()[e] = mData[this->getOffset(index, 0, e)];
+			}
+			return matrix;
+		}
+
+
+		//Overwrites matrix index with matrix
+		void set(std::size_t index, Matrix<T, M, N> const & matrix)
+		{
+			this->checkIndex(index, MN(0, 0), "BatchedMatrix<T, M, N>::set(std::size_t index, Matrix<T, M, N> const & matrix)");
+			for (unsigned int e = 0; e < M * N; ++e)
+			{
+				mData[this->getOffset(index, 0, e)] = matrix.data()[e];
+			}
+		}
+
+
+		//Sets every entry of every matrix to value (padding lanes stay zero)
+		void fillWith(T const & value)
+		{
+			std::fill(mData.begin(), mData.end(), value);
+			this->clearPadding();
+		}
+
+
+		//Returns the traces of all matrices
+		Vector<T> trace() const
+		{
+			Vector<T> res(static_cast<VectorSize>(mCount));
+			Kernel::batchParallelFor(this->getBlockCount(), M * N, [&](std::size_t blockBegin, std::size_t blockEnd)
+			{
+				for (std::size_t b = blockBegin; b < blockEnd; ++b)
+				{
+					T sum[Lanes] = {};
+					for (unsigned int i = 0; i < std::min(M, N); ++i)
+					{
+						T const * d = this->lanePtr(b, i * N + i);
+						for (unsigned int l = 0; l < Lanes; ++l)
+						{
+							sum[l] += d[l];
+						}
+					}
+					this->storeLanes(sum, b, res);
+				}
+			});
+			return res;
+		}
+
+
+		//Returns the determinants of all matrices (exact for integers up to 4 x 4)
+		Vector<T> det() const
+		{
+			static_assert(M == N, "BatchedMatrix<T, M, N>::det(): matrices are not square!");
+			Vector<T> res(static_cast<VectorSize>(mCount));
+			Kernel::batchParallelFor(this->getBlockCount(), M * N, [&](std::size_t blockBegin, std::size_t blockEnd)
+			{
+				for (std::size_t b = blockBegin; b < blockEnd; ++b)
+				{
+					T const * entries[M * N];
+					for (unsigned int e = 0; e < M * N; ++e)
+					{
+						entries[e] = this->lanePtr(b, e);
+					}
+					T det[Lanes];
+					Kernel::BatchedDeterminant<T, N>::compute(entries, det);
+					this->storeLanes(det, b, res);
+				}
+			});
+			return res;
+		}
+
+
+		//Returns the batch of transposed matrices
+		BatchedMatrix<T, N, M> getTransposed() const
+		{
+			BatchedMatrix<T, N, M> res(mCount);
+			Kernel::batchParallelFor(this->getBlockCount(), M * N, [&](std::size_t blockBegin, std::size_t blockEnd)
+			{
+				for (std::size_t b = blockBegin; b < blockEnd; ++b)
+				{
+					for (unsigned int y = 0; y < M; ++y)
+					{
+						for (unsigned int x = 0; x < N; ++x)
+						{
+							std::copy(this->lanePtr(b, y * N + x), this->lanePtr(b, y * N + x) + Lanes, res.lanePtr(b, x * M + y));
+						}
+					}
+				}
+			});
+			return res;
+		}
+
+
+		//Transposes every matrix in place
+		void transpose()
+		{
+			static_assert(M == N, "BatchedMatrix<T, M, N>::transpose(): matrices are not square (use getTransposed)!");
+			Kernel::batchParallelFor(this->getBlockCount(), M * N, [&](std::size_t blockBegin, std::size_t blockEnd)
+			{
+				for (std::size_t b = blockBegin; b < blockEnd; ++b)
+				{
+					for (unsigned int y = 0; y < M; ++y)
+					{
+						for (unsigned int x = y + 1; x < N; ++x)
+						{
+							std::swap_ranges(this->lanePtr(b, y * N + x), this->lanePtr(b, y * N + x) + Lanes, this->lanePtr(b, x * N + y));
+						}
+					}
+				}
+			});
+		}
+
+
+	private:
+		static std::size_t getBlockCount(std::size_t count)
+		{
+			return (count + Lanes - 1) / Lanes;
+		}
+
+
+		//Zeroes the lanes of the last block that belong to no matrix
+		void clearPadding()
+		{
+			std::size_t const rest = mCount % Lanes;
+			for (unsigned int e = 0; (rest != 0) && (e < M * N); ++e)
+			{
+				std::fill(this->lanePtr(mCount / Lanes, e) + rest, this->lanePtr(mCount / Lanes, e) + Lanes, T(0));
+			}
+		}
+
+
+		std::size_t getOffset(std::size_t index, unsigned int row, unsigned int column) const
+		{
+			return ((index / Lanes) * M * N + static_cast<std::size_t>(row) * N + column) * Lanes + index % Lanes;
+		}
+
+
+		void checkIndex(std::size_t index, MatrixEntry const & pos, char const * function) const
+		{
+			if (index >= mCount)
+			{
+				throw InvalidBatchIndexException(std::string(function) + ": index is out of range!", index);
+			}
+			if ((pos.x() >= N) || (pos.y() >= M))
+			{
+				throw InvalidIndicesException(std::string(function) + ": pos is out of range!", pos);
+			}
+		}
+
+
+		//Copies the results of block block to their places in res (the padding lanes of the last block are dropped)
+		void storeLanes(T const * lanes, std::size_t block, Vector<T>& res) const
+		{
+			std::size_t const first = block * Lanes;
+			std::copy(lanes, lanes + std::min<std::size_t>(Lanes, mCount - first), res.data() + first);
+		}
+
+
+	}; //Class Template: BatchedMatrix
+
+
+
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template BatchedVector, which stores count vectors of N components interleaved like BatchedMatrix<T, N, 1>:
+	//component i of vector j lives at data()[((j / BatchLanes) * N + i) * BatchLanes + j % BatchLanes]
+	template <typename T, unsigned int N> class BatchedVector
+	{
+	public:
+		typedef T ValueType;
+		typedef std::vector<T, AlignedAllocator<T>> Buffer;
+		static const unsigned int Lanes = Kernel::BatchLanes;
+		static const std::size_t BlockEntries = static_cast<std::size_t>(N) * Kernel::BatchLanes;
+
+	private:
+		std::size_t mCount;
+		Buffer mData;
+
+	public:
+		//Standard constructor constructs an empty batch
+		BatchedVector()
+			: mCount(0), mData()
+		{}
+
+
+		//Constructor that constructs count vectors with every component set to value
+		explicit BatchedVector(std::size_t count, T const & value = T())
+			: mCount(count), mData((count + Lanes - 1) / Lanes * BlockEntries, value)
+		{
+			this->clearPadding();
+		}
+
+
+		//Constructor that constructs count vectors with value, allocated from resource instead of the default resource
+		BatchedVector(std::size_t count, T const & value, MemoryResource* resource)
+			: mCount(count), mData((count + Lanes - 1) / Lanes * BlockEntries, value, AlignedAllocator<T>(resource))
+		{
+			this->clearPadding();
+		}
+
+
+		//Destructor and all other constructors stay default!
+
+
+	public:
+		//Returns the number of vectors
+		std::size_t getCount() const
+		{
+			return mCount;
+		}
+
+
+		//Returns the size of every vector
+		static VectorSize getSize()
+		{
+			return N;
+		}
+
+
+		//Returns the number of blocks of Lanes vectors
+		std::size_t getBlockCount() const
+		{
+			return (mCount + Lanes - 1) / Lanes;
+		}
+
+
+		//Returns the memory resource the storage was allocated from
+		MemoryResource* getMemoryResource() const
+		{
+			return mData.get_allocator().getResource();
+		}
+
+
+		//Gives direct access to the interleaved storage
+		T* data()
+		{
+			return mData.data();
+		}
+
+
+		//Gives direct constant access to the interleaved storage
+		T const * data() const
+		{
+			return mData.data();
+		}
+
+
+		//Returns a pointer to the Lanes values of component entry in block block (no bounds check)
+		T* lanePtr(std::size_t block, unsigned int entry)
+		{
+			return mData.data() + (block * N + entry) * Lanes;
+		}
+
+
+		//Returns a constant pointer to the Lanes values of component entry in block block (no bounds check)
+		T const * lanePtr(std::size_t block, unsigned int entry) const
+		{
+			return mData.data() + (block * N + entry) * Lanes;
+		}
+
+
+		//Gives access to component entry of vector index
+		T& at(std::size_t index, VectorEntry const & entry)
+		{
+			this->checkIndex(index, entry, "BatchedVector<T, N>::at(std::size_t index, VectorEntry const & entry)");
+			return mData[this->getOffset(index, entry)];
+		}
+
+
+		//Gives constant access to component entry of vector index
+		T const & at(std::size_t index, VectorEntry const & entry) const
+		{
+			this->checkIndex(index, entry, "BatchedVector<T, N>::at(std::size_t index, VectorEntry const & entry) const");
+			return mData[this->getOffset(index, entry)];
+		}
+
+
+		//Gives access to component entry of vector index, bounds are only checked in debug builds
+		T& operator()(std::size_t index, VectorEntry const & entry)
+		{
+#ifdef MATRIX_DEBUG_CHECKS
+			this->checkIndex(index, entry, "BatchedVector<T, N>::operator()(std::size_t index, VectorEntry const & entry)");
+#endif
+			return mData[this->getOffset(index, entry)];
+		}
+
+
+		//Gives constant access to component entry of vector index, bounds are only checked in debug builds
+		T const & operator()(std::size_t index, VectorEntry const & entry) const
+		{
+#ifdef MATRIX_DEBUG_CHECKS
+			this->checkIndex(index, entry, "BatchedVector<T, N>::operator()(std::size_t index, VectorEntry const & entry) const");
+#endif
+			return mData[this->getOffset(index, entry)];
+		}
+
+
+		//Returns a copy of vector index
+		Vector<T, N> get(std::size_t index) const
+		{
+			this->checkIndex(index, 0, "BatchedVector<T, N>::get(std::size_t index) const");
+			Vector<T, N> vec;
+			for (unsigned int i = 0; i < N; ++i)
+			{
+				vec.data()[i] = mData[this->getOffset(index, i)];
+			}
+			return vec;
+		}
+
+
+		//Overwrites vector index with vec
+		void set(std::size_t index, Vector<T, N> const & vec)
+		{
+			this->checkIndex(index, 0, "BatchedVector<T, N>::set(std::size_t index, Vector<T, N> const & vec)");
+			for (unsigned int i = 0; i < N; ++i)
+			{
+				mData[this->getOffset(index, i)] = vec.data()[i];
+			}
+		}
+
+
+		//Sets every component of every vector to value (padding lanes stay zero)
+		void fillWith(T const & value)
+		{
+			std::fill(mData.begin(), mData.end(), value);
+			this->clearPadding();
+		}
+
+
+	private:
+		//Zeroes the lanes of the last block that belong to no vector
+		void clearPadding()
+		{
+			std::size_t const rest = mCount % Lanes;
+			for (unsigned int i = 0; (rest != 0) && (i < N); ++i)
+			{
+				std::fill(this->lanePtr(mCount / Lanes, i) + rest, this->lanePtr(mCount / Lanes, i) + Lanes, T(0));
+			}
+		}
+
+
+		std::size_t getOffset(std::size_t index, VectorEntry entry) const
+		{
+			return ((index / Lanes) * N + entry) * Lanes + index % Lanes;
+		}
+
+
+		void checkIndex(std::size_t index, VectorEntry entry, char const * function) const
+		{
+			if (index >= mCount)
+			{
+				throw InvalidBatchIndexException(std::string(function) + ": index is out of range!", index);
+			}
+			if (entry >= N)
+			{
+				throw InvalidIndexException(std::string(function) + ": entry is not a valid index!", entry);
+			}
+		}
+
+
+	}; //Class Template: BatchedVector
+
+
+
+	//Multiplies every matrix of a with the matrix of b at the same index and writes the products to res,
+	//which is only reallocated if it does not hold as many matrices as a (so loops can reuse it without allocating)
+	//res may be a or b; the products are then formed in a temporary first
+	template <typename T, unsigned int M, unsigned int N, unsigned int P> void multiply(BatchedMatrix<T, M, N> const & a, BatchedMatrix<T, N, P> const & b, BatchedMatrix<T, M, P>& res)
+	{
+		if (a.getCount() != b.getCount())
+		{
+			throw IncompatibleBatchSizesException("multiply(BatchedMatrix<T, M, N> const & a, BatchedMatrix<T, N, P> const & b, BatchedMatrix<T, M, P>& res): a and b do not hold the same number of matrices!", a.getCount(), b.getCount());
+		}
+		if ((static_cast<void const *>(&res) == static_cast<void const *>(&a)) || (static_cast<void const *>(&res) == static_cast<void const *>(&b)))
+		{
+			BatchedMatrix<T, M, P> product(a.getCount());
+			multiply(a, b, product);
+			res = std::move(product);
+			return;
+		}
+		if (res.getCount() != a.getCount())
+		{
+			res = BatchedMatrix<T, M, P>(a.getCount());
+		}
+		unsigned int const L = Kernel::BatchLanes;
+		Kernel::batchParallelFor(a.getBlockCount(), static_cast<std::size_t>(M) * (N + P), [&](std::size_t blockBegin, std::size_t blockEnd)
+		{
+			for (std::size_t blk = blockBegin; blk < blockEnd; ++blk)
+			{
+				for (unsigned int i = 0; i < M; ++i)
+				{
+					for (unsigned int j = 0; j < P; ++j)
+					{
+						T sum[L] = {};
+						for (unsigned int k = 0; k < N; ++k)
+						{
+							T const * aik = a.lanePtr(blk, i * N + k);
+							T const * bkj = b.lanePtr(blk, k * P + j);
+							for (unsigned int l = 0; l < L; ++l)
+							{
+								sum[l] += aik[l] * bkj[l];
+							}
+						}
+						std::copy(sum, sum + L, res.lanePtr(blk, i * P + j));
+					}
+				}
+			}
+		});
+	}
+
+
+	//Multiplies every matrix of a with the matrix of b at the same index
+	template <typename T, unsigned int M, unsigned int N, unsigned int P> BatchedMatrix<T, M, P> operator*(BatchedMatrix<T, M, N> const & a, BatchedMatrix<T, N, P> const & b)
+	{
+		BatchedMatrix<T, M, P> res;
+		multiply(a, b, res);
+		return res;
+	}
+
+
+	//Multiplies every matrix of a with the vector of v at the same index and writes the products to res (reallocated only if needed)
+	//res may be v; the products are then formed in a temporary first
+	template <typename T, unsigned int M, unsigned int N> void multiply(BatchedMatrix<T, M, N> const & a, BatchedVector<T, N> const & v, BatchedVector<T, M>& res)
+	{
+		if (a.getCount() != v.getCount())
+		{
+			throw IncompatibleBatchSizesException("multiply(BatchedMatrix<T, M, N> const & a, BatchedVector<T, N> const & v, BatchedVector<T, M>& res): a and v do not hold the same number of items!", a.getCount(), v.getCount());
+		}
+		if (static_cast<void const *>(&res) == static_cast<void const *>(&v))
+		{
+			BatchedVector<T, M> product(a.getCount());
+			multiply(a, v, product);
+			res = std::move(product);
+			return;
+		}
+		if (res.getCount() != a.getCount())
+		{
+			res = BatchedVector<T, M>(a.getCount());
+		}
+		unsigned int const L = Kernel::BatchLanes;
+		Kernel::batchParallelFor(a.getBlockCount(), static_cast<std::size_t>(M) * N + N + M, [&](std::size_t blockBegin, std::size_t blockEnd)
+		{
+			for (std::size_t blk = blockBegin; blk < blockEnd; ++blk)
+			{
+				for (unsigned int i = 0; i < M; ++i)
+				{
+					T sum[L] = {};
+					for (unsigned int k = 0; k < N; ++k)
+					{
+						T const * aik = a.lanePtr(blk, i * N + k);
+						T const * vk = v.lanePtr(blk, k);
+						for (unsigned int l = 0; l < L; ++l)
+						{
+							sum[l] += aik[l] * vk[l];
+						}
+					}
+					std::copy(sum, sum + L, res.lanePtr(blk, i));
+				}
+			}
+		});
+	}
+
+
+	//Multiplies every matrix of a with the vector of v at the same index
+	template <typename T, unsigned int M, unsigned int N> BatchedVector<T, M> operator*(BatchedMatrix<T, M, N> const & a, BatchedVector<T, N> const & v)
+	{
+		BatchedVector<T, M> res;
+		multiply(a, v, res);
+		return res;
+	}
+
+
+
+} //Namespace: Mat
+
+#endif //BATCHED_MATRIX_HPP
@@ -0,0 +1,348 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <functional>
+
+#include "Matrix.hpp"
+#include "Vector.hpp"
+#include "MemoryResource.hpp"
+#include "ThreadPool.hpp"
+#include "Simd.hpp"
+#include "AllocationCounter.hpp"
+
+
+//Benchmark of the Matrix/Vector hot paths over a grid of sizes and element types
+//Usage: MatrixBenchmark [--quick] [--sizes 64,256,1024] [--types float,double,int] [--min-time seconds] [--json file]
+//Every operation on n x n matrices (vectors of length n, inner product of length n * n) is timed, and
+//GFLOP/s, GB/s (of compulsory memory traffic) and heap allocations per operation are reported
+
+
+namespace
+{
+
+	struct Options
+	{
+		std::vector<unsigned int> sizes = { 64, 256, 1024 };
+		std::vector<std::string> types = { "float", "double", "int" };
+		double minTime = 0.2; //Seconds every measurement runs at least
+		std::string jsonPath;
+	};
+
+
+	struct Result
+	{
+		std::string operation;
+		std::string type;
+		unsigned int size;
+		double seconds; //Per operation (best of all batches)
+		double flops; //Per operation
+		double bytes; //Per operation
+		double allocations; //Per operation (Matrix/Vector buffers and operator new)
+		std::size_t repetitions;
+	};
+
+
+	//Keeps the optimizer from dropping the benchmarked work
+	volatile double gSink = 0.0;
+
+
+	//Times op: calibrates a batch to take about minTime / 5, then runs five batches and keeps the fastest
+	//Allocations are counted over the five batches: buffers by counter, which has to be the default resource of all operands, everything else by operator new
+	Result measure(std::string const & operation, std::string const & type, unsigned int size, double flops, double bytes, double minTime, Mat::CountingResource& counter, std::function<void()> const & op)
+	{
+		typedef std::chrono::steady_clock Clock;
+		op(); //Warm-up
+		std::size_t batch = 1;
+		for (;;)
+		{
+			Clock::time_point const start = Clock::now();
+			for (std::size_t i = 0; i < batch; ++i)
+			{
+				op();
+			}
+			double const elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+			if ((elapsed >= minTime / 5.0) || (batch >= (std::size_t(1) << 30)))
+			{
+				break;
+			}
+			batch = (elapsed <= 0.0) ? batch * 16 : std::max(batch + 1, static_cast<std::size_t>(batch * (minTime / 5.0) / elapsed * 1.1));
+		}
+
+		counter.resetCounts();
+		std::size_t const heapAllocations = Mat::getOperatorNewCount();
+		double best = 0.0;
+		for (int b = 0; b < 5; ++b)
+		{
+			Clock::time_point const start = Clock::now();
+			for (std::size_t i = 0; i < batch; ++i)
+			{
+				op();
+			}
+			double const perOperation = std::chrono::duration<double>(Clock::now() - start).count() / static_cast<double>(batch);
+			best = (b == 0) ? perOperation : std::min(best, perOperation);
+		}
+
+		Result result;
+		result.operation = operation;
+		result.type = type;
+		result.size = size;
+		result.seconds = best;
+		result.flops = flops;
+		result.bytes = bytes;
+		std::size_t const allocations = counter.getAllocationCount() + (Mat::getOperatorNewCount() - heapAllocations);
+		result.allocations = static_cast<double>(allocations) / static_cast<double>(5 * batch);
+		result.repetitions = 5 * batch;
+		return result;
+	}
+
+
+	template <typename T> Mat::Matrix<T> makeMatrix(unsigned int n, unsigned int seed)
+	{
+		Mat::Matrix<T> m(Mat::XY(n, n));
+		unsigned int state = seed;
+		m.doForEveryEntry([&](T& entry, Mat::MatrixEntry const &)
+		{
+			state = state * 1664525u + 1013904223u;
+			entry = static_cast<T>(static_cast<int>(state >> 24) % 7 - 3);
+		});
+		return m;
+	}
+
+
+	template <typename T> void benchmarkType(std::string const & type, Options const & options, std::vector<Result>& results)
+	{
+		//Operands and results allocate from counter as well (it outlives them), since moved results keep their resource
+		Mat::CountingResource counter;
+		Mat::ScopedMemoryResource scope(counter);
+		double const s = sizeof(T);
+		for (unsigned int n : options.sizes)
+		{
+			double const n2 = static_cast<double>(n) * n;
+			double const n3 = n2 * n;
+			Mat::Matrix<T> a = makeMatrix<T>(n, 1);
+			Mat::Matrix<T> b = makeMatrix<T>(n, 2);
+			Mat::Vector<T> v(n, T(1));
+			Mat::Vector<T> w(n * n, T(1));
+			Mat::Vector<T> w2(n * n, T(2));
+			Mat::Matrix<T> c;
+			Mat::Vector<T> r;
+
+			results.push_back(measure("matrix*matrix", type, n, 2.0 * n3, 3.0 * n2 * s, options.minTime, counter, [&]()
+			{
+				c = a * b;
+			}));
+			results.push_back(measure("matrix*vector", type, n, 2.0 * n2, (n2 + 2.0 * n) * s, options.minTime, counter, [&]()
+			{
+				r = a * v;
+			}));
+			results.push_back(measure("matrix+matrix", type, n, n2, 3.0 * n2 * s, options.minTime, counter, [&]()
+			{
+				c = a + b;
+			}));
+			results.push_back(measure("matrix-matrix", type, n, n2, 3.0 * n2 * s, options.minTime, counter, [&]()
+			{
+				c = a - b;
+			}));
+			results.push_back(measure("det", type, n, 2.0 / 3.0 * n3, n2 * (s + sizeof(double)), options.minTime, counter, [&]()
+			{
+				gSink = gSink + a.det();
+			}));
+			results.push_back(measure("getTransposed", type, n, 0.0, 2.0 * n2 * s, options.minTime, counter, [&]()
+			{
+				c = a.getTransposed();
+			}));
+			results.push_back(measure("transpose", type, n, 0.0, 2.0 * n2 * s, options.minTime, counter, [&]()
+			{
+				a.transpose();
+			}));
+			results.push_back(measure("getSubmatrix", type, n, 0.0, 2.0 * (n / 2) * (n / 2) * s, options.minTime, counter, [&]()
+			{
+				c = a.getSubmatrix(Mat::XY(n / 4, n / 4), Mat::XY(n / 2, n / 2));
+			}));
+			results.push_back(measure("find", type, n, n2, n2 * s, options.minTime, counter, [&]()
+			{
+				gSink = gSink + static_cast<double>(a.find(T(3)).size());
+			}));
+			results.push_back(measure("findAll", type, n, n2, n2 * s, options.minTime, counter, [&]()
+			{
+				gSink = gSink + static_cast<double>(a.findAll(T(3)).size());
+			}));
+			results.push_back(measure("count", type, n, n2, n2 * s, options.minTime, counter, [&]()
+			{
+				gSink = gSink + static_cast<double>(a.count(T(3)));
+			}));
+			c = a; //getSubmatrix left an n/2 x n/2 matrix in c, the entrywise visits run over n x n
+			results.push_back(measure("doForEveryEntry", type, n, n2, 2.0 * n2 * s, options.minTime, counter, [&]()
+			{
+				c.doForEveryEntry([](T& entry, Mat::MatrixEntry const &) { entry += T(1); });
+			}));
+			results.push_back(measure("forEach(parallel)", type, n, n2, 2.0 * n2 * s, options.minTime, counter, [&]()
+			{
+				c.forEach([](T& entry) { entry += T(1); }, Mat::Execution::Parallel);
+			}));
+			results.push_back(measure("reduce(parallel)", type, n, n2, n2 * s, options.minTime, counter, [&]()
+			{
+				gSink = gSink + static_cast<double>(Mat::reduce(a, T(0), [](T const & x, T const & y) { return x + y; }, Mat::Execution::Parallel));
+			}));
+			results.push_back(measure("vector*vector", type, n * n, 2.0 * n2, 2.0 * n2 * s, options.minTime, counter, [&]()
+			{
+				gSink = gSink + static_cast<double>(w * w2);
+			}));
+		}
+	}
+
+
+	std::string getInstructionSetName()
+	{
+		switch (Mat::Simd::getInstructionSet())
+		{
+		case Mat::Simd::InstructionSet::SSE2:
+			return "SSE2";
+		case Mat::Simd::InstructionSet::AVX2:
+			return "AVX2";
+		case Mat::Simd::InstructionSet::AVX512:
+			return "AVX512";
+		default:
+			return "Scalar";
+		}
+	}
+
+
+	std::string getCompilerName()
+	{
+#if defined(__clang__)
+		return "clang " __clang_version__;
+#elif defined(__GNUC__)
+		return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+		return "msvc " + std::to_string(_MSC_FULL_VER);
+#else
+		return "unknown";
+#endif
+	}
+
+
+	template <typename T> std::vector<T> parseList(std::string const & text)
+	{
+		std::vector<T> list;
+		std::stringstream stream(text);
+		std::string item;
+		while (std::getline(stream, item, ','))
+		{
+			std::stringstream itemStream(item);
+			T value;
+			if (itemStream >> value)
+			{
+				list.push_back(value);
+			}
+		}
+		return list;
+	}
+
+
+	void writeJson(std::string const & path, std::vector<Result> const & results)
+	{
+		std::ofstream file(path);
+		if (!file)
+		{
+			std::cerr << "Cannot write " << path << '\n';
+			return;
+		}
+		file.precision(9);
+		file << "{\n";
+		file << "  \"threads\": " << Mat::getThreadCount() << ",\n";
+		file << "  \"instructionSet\": \"" << getInstructionSetName() << "\",\n";
+		file << "  \"compiler\": \"" << getCompilerName() << "\",\n";
+		file << "  \"results\": [\n";
+		for (std::size_t i = 0; i < results.size(); ++i)
+		{
+			Result const & r = results[i];
+			file << "    {\"operation\": \"" << r.operation << "\", \"type\": \"" << r.type << "\", \"size\": " << r.size
+				<< ", \"seconds\": " << r.seconds << ", \"gflops\": " << r.flops / r.seconds * 1e-9 << ", \"gbps\": " << r.bytes / r.seconds * 1e-9
+				<< ", \"allocations\": " << r.allocations << ", \"repetitions\": " << r.repetitions << "}" << ((i + 1 < results.size()) ? "," : "") << '\n';
+		}
+		file << "  ]\n";
+		file << "}\n";
+	}
+
+} //Anonymous namespace
+
+
+
+int main(int argc, char** argv)
+{
+	Options options;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string const arg = argv[i];
+		bool const hasValue = (i + 1 < argc);
+		if (arg == "--quick")
+		{
+			options.sizes = { 32, 128 };
+			options.minTime = 0.05;
+		}
+		else if ((arg == "--sizes") && hasValue)
+		{
+			options.sizes = parseList<unsigned int>(argv[++i]);
+		}
+		else if ((arg == "--types") && hasValue)
+		{
+			options.types = parseList<std::string>(argv[++i]);
+		}
+		else if ((arg == "--min-time") && hasValue)
+		{
+			options.minTime = std::atof(argv[++i]);
+		}
+		else if ((arg == "--json") && hasValue)
+		{
+			options.jsonPath = argv[++i];
+		}
+		else
+		{
+			std::cerr << "Usage: " << argv[0] << " [--quick] [--sizes 64,256,1024] [--types float,double,int] [--min-time seconds] [--json file]\n";
+			return (arg == "--help") ? 0 : 1;
+		}
+	}
+
+	std::vector<Result> results;
+	for (std::string const & type : options.types)
+	{
+		if (type == "float")
+		{
+			benchmarkType<float>(type, options, results);
+		}
+		else if (type == "double")
+		{
+			benchmarkType<double>(type, options, results);
+		}
+		else if (type == "int")
+		{
+			benchmarkType<int>(type, options, results);
+		}
+		else
+		{
+			std::cerr << "Unknown type " << type << " (float, double and int are supported)\n";
+			return 1;
+		}
+	}
+
+	std::cout << "threads " << Mat::getThreadCount() << ", instruction set " << getInstructionSetName() << '\n';
+	std::printf("%-18s %-7s %6s %14s %10s %10s %12s\n", "operation", "type", "size", "time [us]", "GFLOP/s", "GB/s", "allocs/op");
+	for (Result const & r : results)
+	{
+		std::printf("%-18s %-7s %6u %14.3f %10.3f %10.3f %12.2f\n", r.operation.c_str(), r.type.c_str(), r.size,
+			r.seconds * 1e6, r.flops / r.seconds * 1e-9, r.bytes / r.seconds * 1e-9, r.allocations);
+	}
+
+	if (!options.jsonPath.empty())
+	{
+		writeJson(options.jsonPath, results);
+	}
+	return 0;
+}
@@ -0,0 +1,34 @@
+#include "Blas1.hpp"
+
+#include <atomic>
+
+
+namespace Mat
+{
+
+	namespace
+	{
+
+		std::atomic<SummationMode> sSummationMode(SummationMode::Fast);
+
+	} //Anonymous namespace
+
+
+
+	///////////////////
+	//Summation mode
+
+	SummationMode getSummationMode()
+	{
+		return sSummationMode.load(std::memory_order_relaxed);
+	}
+
+
+	void setSummationMode(SummationMode mode)
+	{
+		sSummationMode.store(mode, std::memory_order_relaxed);
+	}
+
+
+
+} //Namespace: Mat
@@ -0,0 +1,334 @@
+#ifndef BLAS1_HPP
+#define BLAS1_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+#include "Simd.hpp"
+#include "ThreadPool.hpp"
+
+
+
+namespace Mat
+{
+
+	//How the reductions of Blas1.hpp (dot, nrm2, asum and the inner product of vectors) add up floating point terms
+	//Fast: SIMD lanes accumulate on their own, O(n) rounding error; Pairwise: sums of blocks are added in a balanced tree,
+	//O(log n) error at nearly the same speed; Compensated: Kahan summation in every lane, error independent of n, somewhat slower.
+	//All modes give the same result for every thread count. Integer reductions are exact and always use Fast
+	enum class SummationMode
+	{
+		Fast,
+		Pairwise,
+		Compensated
+	};
+
+
+	//Returns the summation mode the reductions use unless a mode is passed explicitly (default: Fast)
+	SummationMode getSummationMode();
+
+	//Sets the summation mode the reductions use unless a mode is passed explicitly
+	void setSummationMode(SummationMode mode);
+
+
+
+	namespace Kernel
+	{
+
+		//Reductions split their operands into chunks of this many entries, no matter how many threads there are. The partial results
+		//of the chunks are combined in a fixed order, so results do not depend on the thread count
+		const std::size_t ReductionChunk = 1 << 14;
+
+		//Pairwise summation stops halving at blocks of this many entries, which are summed by the SIMD kernels
+		const std::size_t PairwiseBlock = 128;
+
+		//Level 1 operations on at least this many entries are split over the thread pool
+		const std::size_t Blas1ParallelThreshold = 1 << 16;
+
+
+		//Sums the block results reduce(begin, count) over [0, n) in a balanced tree down to blocks of PairwiseBlock entries
+		template <typename T, typename Reduce> T sumPairwise(std::size_t begin, std::size_t n, Reduce const & reduce)
+		{
+			if (n <= PairwiseBlock)
+			{
+				return reduce(begin, n);
+			}
+			//Halves are rounded to whole blocks, so the tree only depends on n
+			std::size_t const half = ((n / 2 + PairwiseBlock - 1) / PairwiseBlock) * PairwiseBlock;
+			return sumPairwise<T>(begin, half, reduce) + sumPairwise<T>(begin + half, n - half, reduce);
+		}
+
+
+		//Sums values[0], ..., values[count - 1] as mode says
+		template <typename T> T combine(T const * values, std::size_t count, SummationMode mode)
+		{
+			switch (mode)
+			{
+			case SummationMode::Pairwise:
+				if (count > 1)
+				{
+					std::size_t const half = count / 2;
+					return combine(values, half, mode) + combine(values + half, count - half, mode);
+				}
+				return (count == 1) ? values[0] : T(0);
+			case SummationMode::Compensated:
+				{
+					T sum = T(0);
+					T compensation = T(0);
+					for (std::size_t i = 0; i < count; ++i)
+					{
+						T const term = values[i] - compensation;
+						T const next = sum + term;
+						compensation = (next - sum) - term;
+						sum = next;
+					}
+					return sum - compensation;
+				}
+			default:
+				break;
+			}
+			T sum = T(0);
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				sum += values[i];
+			}
+			return sum;
+		}
+
+
+		//Returns a buffer of at least count entries, owned by the calling thread and reused by every reduction in it,
+		//so the chunk results of the reductions are not allocated per call (the buffer only grows)
+		template <typename T> T* chunkBuffer(std::size_t count)
+		{
+			static thread_local std::vector<T> buffer;
+			if (buffer.size() < count)
+			{
+				buffer.resize(count);
+			}
+			return buffer.data();
+		}
+
+
+		//Evaluates chunkValue(begin, count) for all chunks of [0, n) (on the thread pool if n is large) and stores the results in chunk order in values
+		template <typename T, typename ChunkValue> void evaluateChunks(std::size_t n, ChunkValue const & chunkValue, T* values)
+		{
+			std::size_t const chunkCount = (n + ReductionChunk - 1) / ReductionChunk;
+			auto chunkRange = [&](std::size_t begin, std::size_t end)
+			{
+				for (std::size_t chunk = begin; chunk < end; ++chunk)
+				{
+					std::size_t const first = chunk * ReductionChunk;
+					values[chunk] = chunkValue(first, std::min(n, first + ReductionChunk) - first);
+				}
+			};
+
+			ThreadPool& pool = ThreadPool::instance();
+			if ((n < Blas1ParallelThreshold) || (pool.getThreadCount() == 1))
+			{
+				chunkRange(0, chunkCount);
+			}
+			else
+			{
+				pool.parallelFor(0, chunkCount, 1, chunkRange);
+			}
+		}
+
+
+		//Reduces [0, n) with the sum of chunkValue over all chunks, combined as mode says
+		template <typename T, typename ChunkValue> T reduceChunks(std::size_t n, SummationMode mode, ChunkValue const & chunkValue)
+		{
+			if (n <= ReductionChunk)
+			{
+				return chunkValue(0, n);
+			}
+			std::size_t const chunkCount = (n + ReductionChunk - 1) / ReductionChunk;
+			T* const values = chunkBuffer<T>(chunkCount);
+			evaluateChunks(n, chunkValue, values);
+			return combine(values, chunkCount, mode);
+		}
+
+
+		//Floating point types sum as mode says, all other types are summed exactly anyway
+		template <typename T> SummationMode effectiveMode(SummationMode mode)
+		{
+			return std::is_floating_point<T>::value ? mode : SummationMode::Fast;
+		}
+
+
+		//Returns the sum of x[i] * y[i] (contiguous, n entries)
+		template <typename T> T dot(std::size_t n, T const * x, T const * y, SummationMode mode)
+		{
+			mode = effectiveMode<T>(mode);
+			return reduceChunks<T>(n, mode, [&](std::size_t begin, std::size_t count) -> T
+			{
+				switch (mode)
+				{
+				case SummationMode::Pairwise:
+					return sumPairwise<T>(begin, count, [&](std::size_t b, std::size_t c) { return Simd::dot(c, x + b, y + b); });
+				case SummationMode::Compensated:
+					return Simd::dotCompensated(count, x + begin, y + begin);
+				default:
+					return Simd::dot(count, x + begin, y + begin);
+				}
+			});
+		}
+
+
+		//Returns the sum of |x[i]|
+		template <typename T> T asum(std::size_t n, T const * x, SummationMode mode)
+		{
+			mode = effectiveMode<T>(mode);
+			return reduceChunks<T>(n, mode, [&](std::size_t begin, std::size_t count) -> T
+			{
+				switch (mode)
+				{
+				case SummationMode::Pairwise:
+					return sumPairwise<T>(begin, count, [&](std::size_t b, std::size_t c) { return Simd::sumAbs(c, x + b); });
+				case SummationMode::Compensated:
+					return Simd::sumAbsCompensated(count, x + begin);
+				default:
+					return Simd::sumAbs(count, x + begin);
+				}
+			});
+		}
+
+
+		//Returns the sum of (scale * x[i])^2; the scaled entries go through a small buffer, so x is not changed
+		template <typename T> T sumScaledSquares(std::size_t n, T const * x, T const & scale, SummationMode mode)
+		{
+			auto block = [&](std::size_t begin, std::size_t count) -> T
+			{
+				T buffer[PairwiseBlock];
+				Simd::scale(count, x + begin, scale, buffer);
+				return (mode == SummationMode::Compensated) ? Simd::dotCompensated(count, buffer, buffer) : Simd::dot(count, buffer, buffer);
+			};
+			return reduceChunks<T>(n, mode, [&](std::size_t begin, std::size_t count) -> T
+			{
+				if (mode == SummationMode::Pairwise)
+				{
+					return sumPairwise<T>(begin, count, block);
+				}
+				T blockSums[ReductionChunk / PairwiseBlock];
+				std::size_t blockCount = 0;
+				for (std::size_t b = 0; b < count; b += PairwiseBlock)
+				{
+					blockSums[blockCount++] = block(begin + b, std::min(PairwiseBlock, count - b));
+				}
+				return combine(blockSums, blockCount, mode);
+			});
+		}
+
+
+		//Returns the Euclidean norm of x without overflow or underflow in the intermediate sum of squares
+		//The plain sum of squares is used whenever it is finite and far enough above the underflow threshold; otherwise the entries
+		//are scaled by a power of two (exact) that brings the squares into range, which costs a second pass
+		template <typename T> T nrm2(std::size_t n, T const * x, SummationMode mode)
+		{
+			static_assert(std::is_floating_point<T>::value, "nrm2: only defined for floating point types!");
+			T const sum = dot(n, x, x, mode);
+			T const tiny = std::numeric_limits<T>::min() / std::numeric_limits<T>::epsilon();
+			if (std::isnan(sum) || (std::isfinite(sum) && (sum >= tiny)))
+			{
+				return std::sqrt(sum);
+			}
+
+			T const largest = Simd::maxAbs(n, x);
+			if ((largest == T(0)) || std::isinf(largest))
+			{
+				return largest;
+			}
+			//2^exponent keeps the squares of all relevant entries finite and normal (derived from the exponent range of T)
+			int const exponent = std::numeric_limits<T>::max_exponent / 2 + std::numeric_limits<T>::digits;
+			int const shift = std::isinf(sum) ? -exponent : exponent;
+			return std::ldexp(std::sqrt(sumScaledSquares(n, x, std::ldexp(T(1), shift), mode)), -shift);
+		}
+
+
+		//Computes y += alpha * x (x may be y itself, but must not overlap it otherwise)
+		template <typename T> void axpy(std::size_t n, T const & alpha, T const * x, T* y)
+		{
+			ThreadPool& pool = ThreadPool::instance();
+			if ((n < Blas1ParallelThreshold) || (pool.getThreadCount() == 1))
+			{
+				Simd::axpy(n, alpha, x, y);
+				return;
+			}
+			pool.parallelFor(0, n, ReductionChunk, [&](std::size_t begin, std::size_t end)
+			{
+				Simd::axpy(end - begin, alpha, x + begin, y + begin);
+			});
+		}
+
+
+		//Computes x *= alpha
+		template <typename T> void scal(std::size_t n, T const & alpha, T* x)
+		{
+			ThreadPool& pool = ThreadPool::instance();
+			if ((n < Blas1ParallelThreshold) || (pool.getThreadCount() == 1))
+			{
+				Simd::scale(n, x, alpha, x);
+				return;
+			}
+			pool.parallelFor(0, n, ReductionChunk, [&](std::size_t begin, std::size_t end)
+			{
+				Simd::scale(end - begin, x + begin, alpha, x + begin);
+			});
+		}
+
+
+		//Returns the first index of the entry with the largest (largest is true) or smallest absolute value
+		//NaN entries are skipped; if there are only NaN entries (or none), 0 is returned
+		template <typename T> std::size_t findExtremeAbs(std::size_t n, T const * x, bool largest)
+		{
+			typedef typename Simd::Magnitude<T>::Type M; //Magnitudes of integers are unsigned, so INT_MIN compares without overflow
+			auto extreme = [&](std::size_t begin, std::size_t count) -> M
+			{
+				return largest ? Simd::maxAbs(count, x + begin) : Simd::minAbs(count, x + begin);
+			};
+			std::size_t const chunkCount = (n + ReductionChunk - 1) / ReductionChunk;
+			if (chunkCount == 0)
+			{
+				return 0;
+			}
+			M* const values = chunkBuffer<M>(chunkCount);
+			evaluateChunks(n, extreme, values);
+			std::size_t bestChunk = 0;
+			for (std::size_t chunk = 1; chunk < chunkCount; ++chunk)
+			{
+				if (largest ? (values[chunk] > values[bestChunk]) : (values[chunk] < values[bestChunk]))
+				{
+					bestChunk = chunk;
+				}
+			}
+			//Only chunks of NaN entries report the initial value (0 or infinity) without containing it, so keep looking in later chunks
+			M const best = values[bestChunk];
+			for (std::size_t chunk = bestChunk; chunk < chunkCount; ++chunk)
+			{
+				if (values[chunk] != best)
+				{
+					continue;
+				}
+				std::size_t const end = std::min(n, (chunk + 1) * ReductionChunk);
+				for (std::size_t i = chunk * ReductionChunk; i < end; ++i)
+				{
+					if (Simd::Magnitude<T>::of(x[i]) == best)
+					{
+						return i;
+					}
+				}
+			}
+			return 0;
+		}
+
+
+
+	} //Namespace: Kernel
+
+} //Namespace: Mat
+
+#endif //BLAS1_HPP
@@ -0,0 +1,100 @@
+#ifndef EXPRESSION_HPP
+#define EXPRESSION_HPP
+
+#include <functional>
+
+
+
+//The unchecked accessors (operator() and operator[] of matrices, vectors and views) check their indices
+//only in debug builds, i.e. unless NDEBUG is defined, and then throw the same exceptions as at()
+#if !defined(NDEBUG) && !defined(MATRIX_DEBUG_CHECKS)
+#define MATRIX_DEBUG_CHECKS
+#endif
+
+
+
+namespace Mat
+{
+
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Struct Template ExpressionOperand, which tells how an expression node stores its operand
+	//Intermediate nodes are tiny and usually temporaries, so they are stored by value; Matrix and Vector specialise
+	//this to be stored by reference, so that building an expression never copies data
+	template <typename E> struct ExpressionOperand
+	{
+		typedef E const Type;
+	};
+
+
+
+	//Returns whether the non-empty memory ranges [begin1, end1) and [begin2, end2) overlap
+	//(std::less gives a total order even for pointers into different buffers)
+	template <typename T> bool rangesOverlap(T const * begin1, T const * end1, T const * begin2, T const * end2)
+	{
+		if ((begin1 == end1) || (begin2 == end2))
+		{
+			return false;
+		}
+		std::less<T const *> less;
+		return less(begin1, end2) && less(begin2, end1);
+	}
+
+
+
+	//////////////////////////////////////////////////////////////////
+	//Entrywise operations the expression nodes are parameterised with
+	namespace Operation
+	{
+
+		struct Add
+		{
+			template <typename T> static T apply(T const & a, T const & b)
+			{
+				return a + b;
+			}
+		};
+
+
+		struct Subtract
+		{
+			template <typename T> static T apply(T const & a, T const & b)
+			{
+				return a - b;
+			}
+		};
+
+
+		struct Scale
+		{
+			template <typename T> static T apply(T const & a, T const & s)
+			{
+				return a * s;
+			}
+		};
+
+
+		struct Divide
+		{
+			template <typename T> static T apply(T const & a, T const & s)
+			{
+				return a / s;
+			}
+		};
+
+
+		struct Negate
+		{
+			template <typename T> static T apply(T const & a)
+			{
+				return -a;
+			}
+		};
+
+	} //Namespace: Operation
+
+
+
+} //Namespace: Mat
+
+#endif //EXPRESSION_HPP
+
@@ -0,0 +1,224 @@
+#ifndef FIND_HPP
+#define FIND_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitset>
+#include <atomic>
+#include <algorithm>
+
+#include "Simd.hpp"
+#include "ThreadPool.hpp"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+
+
+namespace Mat
+{
+	namespace Kernel
+	{
+
+		//All scans compare |a[i] - value| <= tolerance for the n contiguous entries a[0], ..., a[n - 1]. They work on blocks of
+		//FindBlock entries, whose match bits (one per entry) fit into a small array on the stack, so only the results allocate
+		const std::size_t FindBlock = 4096;
+
+		//Scans of at least this many entries are split over the thread pool, in chunks of FindChunk entries (a multiple of FindBlock)
+		const std::size_t FindParallelThreshold = 1 << 18;
+		const std::size_t FindChunk = 1 << 16;
+
+
+		//Returns the index of the lowest set bit of word (which must not be 0)
+		inline unsigned int lowestBit(std::uint64_t word)
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			return static_cast<unsigned int>(__builtin_ctzll(word));
+#elif defined(_MSC_VER) && defined(_M_X64)
+			unsigned long index;
+			_BitScanForward64(&index, word);
+			return static_cast<unsigned int>(index);
+#else
+			unsigned int index = 0;
+			while ((word & 1u) == 0)
+			{
+				word >>= 1;
+				++index;
+			}
+			return index;
+#endif
+		}
+
+
+		//Calls visit(i) for every match i in [begin, end) in increasing order (begin has to be a multiple of 64)
+		template <typename T, typename Visit> void forEachMatch(std::size_t begin, std::size_t end, T const * a, T const & value, T const & tolerance, Visit const & visit)
+		{
+			std::uint64_t bits[FindBlock / 64];
+			for (std::size_t block = begin; block < end; block += FindBlock)
+			{
+				std::size_t const count = std::min(FindBlock, end - block);
+				Simd::matchMask(count, a + block, value, tolerance, bits);
+				for (std::size_t w = 0; w < (count + 63) / 64; ++w)
+				{
+					for (std::uint64_t word = bits[w]; word != 0; word &= word - 1)
+					{
+						visit(block + w * 64 + lowestBit(word));
+					}
+				}
+			}
+		}
+
+
+		//Returns the number of matches in [begin, end) (begin has to be a multiple of 64)
+		template <typename T> std::size_t countMatchesIn(std::size_t begin, std::size_t end, T const * a, T const & value, T const & tolerance)
+		{
+			std::uint64_t bits[FindBlock / 64];
+			std::size_t count = 0;
+			for (std::size_t block = begin; block < end; block += FindBlock)
+			{
+				std::size_t const blockSize = std::min(FindBlock, end - block);
+				Simd::matchMask(blockSize, a + block, value, tolerance, bits);
+				for (std::size_t w = 0; w < (blockSize + 63) / 64; ++w)
+				{
+					count += std::bitset<64>(bits[w]).count();
+				}
+			}
+			return count;
+		}
+
+
+		//Returns the first match in [begin, end), or end if there is none (begin has to be a multiple of 64)
+		template <typename T> std::size_t findFirstIn(std::size_t begin, std::size_t end, T const * a, T const & value, T const & tolerance)
+		{
+			std::uint64_t bits[FindBlock / 64];
+			for (std::size_t block = begin; block < end; block += FindBlock)
+			{
+				std::size_t const count = std::min(FindBlock, end - block);
+				Simd::matchMask(count, a + block, value, tolerance, bits);
+				for (std::size_t w = 0; w < (count + 63) / 64; ++w)
+				{
+					if (bits[w] != 0)
+					{
+						return block + w * 64 + lowestBit(bits[w]);
+					}
+				}
+			}
+			return end;
+		}
+
+
+		//Returns whether a scan of n entries is split over the thread pool
+		inline bool findInParallel(std::size_t n)
+		{
+			return (n >= FindParallelThreshold) && (ThreadPool::instance().getThreadCount() > 1);
+		}
+
+
+		//Returns the number of matches
+		template <typename T> std::size_t countMatches(std::size_t n, T const * a, T const & value, T const & tolerance)
+		{
+			if (!findInParallel(n))
+			{
+				return countMatchesIn(0, n, a, value, tolerance);
+			}
+			std::atomic<std::size_t> total(0);
+			ThreadPool::instance().parallelFor(0, n, FindChunk, [&](std::size_t begin, std::size_t end)
+			{
+				total.fetch_add(countMatchesIn(begin, end, a, value, tolerance), std::memory_order_relaxed);
+			});
+			return total.load();
+		}
+
+
+		//Returns the first match, or n if there is none
+		//The pool hands out chunks in increasing order and chunks behind the best match so far are skipped, so the parallel
+		//search stops soon after the first match, and always returns the same index as the serial one
+		template <typename T> std::size_t findFirst(std::size_t n, T const * a, T const & value, T const & tolerance)
+		{
+			if (!findInParallel(n))
+			{
+				return findFirstIn(0, n, a, value, tolerance);
+			}
+			std::atomic<std::size_t> first(n);
+			ThreadPool::instance().parallelFor(0, n, FindChunk, [&](std::size_t begin, std::size_t end)
+			{
+				if (begin >= first.load(std::memory_order_relaxed))
+				{
+					return;
+				}
+				std::size_t found = findFirstIn(begin, end, a, value, tolerance);
+				if (found == end)
+				{
+					return;
+				}
+				std::size_t current = first.load(std::memory_order_relaxed);
+				while ((found < current) && !first.compare_exchange_weak(current, found, std::memory_order_relaxed))
+				{
+				}
+			});
+			return first.load();
+		}
+
+
+		//Writes the match bits of all n entries to bits ((n + 63) / 64 words, see Simd::matchMask)
+		template <typename T> void findMask(std::size_t n, T const * a, T const & value, T const & tolerance, std::uint64_t* bits)
+		{
+			if (!findInParallel(n))
+			{
+				Simd::matchMask(n, a, value, tolerance, bits);
+				return;
+			}
+			ThreadPool::instance().parallelFor(0, n, FindChunk, [&](std::size_t begin, std::size_t end)
+			{
+				Simd::matchMask(end - begin, a + begin, value, tolerance, bits + begin / 64);
+			});
+		}
+
+
+		//Returns index(i) for every match i in increasing order
+		//In parallel, the matches per chunk are counted first, so that every chunk can write its part of the exactly sized result
+		template <typename Index, typename T, typename MakeIndex> std::vector<Index> findAll(std::size_t n, T const * a, T const & value, T const & tolerance, MakeIndex const & index)
+		{
+			std::vector<Index> result;
+			if (!findInParallel(n))
+			{
+				forEachMatch(0, n, a, value, tolerance, [&](std::size_t i)
+				{
+					result.push_back(index(i));
+				});
+				return result;
+			}
+
+			ThreadPool& pool = ThreadPool::instance();
+			std::size_t const chunkCount = (n + FindChunk - 1) / FindChunk;
+			std::vector<std::size_t> offsets(chunkCount + 1, 0);
+			pool.run(chunkCount, [&](std::size_t chunk)
+			{
+				offsets[chunk + 1] = countMatchesIn(chunk * FindChunk, std::min(n, (chunk + 1) * FindChunk), a, value, tolerance);
+			});
+			for (std::size_t chunk = 0; chunk < chunkCount; ++chunk)
+			{
+				offsets[chunk + 1] += offsets[chunk];
+			}
+
+			result.resize(offsets[chunkCount]);
+			pool.run(chunkCount, [&](std::size_t chunk)
+			{
+				Index* out = result.data() + offsets[chunk];
+				forEachMatch(chunk * FindChunk, std::min(n, (chunk + 1) * FindChunk), a, value, tolerance, [&](std::size_t i)
+				{
+					*out++ = index(i);
+				});
+			});
+			return result;
+		}
+
+
+
+	} //Namespace: Kernel
+
+} //Namespace: Mat
+
+#endif //FIND_HPP
@@ -0,0 +1,569 @@
+#ifndef FIXED_MATRIX_HPP
+#define FIXED_MATRIX_HPP
+
+#include <iostream>
+#include <vector>
+#include <list>
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+
+#include "Matrix.hpp"
+#include "FixedVector.hpp"
+#include "LU.hpp"
+
+
+
+namespace Mat
+{
+	namespace Kernel
+	{
+
+		//Copies the n x n row-major array a without row and col into the (n - 1) x (n - 1) array minor
+		template <typename T, unsigned int N> void getFixedMinor(T const * a, unsigned int row, unsigned int col, T* minor)
+		{
+			unroll<N - 1>([&](unsigned int y)
+			{
+				unsigned int const srcY = (y < row) ? y : y + 1;
+				unroll<N - 1>([&](unsigned int x)
+				{
+					unsigned int const srcX = (x < col) ? x : x + 1;
+					minor[y * (N - 1) + x] = a[srcY * N + srcX];
+				});
+			});
+		}
+
+
+		//////////////////////////////////////////////////////////////////////////////////////////////////////////
+		//Struct Template FixedDeterminant, which calculates the determinant of the n x n row-major array a
+		//Up to 4 x 4 the expansion is unrolled completely (exact for integers); larger matrices go through LU<double>
+		template <typename T, unsigned int N, bool Small = (N <= 4)> struct FixedDeterminant
+		{
+			static T compute(T const * a)
+			{
+				Matrix<double> matrix(XY(N, N));
+				std::copy(a, a + N * N, matrix.data());
+				double const det = matrix.det();
+				return static_cast<T>(std::is_integral<T>::value ? std::round(det) : det);
+			}
+		};
+
+		template <typename T> struct FixedDeterminant<T, 1, true>
+		{
+			static T compute(T const * a)
+			{
+				return a[0];
+			}
+		};
+
+		template <typename T> struct FixedDeterminant<T, 2, true>
+		{
+			static T compute(T const * a)
+			{
+				return a[0] * a[3] - a[1] * a[2];
+			}
+		};
+
+		//Laplace expansion along the first row
+		template <typename T, unsigned int N> struct FixedDeterminant<T, N, true>
+		{
+			static T compute(T const * a)
+			{
+				T det = T(0);
+				unroll<N>([&](unsigned int col)
+				{
+					T minor[(N - 1) * (N - 1)];
+					getFixedMinor<T, N>(a, 0, col, minor);
+					T const term = a[col] * FixedDeterminant<T, N - 1>::compute(minor);
+					det = (col % 2 == 0) ? det + term : det - term;
+				});
+				return det;
+			}
+		};
+
+
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		//Struct Template FixedInverse, which writes the inverse of the n x n row-major array a into inv
+		//Returns false if a is singular. Up to 4 x 4 the adjugate is unrolled completely; larger matrices go through LU<T>
+		template <typename T, unsigned int N, bool Small = (N <= 4)> struct FixedInverse
+		{
+			static bool compute(T const * a, T* inv)
+			{
+				Matrix<T> matrix(XY(N, N));
+				std::copy(a, a + N * N, matrix.data());
+				LU<T> const lu(std::move(matrix));
+				if (lu.isSingular())
+				{
+					return false;
+				}
+				Matrix<T> const inverse = lu.inverse();
+				std::copy(inverse.data(), inverse.data() + N * N, inv);
+				return true;
+			}
+		};
+
+		template <typename T> struct FixedInverse<T, 1, true>
+		{
+			static bool compute(T const * a, T* inv)
+			{
+				if (a[0] == T(0))
+				{
+					return false;
+				}
+				inv[0] = T(1) / a[0];
+				return true;
+			}
+		};
+
+		//inv(x, y) = (-1)^(x + y) * det(a without row x and column y) / det(a)
+		template <typename T, unsigned int N> struct FixedInverse<T, N, true>
+		{
+			static bool compute(T const * a, T* inv)
+			{
+				T const det = FixedDeterminant<T, N>::compute(a);
+				if (det == T(0))
+				{
+					return false;
+				}
+				unroll<N>([&](unsigned int y)
+				{
+					unroll<N>([&](unsigned int x)
+					{
+						T minor[(N - 1) * (N - 1)];
+						getFixedMinor<T, N>(a, x, y, minor);
+						T const cofactor = FixedDeterminant<T, N - 1>::compute(minor);
+						inv[y * N + x] = (((x + y) % 2 == 0) ? cofactor : -cofactor) / det;
+					});
+				});
+				return true;
+			}
+		};
+
+
+	} //Namespace: Kernel
+
+
+
+	//Return type R of operators that only exist for fixed-size matrices
+	template <unsigned int M, unsigned int N, typename R> using FixedMatrixResult = typename std::enable_if<(M != Dynamic) && (N != Dynamic), R>::type;
+
+
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template Matrix<T, M, N>, which stores M rows and N columns inline (no heap allocation, no size checks)
+	//Sizes are compile time constants, so incompatible shapes are rejected by the compiler. Loops over the
+	//entries are unrolled. getView() lets fixed-size matrices take part in the expressions of Matrix<T>
+	template <typename T, unsigned int M, unsigned int N> class Matrix
+	{
+		static_assert((M != Dynamic) && (N != Dynamic) && (M > 0) && (N > 0), "Matrix<T, M, N>: M and N have to be positive compile time constants (fixed and dynamic extents cannot be mixed)!");
+
+	public:
+		typedef T ValueType;
+		static const unsigned int Rows = M;
+		static const unsigned int Columns = N;
+
+	private:
+		T mData[M * N]; //Row-major, entry (x, y) lives at mData[y * N + x]
+
+	public:
+		//Standard constructor constructs a matrix filled with T()
+		Matrix()
+			: mData()
+		{}
+
+
+		//Constructor that constructs a matrix filled with value
+		explicit Matrix(T const & value)
+		{
+			this->fillWith(value);
+		}
+
+
+		//Constructor that constructs matrix from vec of rows (which has to have M rows of N entries)
+		explicit Matrix(std::vector<std::vector<T>> const & vecOfRows)
+		{
+			bool correctSize = (vecOfRows.size() == M);
+			for (auto const & row : vecOfRows)
+			{
+				correctSize = correctSize && (row.size() == N);
+			}
+			if (!correctSize)
+			{
+				throw InvalidVecOfRowsException("Matrix<T, M, N>::Matrix(std::vector<std::vector<T>> const & vecOfRows): vecOfRows does not have M rows of N entries! Construction failed!");
+			}
+			for (unsigned int y = 0; y < M; ++y)
+			{
+				std::copy(vecOfRows[y].begin(), vecOfRows[y].end(), mData + y * N);
+			}
+		}
+
+
+		//Constructor that copies a dynamically sized matrix (which has to have M rows and N columns)
+		explicit Matrix(Matrix<T> const & matrix)
+		{
+			if (matrix.getSize() != this->getSize())
+			{
+				throw IncompatibleMatrixSizesException("Matrix<T, M, N>::Matrix(Matrix<T> const & matrix): matrix does not have M rows and N columns!", this->getSize(), matrix.getSize());
+			}
+			for (unsigned int y = 0; y < M; ++y)
+			{
+				std::copy(matrix.rowPtr(y), matrix.rowPtr(y) + N, mData + y * N);
+			}
+		}
+
+
+		//Destructor and all other constructors stay default!
+
+
+	public:
+		//Returns the size of the matrix
+		static MatrixSize getSize()
+		{
+			return MN(M, N);
+		}
+
+
+		//Returns the distance between two rows in elements
+		static unsigned int getStride()
+		{
+			return N;
+		}
+
+
+		//Gives direct access to the row-major entries
+		T* data()
+		{
+			return mData;
+		}
+
+
+		//Gives direct constant access to the row-major entries
+		T const * data() const
+		{
+			return mData;
+		}
+
+
+		//Gives access to the components
+		T& at(MatrixEntry const & pos)
+		{
+			if ((pos.x() >= N) || (pos.y() >= M))
+			{
+				throw InvalidIndicesException("Matrix<T, M, N>::at(MatrixEntry const & pos): pos is out of range!", pos);
+			}
+			return mData[pos.y() * N + pos.x()];
+		}
+
+
+		//Gives constant access to the components
+		T const & at(MatrixEntry const & pos) const
+		{
+			if ((pos.x() >= N) || (pos.y() >= M))
+			{
+				throw InvalidIndicesException("Matrix<T, M, N>::at(MatrixEntry const & pos) const: pos is out of range!", pos);
+			}
+			return mData[pos.y() * N + pos.x()];
+		}
+
+
+		//Gives access to the entry in row row and column column (MN-mode), bounds are only checked in debug builds
+		T& operator()(unsigned int row, unsigned int column)
+		{
+#ifdef MATRIX_DEBUG_CHECKS
+			if ((column >= N) || (row >= M))
+			{
+				throw InvalidIndicesException("Matrix<T, M, N>::operator()(unsigned int row, unsigned int column): entry is out of range!", MN(row, column));
+			}
+#endif
+			return mData[row * N + column];
+		}
+
+
+		//Gives constant access to the entry in row row and column column (MN-mode), bounds are only checked in debug builds
+		T const & operator()(unsigned int row, unsigned int column) const
+		{
+#ifdef MATRIX_DEBUG_CHECKS
+			if ((column >= N) || (row >= M))
+			{
+				throw InvalidIndicesException("Matrix<T, M, N>::operator()(unsigned int row, unsigned int column) const: entry is out of range!", MN(row, column));
+			}
+#endif
+			return mData[row * N + column];
+		}
+
+
+		//Iterators over all entries in row-major order
+		T* begin()
+		{
+			return mData;
+		}
+
+		T* end()
+		{
+			return mData + M * N;
+		}
+
+		T const * begin() const
+		{
+			return mData;
+		}
+
+		T const * end() const
+		{
+			return mData + M * N;
+		}
+
+
+		//Returns the entry at (x, y) without bounds check
+		T const & evaluateAt(unsigned int x, unsigned int y) const
+		{
+			return mData[y * N + x];
+		}
+
+
+		//Returns a view, so that the matrix can be used in expressions with dynamically sized matrices
+		MatrixView<T> getView()
+		{
+			return MatrixView<T>(mData, this->getSize(), N);
+		}
+
+
+		//Returns a constant view
+		MatrixView<T const> getView() const
+		{
+			return MatrixView<T const>(mData, this->getSize(), N);
+		}
+
+
+		//Calculates trace
+		T trace() const
+		{
+			static_assert(M == N, "Matrix<T, M, N>::trace(): matrix is not square!");
+			T sum = T(0);
+			Kernel::unroll<N>([&](unsigned int i) { sum += mData[i * N + i]; });
+			return sum;
+		}
+
+
+		//Calculates determinant (exact for integer matrices up to 4 x 4)
+		T det() const
+		{
+			static_assert(M == N, "Matrix<T, M, N>::det(): matrix is not square!");
+			return Kernel::FixedDeterminant<T, N>::compute(mData);
+		}
+
+
+		//Returns the inverse matrix
+		Matrix<T, M, N> getInverse() const
+		{
+			static_assert(M == N, "Matrix<T, M, N>::getInverse(): matrix is not square!");
+			Matrix<T, M, N> inverse;
+			if (!Kernel::FixedInverse<T, N>::compute(mData, inverse.mData))
+			{
+				throw SingularMatrixException("Matrix<T, M, N>::getInverse() const: matrix is singular!");
+			}
+			return inverse;
+		}
+
+
+		//Returns transposed matrix without changing this
+		Matrix<T, N, M> getTransposed() const
+		{
+			Matrix<T, N, M> transposed;
+			Kernel::unroll<M>([&](unsigned int y)
+			{
+				Kernel::unroll<N>([&](unsigned int x) { transposed.data()[x * M + y] = mData[y * N + x]; });
+			});
+			return transposed;
+		}
+
+
+		//Transposes this matrix
+		void transpose()
+		{
+			static_assert(M == N, "Matrix<T, M, N>::transpose(): only square matrices can be transposed in place!");
+			for (unsigned int y = 0; y < N; ++y)
+			{
+				for (unsigned int x = y + 1; x < N; ++x)
+				{
+					std::swap(mData[y * N + x], mData[x * N + y]);
+				}
+			}
+		}
+
+
+		//Finds all EntryPositions which have dist tolerance or less from val
+		std::list<MatrixEntry> find(T const & val, T const & tolerance = T(0)) const
+		{
+			std::list<MatrixEntry> list;
+			for (unsigned int x = 0; x < N; ++x)
+			{
+				for (unsigned int y = 0; y < M; ++y)
+				{
+					if (std::abs(mData[y * N + x] - val) <= tolerance)
+					{
+						list.push_back(XY(x, y));
+					}
+				}
+			}
+			return list;
+		}
+
+
+		//Fills every entry of the matrix with value
+		void fillWith(T const & value)
+		{
+			Kernel::unroll<M * N>([&](unsigned int i) { mData[i] = value; });
+		}
+
+
+	}; //Class Template: Matrix<T, M, N>
+
+
+
+	template <typename T, unsigned int M, unsigned int N> FixedMatrixResult<M, N, std::ostream&> operator<<(std::ostream& oStream, Matrix<T, M, N> const & mat)
+	{
+		for (unsigned int y = 0; y < M; ++y)
+		{
+			for (unsigned int x = 0; x < N; ++x)
+			{
+				if (x != 0)
+				{
+					oStream << " ";
+				}
+				oStream << mat.evaluateAt(x, y);
+			}
+			oStream << '\n';
+		}
+		return oStream;
+	}
+
+
+	//Performs entrywise addition
+	template <typename T, unsigned int M, unsigned int N> FixedMatrixResult<M, N, Matrix<T, M, N>> operator+(Matrix<T, M, N> const & m1, Matrix<T, M, N> const & m2)
+	{
+		Matrix<T, M, N> res;
+		Kernel::unroll<M * N>([&](unsigned int i) { res.data()[i] = m1.data()[i] + m2.data()[i]; });
+		return res;
+	}
+
+
+	//Performs entrywise substraction
+	template <typename T, unsigned int M, unsigned int N> FixedMatrixResult<M, N, Matrix<T, M, N>> operator-(Matrix<T, M, N> const & m1, Matrix<T, M, N> const & m2)
+	{
+		Matrix<T, M, N> res;
+		Kernel::unroll<M * N>([&](unsigned int i) { res.data()[i] = m1.data()[i] - m2.data()[i]; });
+		return res;
+	}
+
+
+	//Performs matrix multiplication (the inner extents have to agree at compile time)
+	template <typename T, unsigned int M, unsigned int K, unsigned int N> FixedMatrixResult<M, N, Matrix<T, M, N>> operator*(Matrix<T, M, K> const & m1, Matrix<T, K, N> const & m2)
+	{
+		Matrix<T, M, N> res;
+		T const * a = m1.data();
+		T const * b = m2.data();
+		T* c = res.data();
+		Kernel::unroll<M>([&](unsigned int i)
+		{
+			Kernel::unroll<K>([&](unsigned int p)
+			{
+				T const aip = a[i * K + p];
+				Kernel::unroll<N>([&](unsigned int j) { c[i * N + j] += aip * b[p * N + j]; });
+			});
+		});
+		return res;
+	}
+
+
+	//Matrix vector product
+	template <typename T, unsigned int M, unsigned int N> FixedMatrixResult<M, N, Vector<T, M>> operator*(Matrix<T, M, N> const & mat, Vector<T, N> const & vec)
+	{
+		Vector<T, M> res;
+		Kernel::unroll<M>([&](unsigned int i)
+		{
+			T sum = T(0);
+			Kernel::unroll<N>([&](unsigned int j) { sum += mat.data()[i * N + j] * vec.data()[j]; });
+			res.data()[i] = sum;
+		});
+		return res;
+	}
+
+
+	//Performs multiplication with scalar from right
+	template <typename T, unsigned int M, unsigned int N> FixedMatrixResult<M, N, Matrix<T, M, N>> operator*(Matrix<T, M, N> const & m, typename Matrix<T, M, N>::ValueType const & s)
+	{
+		Matrix<T, M, N> res;
+		Kernel::unroll<M * N>([&](unsigned int i) { res.data()[i] = m.data()[i] * s; });
+		return res;
+	}
+
+
+	//Performs multiplication with scalar from left
+	template <typename T, unsigned int M, unsigned int N> FixedMatrixResult<M, N, Matrix<T, M, N>> operator*(typename Matrix<T, M, N>::ValueType const & s, Matrix<T, M, N> const & m)
+	{
+		return m * s;
+	}
+
+
+	//Performs division with scalar
+	template <typename T, unsigned int M, unsigned int N> FixedMatrixResult<M, N, Matrix<T, M, N>> operator/(Matrix<T, M, N> const & m, typename Matrix<T, M, N>::ValueType const & s)
+	{
+		Matrix<T, M, N> res;
+		Kernel::unroll<M * N>([&](unsigned int i) { res.data()[i] = m.data()[i] / s; });
+		return res;
+	}
+
+
+	//Returns matrix
+	template <typename T, unsigned int M, unsigned int N> FixedMatrixResult<M, N, Matrix<T, M, N>> operator+(Matrix<T, M, N> const & m)
+	{
+		return m;
+	}
+
+
+	//Returns negative matrix
+	template <typename T, unsigned int M, unsigned int N> FixedMatrixResult<M, N, Matrix<T, M, N>> operator-(Matrix<T, M, N> const & m)
+	{
+		Matrix<T, M, N> res;
+		Kernel::unroll<M * N>([&](unsigned int i) { res.data()[i] = -m.data()[i]; });
+		return res;
+	}
+
+
+	//Adds m2 to m1
+	template <typename T, unsigned int M, unsigned int N> FixedMatrixResult<M, N, Matrix<T, M, N>&> operator+=(Matrix<T, M, N> & m1, Matrix<T, M, N> const & m2)
+	{
+		Kernel::unroll<M * N>([&](unsigned int i) { m1.data()[i] += m2.data()[i]; });
+		return m1;
+	}
+
+
+	//Subtracts m2 from m1
+	template <typename T, unsigned int M, unsigned int N> FixedMatrixResult<M, N, Matrix<T, M, N>&> operator-=(Matrix<T, M, N> & m1, Matrix<T, M, N> const & m2)
+	{
+		Kernel::unroll<M * N>([&](unsigned int i) { m1.data()[i] -= m2.data()[i]; });
+		return m1;
+	}
+
+
+	//Multiplies m by s
+	template <typename T, unsigned int M, unsigned int N> FixedMatrixResult<M, N, Matrix<T, M, N>&> operator*=(Matrix<T, M, N> & m, typename Matrix<T, M, N>::ValueType const & s)
+	{
+		Kernel::unroll<M * N>([&](unsigned int i) { m.data()[i] *= s; });
+		return m;
+	}
+
+
+	//Divide m by s
+	template <typename T, unsigned int M, unsigned int N> FixedMatrixResult<M, N, Matrix<T, M, N>&> operator/=(Matrix<T, M, N> & m, typename Matrix<T, M, N>::ValueType const & s)
+	{
+		Kernel::unroll<M * N>([&](unsigned int i) { m.data()[i] /= s; });
+		return m;
+	}
+
+
+
+} //Namespace: Mat
+
+#endif //FIXED_MATRIX_HPP
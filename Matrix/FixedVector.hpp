@@ -0,0 +1,363 @@
+#ifndef FIXED_VECTOR_HPP
+#define FIXED_VECTOR_HPP
+
+#include <iostream>
+#include <vector>
+#include <list>
+#include <cmath>
+#include <type_traits>
+
+#include "Vector.hpp"
+
+
+
+namespace Mat
+{
+	namespace Kernel
+	{
+
+		//Loops over fixed extents with at most this many iterations are unrolled at compile time
+		const unsigned int FixedUnrollLimit = 64;
+
+
+		//Struct Template UnrollLoop, which calls f(I), ..., f(N - 1), either unrolled by template recursion or as a plain loop
+		template <unsigned int I, unsigned int N, bool Unrolled> struct UnrollLoop
+		{
+			template <typename F> static void run(F const & f)
+			{
+				for (unsigned int i = I; i < N; ++i)
+				{
+					f(i);
+				}
+			}
+		};
+
+		template <unsigned int I, unsigned int N> struct UnrollLoop<I, N, true>
+		{
+			template <typename F> static void run(F const & f)
+			{
+				f(I);
+				UnrollLoop<I + 1, N, true>::run(f);
+			}
+		};
+
+		template <unsigned int N> struct UnrollLoop<N, N, true>
+		{
+			template <typename F> static void run(F const &)
+			{
+			}
+		};
+
+
+		//Calls f(0), ..., f(N - 1), unrolled if N is small
+		template <unsigned int N, typename F> void unroll(F const & f)
+		{
+			UnrollLoop<0, N, (N <= FixedUnrollLimit)>::run(f);
+		}
+
+
+	} //Namespace: Kernel
+
+
+
+	//Return type R of operators that only exist for fixed-size vectors
+	template <unsigned int N, typename R> using FixedVectorResult = typename std::enable_if<N != Dynamic, R>::type;
+
+
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template Vector<T, N>, which stores N components inline (no heap allocation, no size checks)
+	//Sizes are compile time constants, so vectors of different sizes cannot be combined at all
+	template <typename T, unsigned int N> class Vector
+	{
+		static_assert((N != Dynamic) && (N > 0), "Vector<T, N>: N has to be a positive compile time constant!");
+
+	public:
+		typedef T ValueType;
+		static const unsigned int Size = N;
+
+	private:
+		T mVec[N];
+
+	public:
+		//Standard constructor constructs a vector filled with T()
+		Vector()
+			: mVec()
+		{}
+
+
+		//Constructor that constructs a vector filled with value
+		explicit Vector(T const & value)
+		{
+			this->fillWith(value);
+		}
+
+
+		//Constructor that constructs a vector from std::vector (which has to have N components)
+		explicit Vector(std::vector<T> const & vec)
+		{
+			if (vec.size() != N)
+			{
+				throw IncompatibleVectorSizesException("Vector<T, N>::Vector(std::vector<T> const & vec): vec does not have N components!", N, static_cast<VectorSize>(vec.size()));
+			}
+			Kernel::unroll<N>([&](unsigned int i) { mVec[i] = vec[i]; });
+		}
+
+
+		//Constructor that copies a dynamically sized vector (which has to have N components)
+		explicit Vector(Vector<T> const & vec)
+		{
+			if (vec.getSize() != N)
+			{
+				throw IncompatibleVectorSizesException("Vector<T, N>::Vector(Vector<T> const & vec): vec does not have N components!", N, vec.getSize());
+			}
+			Kernel::unroll<N>([&](unsigned int i) { mVec[i] = vec.evaluateAt(i); });
+		}
+
+
+		//Destructor and all other constructors stay default!
+
+
+	public:
+		//Gives access to components
+		T& at(VectorEntry const & entry)
+		{
+			if (entry >= N)
+			{
+				throw InvalidIndexException("Vector<T, N>::at(VectorEntry const & entry): entry is not a valid index!", entry);
+			}
+			return mVec[entry];
+		}
+
+
+		//Gives constant access to components
+		T const & at(VectorEntry const & entry) const
+		{
+			if (entry >= N)
+			{
+				throw InvalidIndexException("Vector<T, N>::at(VectorEntry const & entry) const: entry is not a valid index!", entry);
+			}
+			return mVec[entry];
+		}
+
+
+		//Gives access to components, the bound is only checked in debug builds
+		T& operator[](VectorEntry const & entry)
+		{
+#ifdef MATRIX_DEBUG_CHECKS
+			if (entry >= N)
+			{
+				throw InvalidIndexException("Vector<T, N>::operator[](VectorEntry const & entry): entry is not a valid index!", entry);
+			}
+#endif
+			return mVec[entry];
+		}
+
+
+		//Gives constant access to components, the bound is only checked in debug builds
+		T const & operator[](VectorEntry const & entry) const
+		{
+#ifdef MATRIX_DEBUG_CHECKS
+			if (entry >= N)
+			{
+				throw InvalidIndexException("Vector<T, N>::operator[](VectorEntry const & entry) const: entry is not a valid index!", entry);
+			}
+#endif
+			return mVec[entry];
+		}
+
+
+		//Iterators over the components
+		T* begin()
+		{
+			return mVec;
+		}
+
+		T* end()
+		{
+			return mVec + N;
+		}
+
+		T const * begin() const
+		{
+			return mVec;
+		}
+
+		T const * end() const
+		{
+			return mVec + N;
+		}
+
+
+		//Returns size of vector
+		static VectorSize getSize()
+		{
+			return N;
+		}
+
+
+		//Returns the component at entry without bounds check
+		T const & evaluateAt(VectorEntry const & entry) const
+		{
+			return mVec[entry];
+		}
+
+
+		//Gives direct access to the components
+		T* data()
+		{
+			return mVec;
+		}
+
+
+		//Gives direct constant access to the components
+		T const * data() const
+		{
+			return mVec;
+		}
+
+
+		//Returns a list of all VectorEntries whose values differ from val less or equal than tolerance
+		std::list<VectorEntry> find(T const & val, T const & tolerance = T(0)) const
+		{
+			std::list<VectorEntry> list;
+			for (unsigned int i = 0; i < N; ++i)
+			{
+				if (std::abs(mVec[i] - val) <= tolerance)
+				{
+					list.push_back(i);
+				}
+			}
+			return list;
+		}
+
+
+		//Fills the whole vector with value
+		void fillWith(T const & value)
+		{
+			Kernel::unroll<N>([&](unsigned int i) { mVec[i] = value; });
+		}
+
+
+	}; //Class Template: Vector<T, N>
+
+
+
+	template <typename T, unsigned int N> FixedVectorResult<N, std::ostream&> operator<<(std::ostream& oStream, Vector<T, N> const & vec)
+	{
+		for (unsigned int i = 0; i < N; ++i)
+		{
+			if (i != 0)
+			{
+				oStream << " ";
+			}
+			oStream << vec.evaluateAt(i);
+		}
+		return oStream;
+	}
+
+
+	//Returns this vector
+	template <typename T, unsigned int N> FixedVectorResult<N, Vector<T, N>> operator+(Vector<T, N> const & vec)
+	{
+		return vec;
+	}
+
+
+	//Returns the negation of this vector
+	template <typename T, unsigned int N> FixedVectorResult<N, Vector<T, N>> operator-(Vector<T, N> const & vec)
+	{
+		Vector<T, N> res;
+		Kernel::unroll<N>([&](unsigned int i) { res.data()[i] = -vec.data()[i]; });
+		return res;
+	}
+
+
+	//Componentwise addition
+	template <typename T, unsigned int N> FixedVectorResult<N, Vector<T, N>> operator+(Vector<T, N> const & vec1, Vector<T, N> const & vec2)
+	{
+		Vector<T, N> res;
+		Kernel::unroll<N>([&](unsigned int i) { res.data()[i] = vec1.data()[i] + vec2.data()[i]; });
+		return res;
+	}
+
+
+	//Componentwise subtraction
+	template <typename T, unsigned int N> FixedVectorResult<N, Vector<T, N>> operator-(Vector<T, N> const & vec1, Vector<T, N> const & vec2)
+	{
+		Vector<T, N> res;
+		Kernel::unroll<N>([&](unsigned int i) { res.data()[i] = vec1.data()[i] - vec2.data()[i]; });
+		return res;
+	}
+
+
+	//Entrywise multiplication with scalar from right
+	template <typename T, unsigned int N> FixedVectorResult<N, Vector<T, N>> operator*(Vector<T, N> const & vec, typename Vector<T, N>::ValueType const & scalar)
+	{
+		Vector<T, N> res;
+		Kernel::unroll<N>([&](unsigned int i) { res.data()[i] = vec.data()[i] * scalar; });
+		return res;
+	}
+
+
+	//Entrywise multiplication with scalar from left
+	template <typename T, unsigned int N> FixedVectorResult<N, Vector<T, N>> operator*(typename Vector<T, N>::ValueType const & scalar, Vector<T, N> const & vec)
+	{
+		return vec * scalar;
+	}
+
+
+	//Entrywise division by scalar
+	template <typename T, unsigned int N> FixedVectorResult<N, Vector<T, N>> operator/(Vector<T, N> const & vec, typename Vector<T, N>::ValueType const & scalar)
+	{
+		Vector<T, N> res;
+		Kernel::unroll<N>([&](unsigned int i) { res.data()[i] = vec.data()[i] / scalar; });
+		return res;
+	}
+
+
+	//Inner product
+	template <typename T, unsigned int N> FixedVectorResult<N, T> operator*(Vector<T, N> const & vec1, Vector<T, N> const & vec2)
+	{
+		T sum = T(0);
+		Kernel::unroll<N>([&](unsigned int i) { sum += vec1.data()[i] * vec2.data()[i]; });
+		return sum;
+	}
+
+
+	//Adds vec2 to vec1
+	template <typename T, unsigned int N> FixedVectorResult<N, Vector<T, N>&> operator+=(Vector<T, N>& vec1, Vector<T, N> const & vec2)
+	{
+		Kernel::unroll<N>([&](unsigned int i) { vec1.data()[i] += vec2.data()[i]; });
+		return vec1;
+	}
+
+
+	//Subtracts vec2 from vec1
+	template <typename T, unsigned int N> FixedVectorResult<N, Vector<T, N>&> operator-=(Vector<T, N>& vec1, Vector<T, N> const & vec2)
+	{
+		Kernel::unroll<N>([&](unsigned int i) { vec1.data()[i] -= vec2.data()[i]; });
+		return vec1;
+	}
+
+
+	//Multiplies vec with scalar
+	template <typename T, unsigned int N> FixedVectorResult<N, Vector<T, N>&> operator*=(Vector<T, N>& vec, typename Vector<T, N>::ValueType const & scalar)
+	{
+		Kernel::unroll<N>([&](unsigned int i) { vec.data()[i] *= scalar; });
+		return vec;
+	}
+
+
+	//Divides vec by scalar
+	template <typename T, unsigned int N> FixedVectorResult<N, Vector<T, N>&> operator/=(Vector<T, N>& vec, typename Vector<T, N>::ValueType const & scalar)
+	{
+		Kernel::unroll<N>([&](unsigned int i) { vec.data()[i] /= scalar; });
+		return vec;
+	}
+
+
+
+} //Namespace: Mat
+
+#endif //FIXED_VECTOR_HPP
@@ -0,0 +1,348 @@
+#ifndef GEMM_HPP
+#define GEMM_HPP
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+
+#include "AlignedAllocator.hpp"
+#include "ThreadPool.hpp"
+
+
+
+namespace Mat
+{
+	namespace Kernel
+	{
+
+		////////////////////////////////////////////////////////////////////////////////////////////////////////
+		//Struct Template GemmTraits, which holds the register tile (MR x NR) and the cache blocking of the GEMM
+		//MR x NR accumulators should fit into the register file, a KC x NR sliver of B into L1,
+		//an MC x KC block of A into L2 and a KC x NC panel of B into L3
+		template <typename T> struct GemmTraits
+		{
+			static const unsigned int MR = 4;
+			static const unsigned int NR = 4;
+			static const unsigned int MC = 64;
+			static const unsigned int KC = 128;
+			static const unsigned int NC = 1024;
+		};
+
+		template <> struct GemmTraits<double>
+		{
+			static const unsigned int MR = 4;
+			static const unsigned int NR = 8;
+			static const unsigned int MC = 128;
+			static const unsigned int KC = 256;
+			static const unsigned int NC = 4096;
+		};
+
+		template <> struct GemmTraits<float>
+		{
+			static const unsigned int MR = 4;
+			static const unsigned int NR = 8;
+			static const unsigned int MC = 128;
+			static const unsigned int KC = 384;
+			static const unsigned int NC = 4096;
+		};
+
+		template <> struct GemmTraits<int>
+		{
+			static const unsigned int MR = 4;
+			static const unsigned int NR = 8;
+			static const unsigned int MC = 128;
+			static const unsigned int KC = 384;
+			static const unsigned int NC = 4096;
+		};
+
+
+		//Products with fewer multiply-adds than this skip packing and use gemmSmall
+		const std::size_t GemmSmallThreshold = 48 * 48 * 48;
+
+		//Products with at least this many multiply-adds are split over the thread pool
+		const std::size_t GemmParallelThreshold = 128 * 128 * 128;
+
+
+		//All GEMM kernels compute C = alpha * A * B + beta * C with
+		//A(i, p) = A[i * rsA + p * csA] (m x k), B(p, j) = B[p * rsB + j * csB] (k x n) and C(i, j) = C[i * ldc + j] (m x n)
+		//Row and column strides allow transposed operands and views without any copy
+
+
+		//Scales the m x n block C by beta (beta == 0 overwrites, so that garbage in C never propagates)
+		template <typename T> void scaleBlock(std::size_t m, std::size_t n, T const & beta, T* C, std::size_t ldc)
+		{
+			if (beta == T(1))
+			{
+				return;
+			}
+			for (std::size_t i = 0; i < m; ++i)
+			{
+				T* row = C + i * ldc;
+				if (beta == T(0))
+				{
+					std::fill(row, row + n, T(0));
+				}
+				else
+				{
+					for (std::size_t j = 0; j < n; ++j)
+					{
+						row[j] *= beta;
+					}
+				}
+			}
+		}
+
+
+		//Reference implementation (plain triple loop), only meant for testing the optimized kernels
+		template <typename T> void gemmReference(std::size_t m, std::size_t n, std::size_t k, T const & alpha,
+			T const * A, std::size_t rsA, std::size_t csA, T const * B, std::size_t rsB, std::size_t csB,
+			T const & beta, T* C, std::size_t ldc)
+		{
+			for (std::size_t i = 0; i < m; ++i)
+			{
+				for (std::size_t j = 0; j < n; ++j)
+				{
+					T sum = T(0);
+					for (std::size_t p = 0; p < k; ++p)
+					{
+						sum += A[i * rsA + p * csA] * B[p * rsB + j * csB];
+					}
+					C[i * ldc + j] = (beta == T(0)) ? alpha * sum : alpha * sum + beta * C[i * ldc + j];
+				}
+			}
+		}
+
+
+		//Unpacked i-p-j kernel for small products (inner loop runs along rows of B and C)
+		template <typename T> void gemmSmall(std::size_t m, std::size_t n, std::size_t k, T const & alpha,
+			T const * A, std::size_t rsA, std::size_t csA, T const * B, std::size_t rsB, std::size_t csB,
+			T const & beta, T* C, std::size_t ldc)
+		{
+			scaleBlock(m, n, beta, C, ldc);
+			for (std::size_t i = 0; i < m; ++i)
+			{
+				T* cRow = C + i * ldc;
+				for (std::size_t p = 0; p < k; ++p)
+				{
+					T const a = alpha * A[i * rsA + p * csA];
+					T const * bRow = B + p * rsB;
+					for (std::size_t j = 0; j < n; ++j)
+					{
+						cRow[j] += a * bRow[j * csB];
+					}
+				}
+			}
+		}
+
+
+		//Packs the mc x kc block of A into MR-row slivers (column-major inside a sliver), padding with zeros
+		template <typename T> void packA(std::size_t mc, std::size_t kc, T const * A, std::size_t rsA, std::size_t csA, T* buffer)
+		{
+			const unsigned int MR = GemmTraits<T>::MR;
+			for (std::size_t ir = 0; ir < mc; ir += MR)
+			{
+				std::size_t mr = std::min<std::size_t>(MR, mc - ir);
+				T* sliver = buffer + ir * kc;
+				for (std::size_t p = 0; p < kc; ++p)
+				{
+					for (std::size_t i = 0; i < mr; ++i)
+					{
+						sliver[p * MR + i] = A[(ir + i) * rsA + p * csA];
+					}
+					for (std::size_t i = mr; i < MR; ++i)
+					{
+						sliver[p * MR + i] = T(0);
+					}
+				}
+			}
+		}
+
+
+		//Packs the kc x nc panel of B into NR-column slivers (row-major inside a sliver), padding with zeros
+		template <typename T> void packB(std::size_t kc, std::size_t nc, T const * B, std::size_t rsB, std::size_t csB, T* buffer)
+		{
+			const unsigned int NR = GemmTraits<T>::NR;
+			for (std::size_t jr = 0; jr < nc; jr += NR)
+			{
+				std::size_t nr = std::min<std::size_t>(NR, nc - jr);
+				T* sliver = buffer + jr * kc;
+				for (std::size_t p = 0; p < kc; ++p)
+				{
+					T const * bRow = B + p * rsB + jr * csB;
+					for (std::size_t j = 0; j < nr; ++j)
+					{
+						sliver[p * NR + j] = bRow[j * csB];
+					}
+					for (std::size_t j = nr; j < NR; ++j)
+					{
+						sliver[p * NR + j] = T(0);
+					}
+				}
+			}
+		}
+
+
+		//Register-tiled micro-kernel: C(mr x nr) += alpha * Apacked(MR x kc) * Bpacked(kc x NR)
+		//The fixed MR x NR accumulator block lets the compiler keep it in vector registers
+		template <typename T> void gemmMicroKernel(std::size_t kc, T const & alpha, T const * a, T const * b,
+			T* C, std::size_t ldc, std::size_t mr, std::size_t nr)
+		{
+			const unsigned int MR = GemmTraits<T>::MR;
+			const unsigned int NR = GemmTraits<T>::NR;
+			T acc[MR][NR];
+			for (unsigned int i = 0; i < MR; ++i)
+			{
+				for (unsigned int j = 0; j < NR; ++j)
+				{
+					acc[i][j] = T(0);
+				}
+			}
+
+			for (std::size_t p = 0; p < kc; ++p)
+			{
+				T const * aCol = a + p * MR;
+				T const * bRow = b + p * NR;
+				for (unsigned int i = 0; i < MR; ++i)
+				{
+					T const ai = aCol[i];
+					for (unsigned int j = 0; j < NR; ++j)
+					{
+						acc[i][j] += ai * bRow[j];
+					}
+				}
+			}
+
+			for (std::size_t i = 0; i < mr; ++i)
+			{
+				T* cRow = C + i * ldc;
+				for (std::size_t j = 0; j < nr; ++j)
+				{
+					cRow[j] += alpha * acc[i][j];
+				}
+			}
+		}
+
+
+		//Macro-kernel: multiplies a packed mc x kc block of A with a packed kc x nc panel of B into C
+		template <typename T> void gemmMacroKernel(std::size_t mc, std::size_t nc, std::size_t kc, T const & alpha,
+			T const * packedA, T const * packedB, T* C, std::size_t ldc)
+		{
+			const unsigned int MR = GemmTraits<T>::MR;
+			const unsigned int NR = GemmTraits<T>::NR;
+			for (std::size_t jr = 0; jr < nc; jr += NR)
+			{
+				std::size_t nr = std::min<std::size_t>(NR, nc - jr);
+				for (std::size_t ir = 0; ir < mc; ir += MR)
+				{
+					std::size_t mr = std::min<std::size_t>(MR, mc - ir);
+					gemmMicroKernel(kc, alpha, packedA + ir * kc, packedB + jr * kc, C + ir * ldc + jr, ldc, mr, nr);
+				}
+			}
+		}
+
+
+		//Returns packing buffer Index (0 for A, 1 for B) of the calling thread with at least size entries
+		//The buffers live as long as the thread and always come from the heap, so repeated products do not allocate
+		template <typename T, unsigned int Index> T* getPackingBuffer(std::size_t size)
+		{
+			thread_local std::vector<T, AlignedAllocator<T>> buffer((AlignedAllocator<T>(getHeapResource())));
+			if (buffer.size() < size)
+			{
+				buffer.resize(size);
+			}
+			return buffer.data();
+		}
+
+
+		//Cache-blocked GEMM with packing (Goto/BLIS loop order: NC -> KC -> MC -> NR -> MR)
+		template <typename T> void gemmBlocked(std::size_t m, std::size_t n, std::size_t k, T const & alpha,
+			T const * A, std::size_t rsA, std::size_t csA, T const * B, std::size_t rsB, std::size_t csB,
+			T const & beta, T* C, std::size_t ldc)
+		{
+			typedef GemmTraits<T> Traits;
+			scaleBlock(m, n, beta, C, ldc);
+			if ((m == 0) || (n == 0) || (k == 0) || (alpha == T(0)))
+			{
+				return;
+			}
+
+			std::size_t const mcMax = std::min<std::size_t>(Traits::MC, (m + Traits::MR - 1) / Traits::MR * Traits::MR);
+			std::size_t const kcMax = std::min<std::size_t>(Traits::KC, k);
+			std::size_t const ncMax = std::min<std::size_t>(Traits::NC, (n + Traits::NR - 1) / Traits::NR * Traits::NR);
+			T* packedA = getPackingBuffer<T, 0>(mcMax * kcMax);
+			T* packedB = getPackingBuffer<T, 1>(kcMax * ncMax);
+
+			for (std::size_t jc = 0; jc < n; jc += Traits::NC)
+			{
+				std::size_t nc = std::min<std::size_t>(Traits::NC, n - jc);
+				for (std::size_t pc = 0; pc < k; pc += Traits::KC)
+				{
+					std::size_t kc = std::min<std::size_t>(Traits::KC, k - pc);
+					packB(kc, nc, B + pc * rsB + jc * csB, rsB, csB, packedB);
+					for (std::size_t ic = 0; ic < m; ic += Traits::MC)
+					{
+						std::size_t mc = std::min<std::size_t>(Traits::MC, m - ic);
+						packA(mc, kc, A + ic * rsA + pc * csA, rsA, csA, packedA);
+						gemmMacroKernel(mc, nc, kc, alpha, packedA, packedB, C + ic * ldc + jc, ldc);
+					}
+				}
+			}
+		}
+
+
+		//Splits C into MC x (multiple of NR) tiles and runs gemmBlocked for each of them on the thread pool
+		//Every entry of C is accumulated over the same KC blocks in the same order, so the result does not depend on the thread count
+		template <typename T> void gemmParallel(std::size_t m, std::size_t n, std::size_t k, T const & alpha,
+			T const * A, std::size_t rsA, std::size_t csA, T const * B, std::size_t rsB, std::size_t csB,
+			T const & beta, T* C, std::size_t ldc)
+		{
+			typedef GemmTraits<T> Traits;
+			ThreadPool& pool = ThreadPool::instance();
+
+			//Aim for about four tiles per thread, so that uneven tiles still balance
+			std::size_t const tilesM = (m + Traits::MC - 1) / Traits::MC;
+			std::size_t const targetTiles = 4 * static_cast<std::size_t>(pool.getThreadCount());
+			std::size_t const maxTilesN = (n + Traits::NR - 1) / Traits::NR;
+			std::size_t tilesN = std::min(maxTilesN, std::max<std::size_t>(1, (targetTiles + tilesM - 1) / tilesM));
+			std::size_t const tileN = ((n + tilesN - 1) / tilesN + Traits::NR - 1) / Traits::NR * Traits::NR;
+			tilesN = (n + tileN - 1) / tileN;
+
+			pool.run(tilesM * tilesN, [&](std::size_t tile)
+			{
+				std::size_t ic = (tile / tilesN) * Traits::MC;
+				std::size_t jc = (tile % tilesN) * tileN;
+				std::size_t mc = std::min<std::size_t>(Traits::MC, m - ic);
+				std::size_t nc = std::min(tileN, n - jc);
+				gemmBlocked(mc, nc, k, alpha, A + ic * rsA, rsA, csA, B + jc * csB, rsB, csB, beta, C + ic * ldc + jc, ldc);
+			});
+		}
+
+
+		//Computes C = alpha * A * B + beta * C, choosing the kernel by problem size
+		template <typename T> void gemm(std::size_t m, std::size_t n, std::size_t k, T const & alpha,
+			T const * A, std::size_t rsA, std::size_t csA, T const * B, std::size_t rsB, std::size_t csB,
+			T const & beta, T* C, std::size_t ldc)
+		{
+			std::size_t const work = m * n * k;
+			if (work < GemmSmallThreshold)
+			{
+				gemmSmall(m, n, k, alpha, A, rsA, csA, B, rsB, csB, beta, C, ldc);
+			}
+			else if ((work < GemmParallelThreshold) || (ThreadPool::instance().getThreadCount() == 1))
+			{
+				gemmBlocked(m, n, k, alpha, A, rsA, csA, B, rsB, csB, beta, C, ldc);
+			}
+			else
+			{
+				gemmParallel(m, n, k, alpha, A, rsA, csA, B, rsB, csB, beta, C, ldc);
+			}
+		}
+
+
+
+	} //Namespace: Kernel
+
+} //Namespace: Mat
+
+#endif //GEMM_HPP
+
@@ -0,0 +1,135 @@
+#ifndef GEMV_HPP
+#define GEMV_HPP
+
+#include <cstddef>
+#include <algorithm>
+
+#include "Simd.hpp"
+#include "ThreadPool.hpp"
+
+
+
+namespace Mat
+{
+	namespace Kernel
+	{
+
+		//Matrix vector products with at least this many entries in the matrix are split over the thread pool
+		const std::size_t GemvParallelThreshold = 1 << 16;
+
+		//Products of a matrix with at least this many vectors are formed as one GEMM instead of one GEMV per vector
+		const std::size_t MultiVectorGemmThreshold = 8;
+
+
+		//Dot product of n entries with strides incx and incy
+		//Four independent partial sums break the dependency chain; their combination order is fixed, so the result is reproducible
+		template <typename T> T dotStrided(std::size_t n, T const * x, std::size_t incx, T const * y, std::size_t incy)
+		{
+			T s0 = T(0);
+			T s1 = T(0);
+			T s2 = T(0);
+			T s3 = T(0);
+			std::size_t i = 0;
+			for (; i + 4 <= n; i += 4)
+			{
+				s0 += x[i * incx] * y[i * incy];
+				s1 += x[(i + 1) * incx] * y[(i + 1) * incy];
+				s2 += x[(i + 2) * incx] * y[(i + 2) * incy];
+				s3 += x[(i + 3) * incx] * y[(i + 3) * incy];
+			}
+			for (; i < n; ++i)
+			{
+				s0 += x[i * incx] * y[i * incy];
+			}
+			return (s0 + s1) + (s2 + s3);
+		}
+
+
+		//Computes y = alpha * A * x + beta * y for the m x n matrix A(i, p) = A[i * rsA + p * csA]
+		//Rows are split over the thread pool; every row is reduced serially, so results do not depend on the thread count
+		template <typename T> void gemv(std::size_t m, std::size_t n, T const & alpha, T const * A, std::size_t rsA, std::size_t csA,
+			T const * x, std::size_t incx, T const & beta, T* y, std::size_t incy)
+		{
+			bool const contiguous = (csA == 1) && (incx == 1);
+			auto rowRange = [&](std::size_t begin, std::size_t end)
+			{
+				for (std::size_t i = begin; i < end; ++i)
+				{
+					T const sum = contiguous ? Simd::dot(n, A + i * rsA, x) : dotStrided(n, A + i * rsA, csA, x, incx);
+					T & yi = y[i * incy];
+					yi = (beta == T(0)) ? alpha * sum : alpha * sum + beta * yi;
+				}
+			};
+
+			ThreadPool& pool = ThreadPool::instance();
+			if ((m * n < GemvParallelThreshold) || (pool.getThreadCount() == 1))
+			{
+				rowRange(0, m);
+			}
+			else
+			{
+				std::size_t grainSize = std::max<std::size_t>(16, m / (4 * static_cast<std::size_t>(pool.getThreadCount())));
+				pool.parallelFor(0, m, grainSize, rowRange);
+			}
+		}
+
+
+
+		//Computes y = alpha * A^T * x + beta * y for the m x n matrix A(i, p) = A[i * rsA + p * csA] (x has m, y has n entries)
+		//With contiguous rows, A is streamed row by row and every row is added to y (axpy form), so A^T is never formed.
+		//The thread pool splits y into column ranges; every y[p] still accumulates the rows in order 0, 1, ..., m - 1,
+		//so results do not depend on the thread count
+		template <typename T> void gemvTransposed(std::size_t m, std::size_t n, T const & alpha, T const * A, std::size_t rsA, std::size_t csA,
+			T const * x, std::size_t incx, T const & beta, T* y, std::size_t incy)
+		{
+			//Strided rows: the transposed matrix is just another strided matrix, reduce its rows with dot products
+			if ((csA != 1) || (incy != 1))
+			{
+				gemv(n, m, alpha, A, csA, rsA, x, incx, beta, y, incy);
+				return;
+			}
+
+			auto columnRange = [&](std::size_t begin, std::size_t end)
+			{
+				T* yBlock = y + begin;
+				std::size_t const width = end - begin;
+				if (beta == T(0))
+				{
+					std::fill(yBlock, yBlock + width, T(0));
+				}
+				else if (beta != T(1))
+				{
+					Simd::scale(width, yBlock, beta, yBlock);
+				}
+				for (std::size_t i = 0; i < m; ++i)
+				{
+					Simd::axpy(width, alpha * x[i * incx], A + i * rsA + begin, yBlock);
+				}
+			};
+
+			//A column range of y stays in L1 while all rows stream past it
+			const std::size_t ColumnBlock = 2048;
+			ThreadPool& pool = ThreadPool::instance();
+			if ((m * n < GemvParallelThreshold) || (pool.getThreadCount() == 1))
+			{
+				for (std::size_t begin = 0; begin < n; begin += ColumnBlock)
+				{
+					columnRange(begin, std::min(n, begin + ColumnBlock));
+				}
+			}
+			else
+			{
+				std::size_t grainSize = std::max<std::size_t>(64, n / (4 * static_cast<std::size_t>(pool.getThreadCount())));
+				grainSize = std::min(grainSize, ColumnBlock);
+				pool.parallelFor(0, n, grainSize, columnRange);
+			}
+		}
+
+
+
+	} //Namespace: Kernel
+
+} //Namespace: Mat
+
+#endif //GEMV_HPP
+
@@ -0,0 +1,873 @@
+#ifndef KRYLOV_HPP
+#define KRYLOV_HPP
+
+#include <cstddef>
+#include <cmath>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+
+#include "Algorithm.hpp"
+#include "Blas1.hpp"
+#include "Gemv.hpp"
+#include "Matrix.hpp"
+#include "SparseMatrix.hpp"
+
+
+
+namespace Mat
+{
+
+	//Iterative solvers for A * x = b (CG, BiCGSTAB and restarted GMRES) and preconditioners for them.
+	//A can be a square Matrix<T>, a square SparseMatrix<T> or any callable op(x, y) that stores A * x in y (y already has the size of b).
+	//A preconditioner is any callable M(r, z) that stores an approximation of A^-1 * r in z (z has the size of r and is not r);
+	//IdentityPreconditioner, JacobiPreconditioner and ILU0Preconditioner are provided.
+	//Every solver object allocates its workspace once for a system size; solve() then only allocates for the residual history
+	//(if recordHistory is set), never per iteration. All vector operations run on the Level 1 BLAS and GEMV kernels
+
+
+	//Why a solver stopped: the residual reached the tolerance, the iteration limit was hit, or a division by zero would have been necessary
+	enum class SolverStatus
+	{
+		Converged,
+		MaxIterations,
+		Breakdown
+	};
+
+
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	//Struct Template SolverSettings, which holds the stopping criteria of the iterative solvers
+	//A solve converges once the residual norm |b - A * x| is at most tolerance * |b|
+	template <typename T> struct SolverSettings
+	{
+		unsigned int maxIterations;
+		T tolerance;
+		unsigned int restart; //Krylov subspace dimension of GMRES before it restarts
+		bool recordHistory; //Whether SolverStatistics::residualHistory is filled
+
+		SolverSettings(unsigned int _maxIterations = 1000, T const & _tolerance = std::sqrt(std::numeric_limits<T>::epsilon()), unsigned int _restart = 30, bool _recordHistory = false)
+			: maxIterations(_maxIterations), tolerance(_tolerance), restart(_restart), recordHistory(_recordHistory)
+		{}
+	};
+
+
+	//////////////////////////////////////////////////////////////////////////////////////////
+	//Struct Template SolverStatistics, which reports how a solve went
+	template <typename T> struct SolverStatistics
+	{
+		SolverStatus status;
+		unsigned int iterations;
+		unsigned int operatorApplications; //Products with A, including those for residuals
+		T initialResidualNorm;
+		T residualNorm; //Last residual norm the solver computed (for GMRES the true residual, for CG and BiCGSTAB the updated one)
+		std::vector<T> residualHistory; //Initial residual norm, then one per iteration (if SolverSettings::recordHistory is set)
+
+		SolverStatistics()
+			: status(SolverStatus::MaxIterations), iterations(0), operatorApplications(0), initialResidualNorm(T(0)), residualNorm(T(0)), residualHistory()
+		{}
+
+		//Returns whether the residual reached the tolerance
+		bool converged() const
+		{
+			return status == SolverStatus::Converged;
+		}
+
+		//Returns residualNorm / initialResidualNorm (0 if the initial residual was 0)
+		T getResidualReduction() const
+		{
+			return (initialResidualNorm == T(0)) ? T(0) : residualNorm / initialResidualNorm;
+		}
+	};
+
+
+
+	namespace Kernel
+	{
+
+		//Computes y = A * x with the GEMV kernel
+		template <typename T> void applyOperator(Matrix<T> const & A, Vector<T> const & x, Vector<T> & y)
+		{
+			Kernel::gemv<T>(A.getSize().m(), A.getSize().n(), T(1), A.data(), A.getStride(), 1, x.data(), 1, T(0), y.data(), 1);
+		}
+
+
+		//Computes y = A * x without allocating (CSR on the thread pool, CSC serially)
+		template <typename T> void applyOperator(SparseMatrix<T> const & A, Vector<T> const & x, Vector<T> & y)
+		{
+			std::vector<std::size_t> const & offsets = A.getOffsets();
+			unsigned int const * indices = A.getIndices().data();
+			T const * values = A.getValues().data();
+			if (A.getLayout() == SparseLayout::CSR)
+			{
+				csrMultiply(A.getSize().m(), A.getNumberOfNonZeros(), offsets.data(), indices, values, x.data(), y.data());
+				return;
+			}
+			T* out = y.data();
+			std::fill(out, out + y.getSize(), T(0));
+			for (std::size_t col = 0; col + 1 < offsets.size(); ++col)
+			{
+				T const xc = x.data()[col];
+				for (std::size_t k = offsets[col]; k < offsets[col + 1]; ++k)
+				{
+					out[indices[k]] += values[k] * xc;
+				}
+			}
+		}
+
+
+		//Computes y = A * x for a callable operator
+		template <typename Op, typename T> void applyOperator(Op const & A, Vector<T> const & x, Vector<T> & y)
+		{
+			A(x, y);
+		}
+
+
+		//Throws if the matrix A does not fit a system of size n
+		template <typename M> void checkOperatorMatrix(M const & A, VectorSize n, char const * function)
+		{
+			if ((A.getSize().x() != A.getSize().y()) || (A.getSize().x() != n))
+			{
+				throw IncompatibleMatrixSizesException(std::string(function) + ": A is not square or does not match b!", A.getSize(), XY(1, n));
+			}
+		}
+
+		template <typename T> void checkOperator(Matrix<T> const & A, VectorSize n, char const * function)
+		{
+			checkOperatorMatrix(A, n, function);
+		}
+
+		template <typename T> void checkOperator(SparseMatrix<T> const & A, VectorSize n, char const * function)
+		{
+			checkOperatorMatrix(A, n, function);
+		}
+
+		//Callable operators cannot be checked
+		template <typename Op> void checkOperator(Op const &, VectorSize, char const *)
+		{
+		}
+
+
+		//Copies src to dst (same size)
+		template <typename T> void copyVector(Vector<T> const & src, Vector<T> & dst)
+		{
+			std::copy(src.data(), src.data() + src.getSize(), dst.data());
+		}
+
+
+		//Makes v a vector of size n (allocates only if its size differs)
+		template <typename T> void prepareVector(Vector<T> & v, VectorSize n)
+		{
+			if (v.getSize() != n)
+			{
+				v = Vector<T>(n, T(0));
+			}
+		}
+
+
+		//Computes r = b - A * x
+		template <typename Op, typename T> void residual(Op const & A, Vector<T> const & b, Vector<T> const & x, Vector<T> & r)
+		{
+			applyOperator(A, x, r);
+			Mat::scal(T(-1), r);
+			Mat::axpy(T(1), b, r);
+		}
+
+
+		//Common start of all solvers: validates the sizes, prepares x (a warm start if it already has the size of b, else zero)
+		//and the statistics. Returns the absolute residual norm to reach, or a negative value if b is zero (x is zero then)
+		template <typename Op, typename T> T startSolve(Op const & A, Vector<T> const & b, Vector<T> & x, SolverSettings<T> const & settings, SolverStatistics<T> & statistics, char const * function)
+		{
+			static_assert(std::is_floating_point<T>::value, "Iterative solvers are only defined for floating point types!");
+			checkOperator(A, b.getSize(), function);
+			prepareVector(x, b.getSize());
+			if (settings.recordHistory)
+			{
+				statistics.residualHistory.reserve(settings.maxIterations + 1);
+			}
+			T const bNorm = Mat::nrm2(b);
+			if (bNorm == T(0))
+			{
+				x.fillWith(T(0));
+				statistics.status = SolverStatus::Converged;
+				if (settings.recordHistory)
+				{
+					statistics.residualHistory.push_back(T(0));
+				}
+				return T(-1);
+			}
+			return settings.tolerance * bNorm;
+		}
+
+
+		//Records the residual norm of an iteration (or the initial one if it is the first)
+		template <typename T> void recordResidual(SolverStatistics<T> & statistics, SolverSettings<T> const & settings, T const & norm)
+		{
+			statistics.residualNorm = norm;
+			if (settings.recordHistory)
+			{
+				statistics.residualHistory.push_back(norm);
+			}
+		}
+
+
+	} //Namespace: Kernel
+
+
+
+	//////////////////////////////////////////////////////////////////////////
+	//Class Template IdentityPreconditioner, which does not precondition (z = r)
+	template <typename T> class IdentityPreconditioner
+	{
+	public:
+		void operator()(Vector<T> const & r, Vector<T> & z) const
+		{
+			Kernel::copyVector(r, z);
+		}
+	};
+
+
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template JacobiPreconditioner, which divides by the diagonal of A (z[i] = r[i] / A(i, i))
+	//Cheap and parallel; helps most if the rows of A are scaled very differently
+	template <typename T> class JacobiPreconditioner
+	{
+	private:
+		Vector<T> mInverseDiagonal;
+
+	public:
+		//Constructor that takes the diagonal of a square dense matrix
+		explicit JacobiPreconditioner(Matrix<T> const & A)
+			: mInverseDiagonal(A.getSize().x())
+		{
+			Kernel::checkOperator(A, A.getSize().y(), "JacobiPreconditioner<T>::JacobiPreconditioner(Matrix<T> const & A)");
+			for (unsigned int i = 0; i < A.getSize().x(); ++i)
+			{
+				this->setDiagonalEntry(i, A(i, i), "JacobiPreconditioner<T>::JacobiPreconditioner(Matrix<T> const & A): a diagonal entry is zero!");
+			}
+		}
+
+
+		//Constructor that takes the diagonal of a square sparse matrix
+		explicit JacobiPreconditioner(SparseMatrix<T> const & A)
+			: mInverseDiagonal(A.getSize().x())
+		{
+			Kernel::checkOperator(A, A.getSize().y(), "JacobiPreconditioner<T>::JacobiPreconditioner(SparseMatrix<T> const & A)");
+			for (unsigned int i = 0; i < A.getSize().x(); ++i)
+			{
+				this->setDiagonalEntry(i, A.at(XY(i, i)), "JacobiPreconditioner<T>::JacobiPreconditioner(SparseMatrix<T> const & A): a diagonal entry is zero!");
+			}
+		}
+
+
+		//Destructor and all other constructors stay default!
+
+
+	public:
+		//Computes z = D^-1 * r
+		void operator()(Vector<T> const & r, Vector<T> & z) const
+		{
+			auto divide = [](T const & value, T const & inverse) { return value * inverse; };
+			Kernel::transform(r.getSize(), r.data(), mInverseDiagonal.data(), z.data(), divide, Execution::Parallel);
+		}
+
+
+	private:
+		void setDiagonalEntry(unsigned int i, T const & value, char const * message)
+		{
+			if (value == T(0))
+			{
+				throw SingularMatrixException(message);
+			}
+			mInverseDiagonal[i] = T(1) / value;
+		}
+	};
+
+
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template ILU0Preconditioner, which holds the incomplete LU factorization of A without fill-in: L * U has the sparsity
+	//pattern of A and matches A on it. Much stronger than Jacobi for matrices from discretized PDEs, but the triangular solves
+	//are sequential. The factors are stored in CSR like a SparseMatrix (L below the diagonal with unit diagonal, U on and above it)
+	template <typename T> class ILU0Preconditioner
+	{
+	private:
+		std::vector<std::size_t> mOffsets;
+		std::vector<unsigned int> mIndices;
+		std::vector<T> mValues;
+		std::vector<std::size_t> mDiagonal; //Position of the diagonal entry of every row in mIndices/mValues
+
+	public:
+		//Constructor that factorizes a square sparse matrix (every diagonal entry has to be stored)
+		explicit ILU0Preconditioner(SparseMatrix<T> const & A)
+			: mOffsets(), mIndices(), mValues(), mDiagonal()
+		{
+			Kernel::checkOperator(A, A.getSize().y(), "ILU0Preconditioner<T>::ILU0Preconditioner(SparseMatrix<T> const & A)");
+			SparseMatrix<T> const csr = A.toLayout(SparseLayout::CSR);
+			mOffsets = csr.getOffsets();
+			mIndices = csr.getIndices();
+			mValues = csr.getValues();
+			this->factorize();
+		}
+
+
+		//Constructor that factorizes the non-zero pattern of a square dense matrix
+		explicit ILU0Preconditioner(Matrix<T> const & A)
+			: ILU0Preconditioner(SparseMatrix<T>(A))
+		{}
+
+
+		//Destructor and all other constructors stay default!
+
+
+	public:
+		//Computes z = U^-1 * L^-1 * r
+		void operator()(Vector<T> const & r, Vector<T> & z) const
+		{
+			T const * in = r.data();
+			T* out = z.data();
+			std::size_t const n = mDiagonal.size();
+			for (std::size_t row = 0; row < n; ++row)
+			{
+				T sum = in[row];
+				for (std::size_t k = mOffsets[row]; k < mDiagonal[row]; ++k)
+				{
+					sum -= mValues[k] * out[mIndices[k]];
+				}
+				out[row] = sum;
+			}
+			for (std::size_t row = n; row-- > 0;)
+			{
+				T sum = out[row];
+				for (std::size_t k = mDiagonal[row] + 1; k < mOffsets[row + 1]; ++k)
+				{
+					sum -= mValues[k] * out[mIndices[k]];
+				}
+				out[row] = sum / mValues[mDiagonal[row]];
+			}
+		}
+
+
+	private:
+		//Factorizes row by row (IKJ order); the entries of a row are found through a scatter array over the columns
+		void factorize()
+		{
+			std::size_t const n = mOffsets.size() - 1;
+			std::size_t const none = static_cast<std::size_t>(-1);
+			std::vector<std::size_t> position(n, none);
+			mDiagonal.assign(n, none);
+			for (std::size_t row = 0; row < n; ++row)
+			{
+				for (std::size_t k = mOffsets[row]; k < mOffsets[row + 1]; ++k)
+				{
+					position[mIndices[k]] = k;
+					if (mIndices[k] == row)
+					{
+						mDiagonal[row] = k;
+					}
+				}
+				if (mDiagonal[row] == none)
+				{
+					throw SingularMatrixException("ILU0Preconditioner<T>::factorize(): a diagonal entry is not stored!");
+				}
+
+				for (std::size_t k = mOffsets[row]; k < mDiagonal[row]; ++k)
+				{
+					std::size_t const col = mIndices[k];
+					T const factor = mValues[k] / mValues[mDiagonal[col]];
+					mValues[k] = factor;
+					for (std::size_t kk = mDiagonal[col] + 1; kk < mOffsets[col + 1]; ++kk)
+					{
+						std::size_t const target = position[mIndices[kk]];
+						if (target != none)
+						{
+							mValues[target] -= factor * mValues[kk];
+						}
+					}
+				}
+				if (mValues[mDiagonal[row]] == T(0))
+				{
+					throw SingularMatrixException("ILU0Preconditioner<T>::factorize(): a pivot is zero!");
+				}
+
+				for (std::size_t k = mOffsets[row]; k < mOffsets[row + 1]; ++k)
+				{
+					position[mIndices[k]] = none;
+				}
+			}
+		}
+	};
+
+
+
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template ConjugateGradient, which solves A * x = b for symmetric positive definite A (and preconditioner)
+	//One product with A and one preconditioner application per iteration; four vectors of workspace
+	template <typename T> class ConjugateGradient
+	{
+	private:
+		SolverSettings<T> mSettings;
+		Vector<T> mR;
+		Vector<T> mZ;
+		Vector<T> mP;
+		Vector<T> mQ;
+
+	public:
+		//Constructor that allocates the workspace for systems of size size (solve reallocates for other sizes)
+		explicit ConjugateGradient(VectorSize size = 0, SolverSettings<T> const & settings = SolverSettings<T>())
+			: mSettings(settings), mR(size), mZ(size), mP(size), mQ(size)
+		{}
+
+
+		//Destructor and all other constructors stay default!
+
+
+	public:
+		SolverSettings<T> const & getSettings() const
+		{
+			return mSettings;
+		}
+
+		void setSettings(SolverSettings<T> const & settings)
+		{
+			mSettings = settings;
+		}
+
+
+		//Solves A * x = b without preconditioning, starting from x if it has the size of b
+		template <typename Op> SolverStatistics<T> solve(Op const & A, Vector<T> const & b, Vector<T> & x)
+		{
+			return this->solve(A, b, x, IdentityPreconditioner<T>());
+		}
+
+
+		//Solves A * x = b with the preconditioner M (symmetric positive definite as well), starting from x if it has the size of b
+		template <typename Op, typename Preconditioner> SolverStatistics<T> solve(Op const & A, Vector<T> const & b, Vector<T> & x, Preconditioner const & M)
+		{
+			MATRIX_PROFILE("ConjugateGradient::solve", 0.0, b.getSize(), 1u);
+			SolverStatistics<T> statistics;
+			T const target = Kernel::startSolve(A, b, x, mSettings, statistics, "ConjugateGradient<T>::solve(A, b, x, M)");
+			if (target < T(0))
+			{
+				return statistics;
+			}
+			this->prepare(b.getSize());
+
+			Kernel::residual(A, b, x, mR);
+			++statistics.operatorApplications;
+			statistics.initialResidualNorm = nrm2(mR);
+			Kernel::recordResidual(statistics, mSettings, statistics.initialResidualNorm);
+			if (statistics.residualNorm <= target)
+			{
+				statistics.status = SolverStatus::Converged;
+				return statistics;
+			}
+
+			M(mR, mZ);
+			Kernel::copyVector(mZ, mP);
+			T rz = dot(mR, mZ);
+			while (statistics.iterations < mSettings.maxIterations)
+			{
+				Kernel::applyOperator(A, mP, mQ);
+				++statistics.operatorApplications;
+				T const pq = dot(mP, mQ);
+				if ((pq == T(0)) || (rz == T(0)))
+				{
+					statistics.status = SolverStatus::Breakdown;
+					return statistics;
+				}
+				T const alpha = rz / pq;
+				axpy(alpha, mP, x);
+				axpy(-alpha, mQ, mR);
+				++statistics.iterations;
+				Kernel::recordResidual(statistics, mSettings, nrm2(mR));
+				if (statistics.residualNorm <= target)
+				{
+					statistics.status = SolverStatus::Converged;
+					return statistics;
+				}
+
+				M(mR, mZ);
+				T const rzNext = dot(mR, mZ);
+				scal(rzNext / rz, mP);
+				axpy(T(1), mZ, mP);
+				rz = rzNext;
+			}
+			statistics.status = SolverStatus::MaxIterations;
+			return statistics;
+		}
+
+
+	private:
+		void prepare(VectorSize n)
+		{
+			Kernel::prepareVector(mR, n);
+			Kernel::prepareVector(mZ, n);
+			Kernel::prepareVector(mP, n);
+			Kernel::prepareVector(mQ, n);
+		}
+	};
+
+
+
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template BiCGSTAB, which solves A * x = b for general non-singular A (right preconditioning)
+	//Two products with A and two preconditioner applications per iteration; eight vectors of workspace
+	template <typename T> class BiCGSTAB
+	{
+	private:
+		SolverSettings<T> mSettings;
+		Vector<T> mR;
+		Vector<T> mRHat;
+		Vector<T> mP;
+		Vector<T> mV;
+		Vector<T> mPHat;
+		Vector<T> mS;
+		Vector<T> mSHat;
+		Vector<T> mT;
+
+	public:
+		//Constructor that allocates the workspace for systems of size size (solve reallocates for other sizes)
+		explicit BiCGSTAB(VectorSize size = 0, SolverSettings<T> const & settings = SolverSettings<T>())
+			: mSettings(settings), mR(size), mRHat(size), mP(size), mV(size), mPHat(size), mS(size), mSHat(size), mT(size)
+		{}
+
+
+		//Destructor and all other constructors stay default!
+
+
+	public:
+		SolverSettings<T> const & getSettings() const
+		{
+			return mSettings;
+		}
+
+		void setSettings(SolverSettings<T> const & settings)
+		{
+			mSettings = settings;
+		}
+
+
+		//Solves A * x = b without preconditioning, starting from x if it has the size of b
+		template <typename Op> SolverStatistics<T> solve(Op const & A, Vector<T> const & b, Vector<T> & x)
+		{
+			return this->solve(A, b, x, IdentityPreconditioner<T>());
+		}
+
+
+		//Solves A * x = b with the preconditioner M, starting from x if it has the size of b
+		template <typename Op, typename Preconditioner> SolverStatistics<T> solve(Op const & A, Vector<T> const & b, Vector<T> & x, Preconditioner const & M)
+		{
+			MATRIX_PROFILE("BiCGSTAB::solve", 0.0, b.getSize(), 1u);
+			SolverStatistics<T> statistics;
+			T const target = Kernel::startSolve(A, b, x, mSettings, statistics, "BiCGSTAB<T>::solve(A, b, x, M)");
+			if (target < T(0))
+			{
+				return statistics;
+			}
+			this->prepare(b.getSize());
+
+			Kernel::residual(A, b, x, mR);
+			++statistics.operatorApplications;
+			statistics.initialResidualNorm = nrm2(mR);
+			Kernel::recordResidual(statistics, mSettings, statistics.initialResidualNorm);
+			if (statistics.residualNorm <= target)
+			{
+				statistics.status = SolverStatus::Converged;
+				return statistics;
+			}
+
+			Kernel::copyVector(mR, mRHat);
+			mP.fillWith(T(0));
+			mV.fillWith(T(0));
+			T rho = T(1);
+			T alpha = T(1);
+			T omega = T(1);
+			while (statistics.iterations < mSettings.maxIterations)
+			{
+				T const rhoNext = dot(mRHat, mR);
+				if (rhoNext == T(0))
+				{
+					statistics.status = SolverStatus::Breakdown;
+					return statistics;
+				}
+
+				//p = r + beta * (p - omega * v)
+				T const beta = (rhoNext / rho) * (alpha / omega);
+				rho = rhoNext;
+				axpy(-omega, mV, mP);
+				scal(beta, mP);
+				axpy(T(1), mR, mP);
+
+				M(mP, mPHat);
+				Kernel::applyOperator(A, mPHat, mV);
+				++statistics.operatorApplications;
+				T const rHatV = dot(mRHat, mV);
+				if (rHatV == T(0))
+				{
+					statistics.status = SolverStatus::Breakdown;
+					return statistics;
+				}
+				alpha = rho / rHatV;
+
+				//s = r - alpha * v; stop early if it is small enough already
+				Kernel::copyVector(mR, mS);
+				axpy(-alpha, mV, mS);
+				++statistics.iterations;
+				T const sNorm = nrm2(mS);
+				if (sNorm <= target)
+				{
+					axpy(alpha, mPHat, x);
+					Kernel::recordResidual(statistics, mSettings, sNorm);
+					statistics.status = SolverStatus::Converged;
+					return statistics;
+				}
+
+				M(mS, mSHat);
+				Kernel::applyOperator(A, mSHat, mT);
+				++statistics.operatorApplications;
+				T const tt = dot(mT, mT);
+				if (tt == T(0))
+				{
+					statistics.status = SolverStatus::Breakdown;
+					return statistics;
+				}
+				omega = dot(mT, mS) / tt;
+				axpy(alpha, mPHat, x);
+				axpy(omega, mSHat, x);
+
+				//r = s - omega * t
+				Kernel::copyVector(mS, mR);
+				axpy(-omega, mT, mR);
+				Kernel::recordResidual(statistics, mSettings, nrm2(mR));
+				if (statistics.residualNorm <= target)
+				{
+					statistics.status = SolverStatus::Converged;
+					return statistics;
+				}
+				if (omega == T(0))
+				{
+					statistics.status = SolverStatus::Breakdown;
+					return statistics;
+				}
+			}
+			statistics.status = SolverStatus::MaxIterations;
+			return statistics;
+		}
+
+
+	private:
+		void prepare(VectorSize n)
+		{
+			Kernel::prepareVector(mR, n);
+			Kernel::prepareVector(mRHat, n);
+			Kernel::prepareVector(mP, n);
+			Kernel::prepareVector(mV, n);
+			Kernel::prepareVector(mPHat, n);
+			Kernel::prepareVector(mS, n);
+			Kernel::prepareVector(mSHat, n);
+			Kernel::prepareVector(mT, n);
+		}
+	};
+
+
+
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template GMRES, which solves A * x = b for general non-singular A with restarted GMRES(m) (right preconditioning)
+	//The residual is minimized over a Krylov subspace of dimension up to m = SolverSettings::restart (modified Gram-Schmidt,
+	//Givens rotations), then the solver restarts from the new x. Right preconditioning keeps the minimized residual the true one;
+	//at every restart it is recomputed from b - A * x. Workspace: m + 3 vectors and the small (m + 1) x m Hessenberg matrix
+	template <typename T> class GMRES
+	{
+	private:
+		SolverSettings<T> mSettings;
+		std::vector<Vector<T>> mBasis; //m + 1 orthonormal vectors
+		Vector<T> mW; //Preconditioned basis vector
+		Vector<T> mUpdate; //Correction of x at the end of a cycle
+		std::vector<T> mHessenberg; //(m + 1) x m, column j at j * (m + 1)
+		std::vector<T> mCos;
+		std::vector<T> mSin;
+		std::vector<T> mG; //Rotated right-hand side of the least squares problem
+
+	public:
+		//Constructor that allocates the workspace for systems of size size (solve reallocates for other sizes or restart values)
+		explicit GMRES(VectorSize size = 0, SolverSettings<T> const & settings = SolverSettings<T>())
+			: mSettings(settings), mBasis(), mW(size), mUpdate(size), mHessenberg(), mCos(), mSin(), mG()
+		{
+			this->prepare(size);
+		}
+
+
+		//Destructor and all other constructors stay default!
+
+
+	public:
+		SolverSettings<T> const & getSettings() const
+		{
+			return mSettings;
+		}
+
+		void setSettings(SolverSettings<T> const & settings)
+		{
+			mSettings = settings;
+		}
+
+
+		//Solves A * x = b without preconditioning, starting from x if it has the size of b
+		template <typename Op> SolverStatistics<T> solve(Op const & A, Vector<T> const & b, Vector<T> & x)
+		{
+			return this->solve(A, b, x, IdentityPreconditioner<T>());
+		}
+
+
+		//Solves A * x = b with the preconditioner M, starting from x if it has the size of b
+		template <typename Op, typename Preconditioner> SolverStatistics<T> solve(Op const & A, Vector<T> const & b, Vector<T> & x, Preconditioner const & M)
+		{
+			MATRIX_PROFILE("GMRES::solve", 0.0, b.getSize(), 1u);
+			SolverStatistics<T> statistics;
+			T const target = Kernel::startSolve(A, b, x, mSettings, statistics, "GMRES<T>::solve(A, b, x, M)");
+			if (target < T(0))
+			{
+				return statistics;
+			}
+			this->prepare(b.getSize());
+			std::size_t const m = mBasis.size() - 1;
+
+			bool first = true;
+			while (true)
+			{
+				//Every cycle starts from the true residual, normalized into the first basis vector
+				Kernel::residual(A, b, x, mBasis[0]);
+				++statistics.operatorApplications;
+				T const beta = nrm2(mBasis[0]);
+				statistics.residualNorm = beta;
+				if (first)
+				{
+					statistics.initialResidualNorm = beta;
+					Kernel::recordResidual(statistics, mSettings, beta);
+					first = false;
+				}
+				if (beta <= target)
+				{
+					statistics.status = SolverStatus::Converged;
+					return statistics;
+				}
+				if (statistics.iterations >= mSettings.maxIterations)
+				{
+					statistics.status = SolverStatus::MaxIterations;
+					return statistics;
+				}
+				scal(T(1) / beta, mBasis[0]);
+				std::fill(mG.begin(), mG.end(), T(0));
+				mG[0] = beta;
+
+				std::size_t k = 0;
+				bool breakdown = false;
+				while ((k < m) && (statistics.iterations < mSettings.maxIterations))
+				{
+					std::size_t const j = k;
+					T* h = mHessenberg.data() + j * (m + 1);
+					M(mBasis[j], mW);
+					Kernel::applyOperator(A, mW, mBasis[j + 1]);
+					++statistics.operatorApplications;
+					for (std::size_t i = 0; i <= j; ++i)
+					{
+						h[i] = dot(mBasis[j + 1], mBasis[i]);
+						axpy(-h[i], mBasis[i], mBasis[j + 1]);
+					}
+					h[j + 1] = nrm2(mBasis[j + 1]);
+
+					//Bring the new column into upper triangular form
+					for (std::size_t i = 0; i < j; ++i)
+					{
+						T const upper = mCos[i] * h[i] + mSin[i] * h[i + 1];
+						h[i + 1] = -mSin[i] * h[i] + mCos[i] * h[i + 1];
+						h[i] = upper;
+					}
+					T const radius = std::hypot(h[j], h[j + 1]);
+					if (radius == T(0))
+					{
+						breakdown = true;
+						break;
+					}
+					mCos[j] = h[j] / radius;
+					mSin[j] = h[j + 1] / radius;
+					T const subdiagonal = h[j + 1];
+					h[j] = radius;
+					h[j + 1] = T(0);
+					mG[j + 1] = -mSin[j] * mG[j];
+					mG[j] = mCos[j] * mG[j];
+
+					++k;
+					++statistics.iterations;
+					Kernel::recordResidual(statistics, mSettings, std::abs(mG[j + 1]));
+					//A zero subdiagonal means the subspace contains the solution (lucky breakdown)
+					if ((statistics.residualNorm <= target) || (subdiagonal == T(0)))
+					{
+						break;
+					}
+					scal(T(1) / subdiagonal, mBasis[j + 1]);
+				}
+
+				this->updateSolution(k, x, M);
+				if (breakdown)
+				{
+					statistics.status = SolverStatus::Breakdown;
+					return statistics;
+				}
+			}
+		}
+
+
+	private:
+		void prepare(VectorSize n)
+		{
+			std::size_t const m = std::max(1u, mSettings.restart);
+			if (mBasis.size() != m + 1)
+			{
+				mBasis.resize(m + 1);
+				mHessenberg.assign((m + 1) * m, T(0));
+				mCos.assign(m, T(0));
+				mSin.assign(m, T(0));
+				mG.assign(m + 1, T(0));
+			}
+			for (Vector<T> & v : mBasis)
+			{
+				Kernel::prepareVector(v, n);
+			}
+			Kernel::prepareVector(mW, n);
+			Kernel::prepareVector(mUpdate, n);
+		}
+
+
+		//Solves the k x k triangular system H * y = g (y overwrites g) and adds M^-1 * (basis * y) to x
+		template <typename Preconditioner> void updateSolution(std::size_t k, Vector<T> & x, Preconditioner const & M)
+		{
+			if (k == 0)
+			{
+				return;
+			}
+			std::size_t const ld = mBasis.size();
+			for (std::size_t i = k; i-- > 0;)
+			{
+				T sum = mG[i];
+				for (std::size_t c = i + 1; c < k; ++c)
+				{
+					sum -= mHessenberg[c * ld + i] * mG[c];
+				}
+				mG[i] = sum / mHessenberg[i * ld + i];
+			}
+			mUpdate.fillWith(T(0));
+			for (std::size_t i = 0; i < k; ++i)
+			{
+				axpy(mG[i], mBasis[i], mUpdate);
+			}
+			M(mUpdate, mW);
+			axpy(T(1), mW, x);
+		}
+	};
+
+
+
+} //Namespace: Mat
+
+#endif //KRYLOV_HPP
@@ -0,0 +1,330 @@
+#ifndef LU_HPP
+#define LU_HPP
+
+#include <cstddef>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "Gemm.hpp"
+#include "ThreadPool.hpp"
+#include "Matrix.hpp"
+
+
+
+namespace Mat
+{
+	namespace Kernel
+	{
+
+		//Number of columns factorized as one panel before the trailing matrix is updated by the GEMM kernel
+		const std::size_t LUBlockSize = 64;
+
+		//Solves with at least this many right-hand side entries are split over the thread pool (by columns)
+		const std::size_t LUSolveParallelThreshold = 1 << 16;
+
+
+		//Factorizes the n x n block A (row pitch ld) in place into P * A = L * U with partial pivoting
+		//L (unit diagonal, not stored) ends up below the diagonal and U on and above it. Row i was swapped with row pivots[i].
+		//Returns false if a pivot was exactly zero (the factorization is completed anyway)
+		template <typename T> bool luFactorize(std::size_t n, T* A, std::size_t ld, unsigned int* pivots)
+		{
+			bool regular = true;
+			for (std::size_t k0 = 0; k0 < n; k0 += LUBlockSize)
+			{
+				std::size_t const kb = std::min(LUBlockSize, n - k0);
+				std::size_t const k1 = k0 + kb;
+
+				//Unblocked factorization of the panel (columns k0 .. k1 - 1, all rows below k0)
+				for (std::size_t j = k0; j < k1; ++j)
+				{
+					std::size_t p = j;
+					for (std::size_t i = j + 1; i < n; ++i)
+					{
+						if (std::abs(A[i * ld + j]) > std::abs(A[p * ld + j]))
+						{
+							p = i;
+						}
+					}
+					pivots[j] = static_cast<unsigned int>(p);
+					if (p != j)
+					{
+						std::swap_ranges(A + j * ld, A + j * ld + n, A + p * ld);
+					}
+
+					T const pivot = A[j * ld + j];
+					if (pivot == T(0))
+					{
+						regular = false;
+						continue;
+					}
+					T const * pivotRow = A + j * ld;
+					for (std::size_t i = j + 1; i < n; ++i)
+					{
+						T* row = A + i * ld;
+						T const l = row[j] / pivot;
+						row[j] = l;
+						for (std::size_t c = j + 1; c < k1; ++c)
+						{
+							row[c] -= l * pivotRow[c];
+						}
+					}
+				}
+
+				if (k1 == n)
+				{
+					break;
+				}
+
+				//U12 = L11^-1 * A12 (forward substitution on the rows of the panel, right of it)
+				for (std::size_t i = k0 + 1; i < k1; ++i)
+				{
+					T* row = A + i * ld;
+					for (std::size_t p = k0; p < i; ++p)
+					{
+						T const l = row[p];
+						T const * uRow = A + p * ld;
+						for (std::size_t c = k1; c < n; ++c)
+						{
+							row[c] -= l * uRow[c];
+						}
+					}
+				}
+
+				//A22 -= L21 * U12, where almost all of the work happens
+				std::size_t const rest = n - k1;
+				gemm<T>(rest, rest, kb, T(-1), A + k1 * ld + k0, ld, 1, A + k0 * ld + k1, ld, 1, T(1), A + k1 * ld + k1, ld);
+			}
+			return regular;
+		}
+
+
+		//Solves A * X = B in place for the n x cols block X (row pitch ldx), using the factors and pivots of luFactorize
+		//All operations run along rows of X, so every column is solved independently and in the same order
+		template <typename T> void luSolve(std::size_t n, T const * LU, std::size_t ld, unsigned int const * pivots, std::size_t cols, T* X, std::size_t ldx)
+		{
+			auto columnRange = [&](std::size_t c0, std::size_t c1)
+			{
+				//X = P * B
+				for (std::size_t i = 0; i < n; ++i)
+				{
+					if (pivots[i] != i)
+					{
+						std::swap_ranges(X + i * ldx + c0, X + i * ldx + c1, X + pivots[i] * ldx + c0);
+					}
+				}
+
+				//X = L^-1 * X
+				for (std::size_t i = 1; i < n; ++i)
+				{
+					T* row = X + i * ldx;
+					T const * lRow = LU + i * ld;
+					for (std::size_t p = 0; p < i; ++p)
+					{
+						T const l = lRow[p];
+						T const * xRow = X + p * ldx;
+						for (std::size_t c = c0; c < c1; ++c)
+						{
+							row[c] -= l * xRow[c];
+						}
+					}
+				}
+
+				//X = U^-1 * X
+				for (std::size_t i = n; i-- > 0;)
+				{
+					T* row = X + i * ldx;
+					T const * uRow = LU + i * ld;
+					for (std::size_t p = i + 1; p < n; ++p)
+					{
+						T const u = uRow[p];
+						T const * xRow = X + p * ldx;
+						for (std::size_t c = c0; c < c1; ++c)
+						{
+							row[c] -= u * xRow[c];
+						}
+					}
+					T const diagonal = uRow[i];
+					for (std::size_t c = c0; c < c1; ++c)
+					{
+						row[c] /= diagonal;
+					}
+				}
+			};
+
+			ThreadPool& pool = ThreadPool::instance();
+			if ((n * cols < LUSolveParallelThreshold) || (cols < 2) || (pool.getThreadCount() == 1))
+			{
+				columnRange(0, cols);
+			}
+			else
+			{
+				std::size_t grainSize = std::max<std::size_t>(16, cols / (4 * static_cast<std::size_t>(pool.getThreadCount())));
+				pool.parallelFor(0, cols, grainSize, columnRange);
+			}
+		}
+
+
+	} //Namespace: Kernel
+
+
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template LU, which holds the LU factorization P * A = L * U of a square matrix with partial pivoting
+	//Factorize once, then reuse it for det, solve (with one or many right-hand sides) and inverse.
+	//T should be a floating point type; integer matrices are factorized as LU<double>(Matrix<double>(m))
+	template <typename T> class LU
+	{
+	private:
+		Matrix<T> mFactors; //L below the diagonal (unit diagonal not stored), U on and above it
+		std::vector<unsigned int> mPivots; //Row i was swapped with row mPivots[i] (in this order)
+		bool mSingular;
+		bool mOddPermutation;
+
+	public:
+		//Constructor that factorizes a copy of matrix
+		explicit LU(Matrix<T> const & matrix)
+			: LU(Matrix<T>(matrix))
+		{}
+
+
+		//Constructor that factorizes matrix in its own storage, without copying
+		explicit LU(Matrix<T> && matrix)
+			: mFactors(std::move(matrix)), mPivots(), mSingular(false), mOddPermutation(false)
+		{
+			if (mFactors.getSize().x() != mFactors.getSize().y())
+			{
+				throw IncompatibleMatrixSizesException("LU<T>::LU(Matrix<T> && matrix): matrix is not square!", mFactors.getSize(), mFactors.getSize());
+			}
+			mPivots.resize(mFactors.getSize().x());
+			mSingular = !Kernel::luFactorize<T>(mFactors.getSize().x(), mFactors.data(), mFactors.getStride(), mPivots.data());
+			for (unsigned int i = 0; i < mPivots.size(); ++i)
+			{
+				if (mPivots[i] != i)
+				{
+					mOddPermutation = !mOddPermutation;
+				}
+			}
+		}
+
+
+		//Destructor and all other constructors stay default!
+
+
+	public:
+		//Returns the size of the factorized matrix
+		MatrixSize getSize() const
+		{
+			return mFactors.getSize();
+		}
+
+
+		//Returns whether a pivot was exactly zero (det is 0 then, and solve and inverse throw)
+		bool isSingular() const
+		{
+			return mSingular;
+		}
+
+
+		//Returns L and U packed into one matrix (L below the diagonal with implicit unit diagonal, U on and above it)
+		Matrix<T> const & getFactors() const
+		{
+			return mFactors;
+		}
+
+
+		//Returns the row swaps: row i was swapped with row getPivots()[i], for i = 0, 1, ...
+		std::vector<unsigned int> const & getPivots() const
+		{
+			return mPivots;
+		}
+
+
+		//Calculates the determinant as the signed product of the pivots (0x0 matrices yield 1)
+		T det() const
+		{
+			T det = T(1);
+			for (unsigned int i = 0; i < mFactors.getSize().x(); ++i)
+			{
+				det *= mFactors.evaluateAt(i, i);
+			}
+			return mOddPermutation ? -det : det;
+		}
+
+
+		//Solves A * x = b
+		Vector<T> solve(Vector<T> const & b) const
+		{
+			if (b.getSize() != mFactors.getSize().y())
+			{
+				throw IncompatibleMatrixSizesException("LU<T>::solve(Vector<T> const & b) const: b's size does not match the matrix!", mFactors.getSize(), XY(1, b.getSize()));
+			}
+			this->throwIfSingular("LU<T>::solve(Vector<T> const & b) const: matrix is singular!");
+			Vector<T> x(b);
+			Kernel::luSolve<T>(mFactors.getSize().x(), mFactors.data(), mFactors.getStride(), mPivots.data(), 1, x.data(), 1);
+			return x;
+		}
+
+
+		//Solves A * X = B for all columns of B at once
+		Matrix<T> solve(Matrix<T> const & B) const
+		{
+			if (B.getSize().m() != mFactors.getSize().y())
+			{
+				throw IncompatibleMatrixSizesException("LU<T>::solve(Matrix<T> const & B) const: B's number of rows does not match the matrix!", mFactors.getSize(), B.getSize());
+			}
+			this->throwIfSingular("LU<T>::solve(Matrix<T> const & B) const: matrix is singular!");
+			Matrix<T> X(B);
+			Kernel::luSolve<T>(mFactors.getSize().x(), mFactors.data(), mFactors.getStride(), mPivots.data(), X.getSize().x(), X.data(), X.getStride());
+			return X;
+		}
+
+
+		//Calculates the inverse matrix (prefer solve, which is cheaper and more accurate than multiplying with the inverse)
+		Matrix<T> inverse() const
+		{
+			this->throwIfSingular("LU<T>::inverse() const: matrix is singular!");
+			Matrix<T> identity(mFactors.getSize(), T(0));
+			identity.getDiagonalView().fillWith(T(1));
+			return this->solve(identity);
+		}
+
+
+	private:
+		void throwIfSingular(std::string const & message) const
+		{
+			if (mSingular)
+			{
+				throw SingularMatrixException(message);
+			}
+		}
+
+
+	}; //Class Template: LU
+
+
+
+	//Calculates determinant
+	template <typename T> double Matrix<T>::det() const
+	{
+		//Non-quadratic matrices yield 0
+		if (mSize.x() != mSize.y())
+		{
+			return 0.0;
+		}
+
+		//0x0 matrices yield 0
+		if (mSize.x() == 0)
+		{
+			return 0.0;
+		}
+
+		MATRIX_PROFILE("Matrix::det", 2.0 / 3.0 * mSize.x() * mSize.x() * mSize.x(), mSize.x(), mSize.y());
+		return LU<double>(Matrix<double>(*this)).det();
+	}
+
+
+
+} //Namespace: Mat
+
+#endif //LU_HPP
@@ -154,5 +154,19 @@ namespace Mat
 
 
 
+
+	///////////////////////////////
+	//Class SingularMatrixException
+
+	SingularMatrixException::SingularMatrixException(std::string const & _message)
+		: message(_message)
+	{}
+
+
+
+
+
+
+
 } //Namespace: Mat
 
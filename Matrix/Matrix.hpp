@@ -2,13 +2,27 @@
 #define MATRIX_HPP
 
 
+#include <cstdint>
 #include <iostream>
 #include <vector>
 #include <list>
 #include <cmath>
 #include <algorithm>
 #include <functional>
-
+#include <type_traits>
+#include <utility>
+
+#include "AlignedAllocator.hpp"
+#include "Algorithm.hpp"
+#include "Expression.hpp"
+#include "Find.hpp"
+#include "Gemm.hpp"
+#include "Gemv.hpp"
+#include "Profiler.hpp"
+#include "Simd.hpp"
+#include "Strassen.hpp"
+#include "StridedIterator.hpp"
+#include "Transpose.hpp"
 #include "Vector.hpp"
 
 
@@ -113,26 +127,204 @@ namespace Mat
 	};
 
 
+	/////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Struct SingularMatrixException, which can be thrown if an operation needs a non-singular matrix
+	struct SingularMatrixException
+	{
+		std::string message;
+		SingularMatrixException(std::string const & _message);
+	};
+
+
+
+	template <typename T, unsigned int M = Dynamic, unsigned int N = Dynamic> class Matrix;
+	template <typename T> class MatrixView;
+	template <typename T> class LU;
+
+	//Matrices are referenced, not copied, by the expressions they take part in
+	template <typename T> struct ExpressionOperand<Matrix<T>>
+	{
+		typedef Matrix<T> const & Type;
+	};
+
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template MatrixExpression, CRTP base of Matrix and of all lazily evaluated matrix expressions
+	//Every E provides the typedef ValueType, MatrixSize getSize() const, ValueType evaluateAt(unsigned int x, unsigned int y) const and
+	//bool mayAlias(ValueType const * data, unsigned int stride, MatrixSize const & size) const, which tells whether writing the
+	//block of size size at data (row pitch stride) while evaluating could change entries the expression still has to read
+	template <typename E> class MatrixExpression
+	{
+	public:
+		E const & self() const
+		{
+			return static_cast<E const &>(*this);
+		}
+	};
+
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template MatrixBinaryExpression, which represents Op(left, right) for every entry
+	template <typename L, typename R, typename Op> class MatrixBinaryExpression : public MatrixExpression<MatrixBinaryExpression<L, R, Op>>
+	{
+	public:
+		typedef typename L::ValueType ValueType;
+		static_assert(std::is_same<ValueType, typename R::ValueType>::value, "MatrixBinaryExpression: operands have different value types!");
+
+	private:
+		typename ExpressionOperand<L>::Type mLeft;
+		typename ExpressionOperand<R>::Type mRight;
+
+	public:
+		MatrixBinaryExpression(L const & left, R const & right)
+			: mLeft(left), mRight(right)
+		{}
+
+		MatrixSize getSize() const
+		{
+			return mLeft.getSize();
+		}
+
+		ValueType evaluateAt(unsigned int x, unsigned int y) const
+		{
+			return Op::apply(mLeft.evaluateAt(x, y), mRight.evaluateAt(x, y));
+		}
+
+		bool mayAlias(ValueType const * data, unsigned int stride, MatrixSize const & size) const
+		{
+			return mLeft.mayAlias(data, stride, size) || mRight.mayAlias(data, stride, size);
+		}
+
+		L const & left() const
+		{
+			return mLeft;
+		}
+
+		R const & right() const
+		{
+			return mRight;
+		}
+	};
+
+
+	///////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template MatrixScalarExpression, which represents Op(operand, scalar) for every entry
+	template <typename E, typename Op> class MatrixScalarExpression : public MatrixExpression<MatrixScalarExpression<E, Op>>
+	{
+	public:
+		typedef typename E::ValueType ValueType;
+
+	private:
+		typename ExpressionOperand<E>::Type mOperand;
+		ValueType mScalar;
+
+	public:
+		MatrixScalarExpression(E const & operand, ValueType const & scalar)
+			: mOperand(operand), mScalar(scalar)
+		{}
+
+		MatrixSize getSize() const
+		{
+			return mOperand.getSize();
+		}
+
+		ValueType evaluateAt(unsigned int x, unsigned int y) const
+		{
+			return Op::apply(mOperand.evaluateAt(x, y), mScalar);
+		}
+
+		bool mayAlias(ValueType const * data, unsigned int stride, MatrixSize const & size) const
+		{
+			return mOperand.mayAlias(data, stride, size);
+		}
+
+		E const & operand() const
+		{
+			return mOperand;
+		}
+
+		ValueType const & scalar() const
+		{
+			return mScalar;
+		}
+	};
+
+
+	//////////////////////////////////////////////////////////////////////////////////
+	//Class Template MatrixUnaryExpression, which represents Op(operand) for every entry
+	template <typename E, typename Op> class MatrixUnaryExpression : public MatrixExpression<MatrixUnaryExpression<E, Op>>
+	{
+	public:
+		typedef typename E::ValueType ValueType;
+
+	private:
+		typename ExpressionOperand<E>::Type mOperand;
+
+	public:
+		explicit MatrixUnaryExpression(E const & operand)
+			: mOperand(operand)
+		{}
+
+		MatrixSize getSize() const
+		{
+			return mOperand.getSize();
+		}
+
+		ValueType evaluateAt(unsigned int x, unsigned int y) const
+		{
+			return Op::apply(mOperand.evaluateAt(x, y));
+		}
+
+		bool mayAlias(ValueType const * data, unsigned int stride, MatrixSize const & size) const
+		{
+			return mOperand.mayAlias(data, stride, size);
+		}
+
+		E const & operand() const
+		{
+			return mOperand;
+		}
+	};
+
+
 
-	///////////////////////
-	//Class Template Matrix
-	template <typename T> class Matrix
+	////////////////////////////////////////////////////////////
+	//Class Template Matrix (dynamically sized, heap allocated)
+	template <typename T> class Matrix<T, Dynamic, Dynamic> : public MatrixExpression<Matrix<T>>
 	{
+	public:
+		typedef T ValueType;
+		typedef std::vector<T, AlignedAllocator<T>> Buffer;
+		typedef T* iterator; //Runs over all entries in row-major order
+		typedef T const * const_iterator;
+		typedef T* row_iterator;
+		typedef T const * const_row_iterator;
+		typedef StridedIterator<T> column_iterator;
+		typedef StridedIterator<T const> const_column_iterator;
+
 	private:
 		MatrixSize mSize;
-		std::vector<std::vector<T>> mVecOfRows;
+		unsigned int mStride; //Leading dimension: distance (in elements) between the starts of two consecutive rows
+		Buffer mData; //Contiguous row-major storage, entry (x, y) lives at mData[y * mStride + x]
 
 	public:
 		//Standard constructor constructs 0x0 matrix
 		Matrix()
-			: mSize(XY(0u, 0u)), mVecOfRows()
+			: mSize(XY(0u, 0u)), mStride(0u), mData()
 		{
 		}
 
 
 		//Constructor that constructs matrix of size (sizeX, sizeY) with value
 		explicit Matrix(MatrixSize const & size, T const & value = T())
-			: mSize(size), mVecOfRows(size.y(), std::vector<T>(size.x(), value))
+			: mSize(size), mStride(size.x()), mData(static_cast<std::size_t>(size.x()) * size.y(), value)
+		{
+		}
+
+
+		//Constructor that constructs matrix of size (sizeX, sizeY) with value, allocated from resource instead of the default resource
+		Matrix(MatrixSize const & size, T const & value, MemoryResource* resource)
+			: mSize(size), mStride(size.x()), mData(static_cast<std::size_t>(size.x()) * size.y(), value, AlignedAllocator<T>(resource))
 		{
 		}
 
@@ -147,8 +339,7 @@ namespace Mat
 			//If correctSize, construct matrix; else, throw exception
 			if (correctSize)
 			{
-				this->mVecOfRows = vecOfRows;
-				this->mSize = size;
+				this->assignFromVecOfRows(vecOfRows, size);
 			}
 			else
 			{
@@ -167,8 +358,7 @@ namespace Mat
 			//If correctSize, construct matrix; else, throw exception
 			if (correctSize)
 			{
-				this->mVecOfRows = std::move(vecOfRows);
-				this->mSize = size;
+				this->assignFromVecOfRows(vecOfRows, size);
 			}
 			else
 			{
@@ -182,7 +372,12 @@ namespace Mat
 			: Matrix()
 		{
 			mSize = XY(vec.size(), number);
-			mVecOfRows = std::vector<std::vector<T>>(number, vec);
+			mStride = mSize.x();
+			mData.resize(static_cast<std::size_t>(mSize.x()) * mSize.y());
+			for (unsigned int y = 0; y < number; ++y)
+			{
+				std::copy(vec.begin(), vec.end(), this->rowPtr(y));
+			}
 			if (!asRows)
 			{
 				this->transpose();
@@ -190,6 +385,43 @@ namespace Mat
 		}
 
 
+		//Constructor that copies a fixed-size matrix
+		template <unsigned int M, unsigned int N> explicit Matrix(Matrix<T, M, N> const & matrix)
+			: Matrix(matrix.getSize())
+		{
+			std::copy(matrix.data(), matrix.data() + static_cast<std::size_t>(M) * N, mData.data());
+		}
+
+
+		//Constructor that evaluates a matrix expression in a single fused loop
+		template <typename E, typename = typename std::enable_if<std::is_same<typename E::ValueType, T>::value>::type>
+		Matrix(MatrixExpression<E> const & expression)
+			: mSize(expression.self().getSize()), mStride(mSize.x()), mData()
+		{
+			//The buffer is allocated inside the span, so the span accounts for it
+			MATRIX_PROFILE("Matrix::Matrix(expression)", static_cast<double>(this->getNumberOfEntries()), mSize.x(), mSize.y());
+			mData.resize(static_cast<std::size_t>(mSize.x()) * mSize.y());
+			evaluateMatrixExpression(mData.data(), mStride, expression.self());
+		}
+
+
+		//Evaluates a matrix expression into this matrix in a single fused loop
+		//This itself may appear in the expression; expressions reading overlapping views of this are evaluated into a temporary first
+		template <typename E> typename std::enable_if<std::is_same<typename E::ValueType, T>::value, Matrix<T>&>::type
+		operator=(MatrixExpression<E> const & expression)
+		{
+			MATRIX_PROFILE("Matrix::operator=(expression)", static_cast<double>(expression.self().getSize().x()) * expression.self().getSize().y(), expression.self().getSize().x(), expression.self().getSize().y());
+			if ((expression.self().getSize() != this->getSize()) || expression.self().mayAlias(mData.data(), mStride, mSize))
+			{
+				Matrix<T> result(expression);
+				this->swap(result);
+				return *this;
+			}
+			evaluateMatrixExpression(mData.data(), mStride, expression.self());
+			return *this;
+		}
+
+
 		//Destructor and all other constructors stay default!
 
 
@@ -201,282 +433,623 @@ namespace Mat
 		}
 
 
-		//Gives access to the components
-		T& at(MatrixEntry const & pos)
+		//Returns the number of entries (x * y)
+		std::size_t getNumberOfEntries() const
 		{
-			if ((pos.x() >= mSize.x()) || (pos.y() >= mSize.y()))
-			{
-				throw InvalidIndicesException("T& at(MatrixEntry const & pos): pos is out of range!", pos);
-			}
-			return mVecOfRows.at(pos.y()).at(pos.x());
+			return static_cast<std::size_t>(mSize.x()) * mSize.y();
 		}
 
 
-		//Gives constant access to the components
-		T const & at(MatrixEntry const & pos) const
+		//Returns the memory resource the storage was allocated from
+		MemoryResource* getMemoryResource() const
 		{
-			if ((pos.x() >= mSize.x()) || (pos.y() >= mSize.y()))
-			{
-				throw InvalidIndicesException("T& at(MatrixEntry const & pos): pos is out of range!", pos);
-			}
-			return mVecOfRows.at(pos.y()).at(pos.x());
+			return mData.get_allocator().getResource();
 		}
 
 
-		//Constructor that constructs matrix from matrix of other type
-		template <typename S> explicit Matrix(Matrix<S> const & other)
-			: Matrix(other.getSize())
+		//Swaps size and storage with other
+		void swap(Matrix<T> & other)
 		{
-			for (unsigned int x = 0; x < mSize.x(); ++x)
-			{
-				for (unsigned int y = 0; y < mSize.y(); ++y)
-				{
-					mVecOfRows.at(y).at(x) = static_cast<T>(other.at(XY(x, y)));
-				}
-			}
+			mSize.swap(other.mSize);
+			std::swap(mStride, other.mStride);
+			mData.swap(other.mData);
 		}
 
 
-		//Calculates trace
-		T trace() const
+		//Returns the entry at (x, y) without bounds check (used by the expression evaluation)
+		T const & evaluateAt(unsigned int x, unsigned int y) const
 		{
-			T sum = T(0);
-			for (unsigned int i = 0; i < std::min(mSize.x(), mSize.y()); ++i)
-			{
-				sum += this->at(XY(i, i));
-			}
-			return sum;
+			return mData[static_cast<std::size_t>(y) * mStride + x];
 		}
 
 
-		//Swaps two rows
-		void swapRows(unsigned int r1, unsigned int r2)
+		//Returns the leading dimension of the underlying buffer (distance between two rows in elements)
+		unsigned int getStride() const
 		{
-			if (r1 >= mSize.y())
-			{
-				throw InvalidIndicesException("Matrix<T>::swapRows(unsigned int r1, unsigned int r2): r1 is no valid y index!", XY(0, r1));
-			}
-			if (r2 >= mSize.y())
-			{
-				throw InvalidIndicesException("Matrix<T>::swapRows(unsigned int r1, unsigned int r2): r2 is no valid y index!", XY(0, r1));
-			}
-			std::vector<T> row1 = mVecOfRows.at(r1);
-			mVecOfRows.at(r1) = mVecOfRows.at(r2);
-			mVecOfRows.at(r2) = row1;
+			return mStride;
 		}
 
 
-		//Multiplies one row by a factor
-		void multiplyRowBy(unsigned int row, T factor)
+		//Gives direct access to the contiguous row-major buffer
+		T* data()
 		{
-			if (row >= mSize.y())
-			{
-				throw InvalidIndicesException("Matrix<T>::multiplyRowBy(unsigned int row, T factor): row is no valid y index!", XY(0, row));
-			}
-			std::vector<T>& rowVec = mVecOfRows.at(row);
-			for (auto & num : rowVec)
-			{
-				num *= factor;
-			}
+			return mData.data();
 		}
 
 
-		//Subtracts two rows and writes the result into the first row
-		void subtractRows(unsigned int minuendRow, unsigned int subtrahendRow)
+		//Gives direct constant access to the contiguous row-major buffer
+		T const * data() const
 		{
-			if (minuendRow >= mSize.y())
-			{
-				throw InvalidIndicesException("Matrix<T>::subtractRows(unsigned int minuendRow, unsigned int subtrahendRow): minuendRow is no valid y index!", XY(0, minuendRow));
-			}
-			if (subtrahendRow >= mSize.y())
-			{
-				throw InvalidIndicesException("Matrix<T>::subtractRows(unsigned int minuendRow, unsigned int subtrahendRow): subtrahendRow is no valid y index!", XY(0, subtrahendRow));
-			}
-			std::vector<T>& row1 = mVecOfRows.at(minuendRow);
-			std::vector<T> const & row2 = mVecOfRows.at(subtrahendRow);
-			for (unsigned int x = 0; x < mSize.x(); ++x)
-			{
-				row1.at(x) -= row2.at(x);
-			}
+			return mData.data();
 		}
 
 
-		//Returns the matrix in row echelon form
-		Matrix<double> getRowEchelonForm(double& productOfGaussFactors) const
+		//Returns whether writing the block of size size at data (row pitch stride) could change this before it is read
+		bool mayAlias(T const * data, unsigned int stride, MatrixSize const & size) const
 		{
-			productOfGaussFactors = 1.0;
-			Matrix<double> matrix(*this);
-			for (unsigned int x = 0; x < mSize.x(); ++x)
-			{
-				//Sort zeros to the back
-				for (unsigned int y = x; y < mSize.y(); ++y)
-				{
-					if (matrix.at(XY(x, y)) == 0.0)
-					{
-						for (unsigned int n = y + 1; n < mSize.y(); ++n)
-						{
-							if (matrix.at(XY(x, n)) != 0.0)
-							{
-								matrix.swapRows(y, n);
-								productOfGaussFactors *= -1.0;
-								break;
-							}
-						}
-					}
-				}
-
-				//If first entry in column is not zero, multiply all non zero rows with the correct factor, so that they all have the same entry and then subtract first row from it
-				if (matrix.at(XY(x, x)) != 0.0)
-				{
-					for (unsigned int y = x + 1; y < mSize.y(); ++y)
-					{
-						if (matrix.at(XY(x, y)) != 0.0)
-						{
-							double multiplicator = matrix.at(XY(x, x)) / matrix.at(XY(x, y));
-							matrix.multiplyRowBy(y, multiplicator);
-							matrix.subtractRows(y, x); //Minuend - Subtrahend
-							productOfGaussFactors *= multiplicator;
-						}
-					}
-				}
-			}
-			return matrix;
+			return this->getView().mayAlias(data, stride, size);
 		}
 
 
-		//Calculates determinant
-		double det() const
+		//Returns a view of the whole matrix (views stay valid until the matrix is resized, reassigned with another size or destroyed)
+		MatrixView<T> getView()
 		{
-			//Non-quadratic matrices yield 0
-			if (mSize.x() != mSize.y())
-			{
-				return 0.0;
-			}
+			return MatrixView<T>(mData.data(), mSize, mStride);
+		}
 
-			//0x0 matrices yield 0
-			if (mSize.x() == 0)
-			{
-				return 0.0;
-			}
 
-			//Calculate determinant from row echelon form
-			double productOfGaussianFactors;
-			Matrix<double> rowEchelonForm = this->getRowEchelonForm(productOfGaussianFactors);
-			double det = 1.0;
-			for (unsigned int x = 0; x < mSize.x(); ++x)
-			{
-				det *= rowEchelonForm.at(XY(x, x));
-			}
-			return det/productOfGaussianFactors;
+		//Returns a constant view of the whole matrix
+		MatrixView<T const> getView() const
+		{
+			return MatrixView<T const>(mData.data(), mSize, mStride);
 		}
 
 
-		//Finds all EntryPositions which have dist tolerance or less from val
-		std::list<MatrixEntry> find(T const & val, T const & tolerance = T(0)) const
+		//Returns a view of the submatrix beginning at origin with size size (clipped like getSubmatrix), without copying
+		MatrixView<T> getSubmatrixView(MatrixEntry const & origin, MatrixSize const & size)
 		{
-			std::list<MatrixEntry> list;
-			for (unsigned int x = 0; x < mSize.x(); ++x)
-			{
-				for (unsigned int y = 0; y < mSize.y(); ++y)
-				{
-					if (std::abs(this->at(XY(x, y)) - val) <= tolerance)
-					{
-						list.push_back(XY(x, y));
-					}
-				}
-			}
-			return list;
+			return this->getView().getSubmatrixView(origin, size);
 		}
 
 
-		//Returns submatrix beginning at origin with size size (Non overlapping parts will be cut out! Example: 2x2 matrix with origin=(1,1) and size=(1,1) yields 1x1 matrix!)
-		Matrix<T> getSubmatrix(MatrixEntry const & origin, MatrixSize const & size) const
+		//Returns a constant view of the submatrix beginning at origin with size size
+		MatrixView<T const> getSubmatrixView(MatrixEntry const & origin, MatrixSize const & size) const
 		{
-			//Determine full size without considering size
-			unsigned int fullSizeX = static_cast<unsigned int>(std::max(0, static_cast<int>(mSize.x()) - static_cast<int>(origin.x())));
-			unsigned int fullSizeY = static_cast<unsigned int>(std::max(0, static_cast<int>(mSize.y()) - static_cast<int>(origin.y())));
+			return this->getView().getSubmatrixView(origin, size);
+		}
 
-			//Take minimum of size and fullSize as real new size
-			MatrixSize newSize = XY(std::min(fullSizeX, size.x()), std::min(fullSizeY, size.y()));
 
-			//Create new matrix
-			Matrix<T> newMatrix(newSize);
-			for (unsigned int x = 0; x < newSize.x(); ++x)
-			{
-				for (unsigned int y = 0; y < newSize.y(); ++y)
-				{
-					newMatrix.at(XY(x, y)) = this->at(XY(origin.x() + x, origin.y() + y));
-				}
-			}
-			return newMatrix;
+		//Returns a view of row y
+		VectorView<T> getRowView(unsigned int y)
+		{
+			return this->getView().getRowView(y);
 		}
 
 
-		//Returns transposed matrix without changing this
-		Matrix<T> getTransposed() const
+		//Returns a constant view of row y
+		VectorView<T const> getRowView(unsigned int y) const
 		{
-			MatrixSize size(this->getSize());
-			size.flip();
-			Matrix<T> transposedMatrix(size);
-			for (unsigned int x = 0; x < transposedMatrix.getSize().x(); ++x)
-			{
-				for (unsigned int y = 0; y < transposedMatrix.getSize().y(); ++y)
-				{
-					transposedMatrix.at(XY(x, y)) = this->at(XY(y, x));
-				}
-			}
-			return transposedMatrix;
+			return this->getView().getRowView(y);
 		}
 
 
-		//Transposes this matrix
-		void transpose()
+		//Returns a view of column x
+		VectorView<T> getColumnView(unsigned int x)
 		{
-			*this = this->getTransposed();
+			return this->getView().getColumnView(x);
 		}
 
 
-		//Resizes the matrix (If entries are created, they are filled with fillValue)
-		void resize(MatrixSize size, T const & fillValue = T())
+		//Returns a constant view of column x
+		VectorView<T const> getColumnView(unsigned int x) const
 		{
-			this->mSize = size;
-			this->mVecOfRows.resize(size.y(), std::vector<T>(size.x(), fillValue));
-			for (auto & row : this->mVecOfRows)
+			return this->getView().getColumnView(x);
+		}
+
+
+		//Returns a view of the main diagonal
+		VectorView<T> getDiagonalView()
+		{
+			return this->getView().getDiagonalView();
+		}
+
+
+		//Returns a constant view of the main diagonal
+		VectorView<T const> getDiagonalView() const
+		{
+			return this->getView().getDiagonalView();
+		}
+
+
+		//Gives access to the components
+		T& at(MatrixEntry const & pos)
+		{
+			if ((pos.x() >= mSize.x()) || (pos.y() >= mSize.y()))
 			{
-				row.resize(size.x(), fillValue);
-				row.shrink_to_fit();
+				throw InvalidIndicesException("T& at(MatrixEntry const & pos): pos is out of range!", pos);
 			}
-			this->mVecOfRows.shrink_to_fit();
+			return mData[static_cast<std::size_t>(pos.y()) * mStride + pos.x()];
 		}
 
 
-		//Fills every entry of the matrix with value
-		void fillWith(T const & value)
+		//Gives constant access to the components
+		T const & at(MatrixEntry const & pos) const
+		{
+			if ((pos.x() >= mSize.x()) || (pos.y() >= mSize.y()))
+			{
+				throw InvalidIndicesException("T& at(MatrixEntry const & pos): pos is out of range!", pos);
+			}
+			return mData[static_cast<std::size_t>(pos.y()) * mStride + pos.x()];
+		}
+
+
+		//Gives access to the entry in row row and column column (MN-mode), bounds are only checked in debug builds
+		T& operator()(unsigned int row, unsigned int column)
+		{
+#ifdef MATRIX_DEBUG_CHECKS
+			if ((column >= mSize.x()) || (row >= mSize.y()))
+			{
+				throw InvalidIndicesException("Matrix<T>::operator()(unsigned int row, unsigned int column): entry is out of range!", MN(row, column));
+			}
+#endif
+			return mData[static_cast<std::size_t>(row) * mStride + column];
+		}
+
+
+		//Gives constant access to the entry in row row and column column (MN-mode), bounds are only checked in debug builds
+		T const & operator()(unsigned int row, unsigned int column) const
+		{
+#ifdef MATRIX_DEBUG_CHECKS
+			if ((column >= mSize.x()) || (row >= mSize.y()))
+			{
+				throw InvalidIndicesException("Matrix<T>::operator()(unsigned int row, unsigned int column) const: entry is out of range!", MN(row, column));
+			}
+#endif
+			return mData[static_cast<std::size_t>(row) * mStride + column];
+		}
+
+
+		//Gives access to the index-th entry in row-major order, the bound is only checked in debug builds
+		T& operator[](std::size_t index)
+		{
+#ifdef MATRIX_DEBUG_CHECKS
+			if (index >= this->getNumberOfEntries())
+			{
+				throw InvalidIndicesException("Matrix<T>::operator[](std::size_t index): index is out of range!", XY(static_cast<unsigned int>(index % std::max(mSize.x(), 1u)), static_cast<unsigned int>(index / std::max(mSize.x(), 1u))));
+			}
+#endif
+			return mData[index];
+		}
+
+
+		//Gives constant access to the index-th entry in row-major order, the bound is only checked in debug builds
+		T const & operator[](std::size_t index) const
 		{
-			for (auto & row : this->mVecOfRows)
+#ifdef MATRIX_DEBUG_CHECKS
+			if (index >= this->getNumberOfEntries())
 			{
-				for (auto & val : row)
+				throw InvalidIndicesException("Matrix<T>::operator[](std::size_t index) const: index is out of range!", XY(static_cast<unsigned int>(index % std::max(mSize.x(), 1u)), static_cast<unsigned int>(index / std::max(mSize.x(), 1u))));
+			}
+#endif
+			return mData[index];
+		}
+
+
+		//Iterators over all entries in row-major order (the storage is packed, so they are plain pointers)
+		iterator begin()
+		{
+			return mData.data();
+		}
+
+		iterator end()
+		{
+			return mData.data() + this->getNumberOfEntries();
+		}
+
+		const_iterator begin() const
+		{
+			return mData.data();
+		}
+
+		const_iterator end() const
+		{
+			return mData.data() + this->getNumberOfEntries();
+		}
+
+		const_iterator cbegin() const
+		{
+			return mData.data();
+		}
+
+		const_iterator cend() const
+		{
+			return mData.data() + this->getNumberOfEntries();
+		}
+
+
+		//Iterators over the entries of row y (no bounds check)
+		row_iterator rowBegin(unsigned int y)
+		{
+			return this->rowPtr(y);
+		}
+
+		row_iterator rowEnd(unsigned int y)
+		{
+			return this->rowPtr(y) + mSize.x();
+		}
+
+		const_row_iterator rowBegin(unsigned int y) const
+		{
+			return this->rowPtr(y);
+		}
+
+		const_row_iterator rowEnd(unsigned int y) const
+		{
+			return this->rowPtr(y) + mSize.x();
+		}
+
+
+		//Iterators over the entries of column x (no bounds check)
+		column_iterator columnBegin(unsigned int x)
+		{
+			return column_iterator(mData.data() + x, mStride);
+		}
+
+		column_iterator columnEnd(unsigned int x)
+		{
+			return column_iterator(mData.data() + x, mStride) + mSize.y();
+		}
+
+		const_column_iterator columnBegin(unsigned int x) const
+		{
+			return const_column_iterator(mData.data() + x, mStride);
+		}
+
+		const_column_iterator columnEnd(unsigned int x) const
+		{
+			return const_column_iterator(mData.data() + x, mStride) + mSize.y();
+		}
+
+
+		//Constructor that constructs matrix from matrix of other type
+		template <typename S> explicit Matrix(Matrix<S> const & other)
+			: Matrix(other.getSize())
+		{
+			for (unsigned int y = 0; y < mSize.y(); ++y)
+			{
+				T* row = this->rowPtr(y);
+				S const * otherRow = other.data() + static_cast<std::size_t>(y) * other.getStride();
+				for (unsigned int x = 0; x < mSize.x(); ++x)
 				{
-					val = value;
+					row[x] = static_cast<T>(otherRow[x]);
 				}
 			}
 		}
 
 
-		//Does some action for every entry in this
-		void doForEveryEntry(std::function<void(T& entry, MatrixEntry const & entryPos)> action)
+		//Calculates trace
+		T trace() const
 		{
+			MATRIX_PROFILE("Matrix::trace", std::min(mSize.x(), mSize.y()), mSize.x(), mSize.y());
+			T sum = T(0);
+			for (unsigned int i = 0; i < std::min(mSize.x(), mSize.y()); ++i)
+			{
+				sum += mData[static_cast<std::size_t>(i) * mStride + i];
+			}
+			return sum;
+		}
+
+
+		//Swaps two rows
+		void swapRows(unsigned int r1, unsigned int r2)
+		{
+			if (r1 >= mSize.y())
+			{
+				throw InvalidIndicesException("Matrix<T>::swapRows(unsigned int r1, unsigned int r2): r1 is no valid y index!", XY(0, r1));
+			}
+			if (r2 >= mSize.y())
+			{
+				throw InvalidIndicesException("Matrix<T>::swapRows(unsigned int r1, unsigned int r2): r2 is no valid y index!", XY(0, r1));
+			}
+			if (r1 != r2)
+			{
+				std::swap_ranges(this->rowPtr(r1), this->rowPtr(r1) + mSize.x(), this->rowPtr(r2));
+			}
+		}
+
+
+		//Multiplies one row by a factor
+		void multiplyRowBy(unsigned int row, T factor)
+		{
+			if (row >= mSize.y())
+			{
+				throw InvalidIndicesException("Matrix<T>::multiplyRowBy(unsigned int row, T factor): row is no valid y index!", XY(0, row));
+			}
+			T* rowVec = this->rowPtr(row);
+			for (unsigned int x = 0; x < mSize.x(); ++x)
+			{
+				rowVec[x] *= factor;
+			}
+		}
+
+
+		//Subtracts two rows and writes the result into the first row
+		void subtractRows(unsigned int minuendRow, unsigned int subtrahendRow)
+		{
+			if (minuendRow >= mSize.y())
+			{
+				throw InvalidIndicesException("Matrix<T>::subtractRows(unsigned int minuendRow, unsigned int subtrahendRow): minuendRow is no valid y index!", XY(0, minuendRow));
+			}
+			if (subtrahendRow >= mSize.y())
+			{
+				throw InvalidIndicesException("Matrix<T>::subtractRows(unsigned int minuendRow, unsigned int subtrahendRow): subtrahendRow is no valid y index!", XY(0, subtrahendRow));
+			}
+			T* row1 = this->rowPtr(minuendRow);
+			T const * row2 = this->rowPtr(subtrahendRow);
+			for (unsigned int x = 0; x < mSize.x(); ++x)
+			{
+				row1[x] -= row2[x];
+			}
+		}
+
+
+		//Returns the matrix in row echelon form
+		Matrix<double> getRowEchelonForm(double& productOfGaussFactors) const
+		{
+			productOfGaussFactors = 1.0;
+			Matrix<double> matrix(*this);
+			for (unsigned int x = 0; x < mSize.x(); ++x)
+			{
+				//Sort zeros to the back
+				for (unsigned int y = x; y < mSize.y(); ++y)
+				{
+					if (matrix.at(XY(x, y)) == 0.0)
+					{
+						for (unsigned int n = y + 1; n < mSize.y(); ++n)
+						{
+							if (matrix.at(XY(x, n)) != 0.0)
+							{
+								matrix.swapRows(y, n);
+								productOfGaussFactors *= -1.0;
+								break;
+							}
+						}
+					}
+				}
+
+				//If first entry in column is not zero, multiply all non zero rows with the correct factor, so that they all have the same entry and then subtract first row from it
+				if (matrix.at(XY(x, x)) != 0.0)
+				{
+					for (unsigned int y = x + 1; y < mSize.y(); ++y)
+					{
+						if (matrix.at(XY(x, y)) != 0.0)
+						{
+							double multiplicator = matrix.at(XY(x, x)) / matrix.at(XY(x, y));
+							matrix.multiplyRowBy(y, multiplicator);
+							matrix.subtractRows(y, x); //Minuend - Subtrahend
+							productOfGaussFactors *= multiplicator;
+						}
+					}
+				}
+			}
+			return matrix;
+		}
+
+
+		//Calculates determinant (via LU<double>, see LU.hpp; keep an LU object to reuse the factorization)
+		double det() const;
+
+
+		//Finds all EntryPositions which have dist tolerance or less from val
+		std::list<MatrixEntry> find(T const & val, T const & tolerance = T(0)) const
+		{
+			MATRIX_PROFILE("Matrix::find", 2.0 * this->getNumberOfEntries(), mSize.x(), mSize.y());
+			std::list<MatrixEntry> list;
 			for (unsigned int x = 0; x < mSize.x(); ++x)
 			{
 				for (unsigned int y = 0; y < mSize.y(); ++y)
 				{
-					action(this->at(XY(x, y)), XY(x, y));
+					if (std::abs(this->at(XY(x, y)) - val) <= tolerance)
+					{
+						list.push_back(XY(x, y));
+					}
 				}
 			}
+			return list;
+		}
+
+
+		//Returns the positions of all entries which have dist tolerance or less from val in one contiguous vector, in row-major order
+		//(unlike find, which goes column by column). The comparison is vectorized and large matrices are scanned on the thread pool
+		std::vector<MatrixEntry> findAll(T const & val, T const & tolerance = T(0)) const
+		{
+			MATRIX_PROFILE("Matrix::findAll", 2.0 * this->getNumberOfEntries(), mSize.x(), mSize.y());
+			unsigned int const width = mSize.x();
+			return Kernel::findAll<MatrixEntry>(this->getNumberOfEntries(), mData.data(), val, tolerance, [width](std::size_t i)
+			{
+				return MatrixEntry(XY(static_cast<unsigned int>(i % width), static_cast<unsigned int>(i / width)));
+			});
+		}
+
+
+		//Returns one bit per entry: bit i % 64 of word i / 64 is set if the entry with row-major index i = y * getSize().x() + x
+		//has dist tolerance or less from val
+		std::vector<std::uint64_t> findMask(T const & val, T const & tolerance = T(0)) const
+		{
+			MATRIX_PROFILE("Matrix::findMask", 2.0 * this->getNumberOfEntries(), mSize.x(), mSize.y());
+			std::vector<std::uint64_t> bits((this->getNumberOfEntries() + 63) / 64);
+			Kernel::findMask(this->getNumberOfEntries(), mData.data(), val, tolerance, bits.data());
+			return bits;
+		}
+
+
+		//Returns the number of entries which have dist tolerance or less from val (allocates nothing)
+		std::size_t count(T const & val, T const & tolerance = T(0)) const
+		{
+			MATRIX_PROFILE("Matrix::count", 2.0 * this->getNumberOfEntries(), mSize.x(), mSize.y());
+			return Kernel::countMatches(this->getNumberOfEntries(), mData.data(), val, tolerance);
+		}
+
+
+		//Looks for the first entry in row-major order which has dist tolerance or less from val and stores its position in entry
+		//Returns false (and leaves entry unchanged) if there is none. Allocates nothing and stops at the first match
+		bool findFirst(T const & val, MatrixEntry & entry, T const & tolerance = T(0)) const
+		{
+			MATRIX_PROFILE("Matrix::findFirst", 0.0, mSize.x(), mSize.y());
+			std::size_t const i = Kernel::findFirst(this->getNumberOfEntries(), mData.data(), val, tolerance);
+			if (i == this->getNumberOfEntries())
+			{
+				return false;
+			}
+			entry = XY(static_cast<unsigned int>(i % mSize.x()), static_cast<unsigned int>(i / mSize.x()));
+			return true;
+		}
+
+
+		//Returns submatrix beginning at origin with size size (Non overlapping parts will be cut out! Example: 2x2 matrix with origin=(1,1) and size=(1,1) yields 1x1 matrix!)
+		//Use getSubmatrixView to read or write a block without copying it
+		Matrix<T> getSubmatrix(MatrixEntry const & origin, MatrixSize const & size) const
+		{
+			MATRIX_PROFILE("Matrix::getSubmatrix", 0.0, mSize.x(), mSize.y(), size.x(), size.y());
+			return this->getSubmatrixView(origin, size).toMatrix();
+		}
+
+
+		//Returns transposed matrix without changing this
+		Matrix<T> getTransposed() const
+		{
+			MATRIX_PROFILE("Matrix::getTransposed", 0.0, mSize.x(), mSize.y());
+			MatrixSize size(this->getSize());
+			size.flip();
+			Matrix<T> transposedMatrix(size);
+			Kernel::transpose<T>(mSize.m(), mSize.n(), mData.data(), mStride, transposedMatrix.data(), transposedMatrix.getStride());
+			return transposedMatrix;
+		}
+
+
+		//Transposes this matrix in place, without allocating a second matrix
+		void transpose()
+		{
+			MATRIX_PROFILE("Matrix::transpose", 0.0, mSize.x(), mSize.y());
+			if (mSize.x() == mSize.y())
+			{
+				Kernel::transposeSquareInPlace<T>(mSize.x(), mData.data(), mStride);
+				return;
+			}
+
+			//The buffer is packed (mStride == mSize.x()), so the permutation can run on it directly
+			Kernel::transposeInPlace<T>(mSize.m(), mSize.n(), mData.data());
+			mSize.flip();
+			mStride = mSize.x();
+		}
+
+
+		//Resizes the matrix (If entries are created, they are filled with fillValue)
+		void resize(MatrixSize size, T const & fillValue = T())
+		{
+			//If only rows are appended or removed, the existing rows stay in place
+			if (size.x() == mSize.x())
+			{
+				mData.resize(static_cast<std::size_t>(mStride) * size.y(), fillValue);
+				mData.shrink_to_fit();
+				this->mSize = size;
+				return;
+			}
+
+			//Otherwise, copy the overlapping block into a new buffer (from the resource of this matrix, not the default one)
+			Buffer newData(static_cast<std::size_t>(size.x()) * size.y(), fillValue, mData.get_allocator());
+			unsigned int copyX = std::min(size.x(), mSize.x());
+			unsigned int copyY = std::min(size.y(), mSize.y());
+			for (unsigned int y = 0; y < copyY; ++y)
+			{
+				T const * srcRow = this->rowPtr(y);
+				std::copy(srcRow, srcRow + copyX, newData.data() + static_cast<std::size_t>(y) * size.x());
+			}
+			this->mData.swap(newData);
+			this->mStride = size.x();
+			this->mSize = size;
+		}
+
+
+		//Fills every entry of the matrix with value
+		void fillWith(T const & value)
+		{
+			std::fill(mData.begin(), mData.end(), value);
+		}
+
+
+		//Calls action(entry, entryPos) for every entry in this, in row-major order if execution is Sequential
+		//action can be any callable (lambdas are inlined, no std::function is involved)
+		template <typename F> void doForEveryEntry(F action, Execution execution = Execution::Sequential)
+		{
+			MATRIX_PROFILE("Matrix::doForEveryEntry", 0.0, mSize.x(), mSize.y());
+			unsigned int const width = mSize.x();
+			if (width == 0)
+			{
+				return;
+			}
+			T* const data = mData.data();
+			Kernel::forRanges(this->getNumberOfEntries(), execution, [&](std::size_t begin, std::size_t end)
+			{
+				unsigned int x = static_cast<unsigned int>(begin % width);
+				unsigned int y = static_cast<unsigned int>(begin / width);
+				for (std::size_t i = begin; i < end; ++i)
+				{
+					action(data[i], XY(x, y));
+					if (++x == width)
+					{
+						x = 0;
+						++y;
+					}
+				}
+			});
+		}
+
+
+		//Calls f(entry) for every entry in this, in row-major order if execution is Sequential
+		template <typename F> void forEach(F f, Execution execution = Execution::Sequential)
+		{
+			MATRIX_PROFILE("Matrix::forEach", 0.0, mSize.x(), mSize.y());
+			Kernel::forEach(this->getNumberOfEntries(), mData.data(), f, execution);
+		}
+
+
+		//Calls f(entry) for every entry in this, in row-major order if execution is Sequential
+		template <typename F> void forEach(F f, Execution execution = Execution::Sequential) const
+		{
+			MATRIX_PROFILE("Matrix::forEach", 0.0, mSize.x(), mSize.y());
+			Kernel::forEach(this->getNumberOfEntries(), mData.data(), f, execution);
+		}
+
+
+		//Returns a pointer to the first entry of row y (no bounds check)
+		T* rowPtr(unsigned int y)
+		{
+			return mData.data() + static_cast<std::size_t>(y) * mStride;
+		}
+
+
+		//Returns a constant pointer to the first entry of row y (no bounds check)
+		T const * rowPtr(unsigned int y) const
+		{
+			return mData.data() + static_cast<std::size_t>(y) * mStride;
 		}
 
 
 	private:
+		//Copies a validated vec of rows into the contiguous buffer
+		void assignFromVecOfRows(std::vector<std::vector<T>> const & vecOfRows, MatrixSize const & size)
+		{
+			mSize = size;
+			mStride = size.x();
+			mData.assign(static_cast<std::size_t>(size.x()) * size.y(), T());
+			for (unsigned int y = 0; y < size.y(); ++y)
+			{
+				std::copy(vecOfRows[y].begin(), vecOfRows[y].end(), this->rowPtr(y));
+			}
+		}
+
+
 		static bool checkIfVecOfRowsIsValidAndHandBackMatrixSize(std::vector<std::vector<T>> const & vecOfRows, MatrixSize& matrixSize)
 		{
 			//Construct size candidate
@@ -516,113 +1089,217 @@ namespace Mat
 		}
 
 
-	}; //Class Template: Matrix
+	}; //Class Template: Matrix
+
+
+
+	//Evaluates a matrix expression into dst (row pitch stride) with one fused row-major loop
+	template <typename T, typename E> void evaluateMatrixExpression(T* dst, unsigned int stride, MatrixExpression<E> const & expression)
+	{
+		E const & e = expression.self();
+		MatrixSize const size = e.getSize();
+		for (unsigned int y = 0; y < size.y(); ++y)
+		{
+			T* row = dst + static_cast<std::size_t>(y) * stride;
+			for (unsigned int x = 0; x < size.x(); ++x)
+			{
+				row[x] = e.evaluateAt(x, y);
+			}
+		}
+	}
+
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Struct Template IsStoredMatrix, which tells whether E keeps its entries in memory (Matrix and views),
+	//so that operations on it can be handed to the SIMD kernels row by row via rowPtr() and getStride()
+	template <typename E> struct IsStoredMatrix : std::false_type {};
+	template <typename T> struct IsStoredMatrix<Matrix<T>> : std::true_type {};
+
+
+	//Calls operation(y, n) for the n entries of every row y, or once with y = 0 for all entries if every row pitch equals the width
+	template <typename RowOperation> void forEveryStoredRow(MatrixSize const & size, bool packed, RowOperation operation)
+	{
+		if (packed)
+		{
+			operation(0u, static_cast<std::size_t>(size.x()) * size.y());
+			return;
+		}
+		for (unsigned int y = 0; y < size.y(); ++y)
+		{
+			operation(y, static_cast<std::size_t>(size.x()));
+		}
+	}
+
+
+	//Plain operations between stored matrices go straight to the SIMD kernels (rows are contiguous, even in views)
+	template <typename T, typename L, typename R> typename std::enable_if<IsStoredMatrix<L>::value && IsStoredMatrix<R>::value>::type
+	evaluateMatrixExpression(T* dst, unsigned int stride, MatrixBinaryExpression<L, R, Operation::Add> const & e)
+	{
+		MatrixSize const size = e.getSize();
+		bool const packed = (stride == size.x()) && (e.left().getStride() == size.x()) && (e.right().getStride() == size.x());
+		forEveryStoredRow(size, packed, [&](unsigned int y, std::size_t n)
+		{
+			Simd::add(n, e.left().rowPtr(y), e.right().rowPtr(y), dst + static_cast<std::size_t>(y) * stride);
+		});
+	}
+
+
+	template <typename T, typename L, typename R> typename std::enable_if<IsStoredMatrix<L>::value && IsStoredMatrix<R>::value>::type
+	evaluateMatrixExpression(T* dst, unsigned int stride, MatrixBinaryExpression<L, R, Operation::Subtract> const & e)
+	{
+		MatrixSize const size = e.getSize();
+		bool const packed = (stride == size.x()) && (e.left().getStride() == size.x()) && (e.right().getStride() == size.x());
+		forEveryStoredRow(size, packed, [&](unsigned int y, std::size_t n)
+		{
+			Simd::subtract(n, e.left().rowPtr(y), e.right().rowPtr(y), dst + static_cast<std::size_t>(y) * stride);
+		});
+	}
+
+
+	template <typename T, typename E> typename std::enable_if<IsStoredMatrix<E>::value>::type
+	evaluateMatrixExpression(T* dst, unsigned int stride, MatrixScalarExpression<E, Operation::Scale> const & e)
+	{
+		MatrixSize const size = e.getSize();
+		bool const packed = (stride == size.x()) && (e.operand().getStride() == size.x());
+		forEveryStoredRow(size, packed, [&](unsigned int y, std::size_t n)
+		{
+			Simd::scale(n, e.operand().rowPtr(y), e.scalar(), dst + static_cast<std::size_t>(y) * stride);
+		});
+	}
+
+
+	template <typename T, typename E> typename std::enable_if<IsStoredMatrix<E>::value>::type
+	evaluateMatrixExpression(T* dst, unsigned int stride, MatrixScalarExpression<E, Operation::Divide> const & e)
+	{
+		MatrixSize const size = e.getSize();
+		bool const packed = (stride == size.x()) && (e.operand().getStride() == size.x());
+		forEveryStoredRow(size, packed, [&](unsigned int y, std::size_t n)
+		{
+			Simd::divide(n, e.operand().rowPtr(y), e.scalar(), dst + static_cast<std::size_t>(y) * stride);
+		});
+	}
 
 
+	template <typename T, typename E> typename std::enable_if<IsStoredMatrix<E>::value>::type
+	evaluateMatrixExpression(T* dst, unsigned int stride, MatrixUnaryExpression<E, Operation::Negate> const & e)
+	{
+		MatrixSize const size = e.getSize();
+		bool const packed = (stride == size.x()) && (e.operand().getStride() == size.x());
+		forEveryStoredRow(size, packed, [&](unsigned int y, std::size_t n)
+		{
+			Simd::negate(n, e.operand().rowPtr(y), dst + static_cast<std::size_t>(y) * stride);
+		});
+	}
+
 
-	template <typename T> std::ostream& operator<<(std::ostream& oStream, Matrix<T> const & mat)
+
+	template <typename E> std::ostream& operator<<(std::ostream& oStream, MatrixExpression<E> const & mat)
 	{
-		for (unsigned int y = 0; y < mat.getSize().y(); ++y)
+		E const & e = mat.self();
+		for (unsigned int y = 0; y < e.getSize().y(); ++y)
 		{
-			for (unsigned int x = 0; x < mat.getSize().x(); ++x)
+			for (unsigned int x = 0; x < e.getSize().x(); ++x)
 			{
 				if (x != 0)
 				{
 					oStream << " ";
 				}
-				oStream << mat.at(XY(x, y));
+				oStream << e.evaluateAt(x, y);
 			}
-			oStream << std::endl;
+			oStream << '\n';
 		}
 		return oStream;
 	}
 
 
 
+	//The entrywise operators below build lazy expressions, which are evaluated in one fused loop
+	//when assigned to a Matrix. Sizes are checked once, when the expression is built.
+
+
 	//Performs entrywise addition
-	template <typename T> Matrix<T> operator+(Matrix<T> const & m1, Matrix<T> const & m2)
+	template <typename E1, typename E2> MatrixBinaryExpression<E1, E2, Operation::Add> operator+(MatrixExpression<E1> const & m1, MatrixExpression<E2> const & m2)
 	{
-		if (m1.getSize() != m2.getSize())
-		{
-			throw IncompatibleMatrixSizesException("operator+(Matrix<T> const & m1, Matrix<T> const & m2): m1 and m2 do not have the same size!", m1.getSize(), m2.getSize());
-		}
-		Matrix<T> newMatrix(m1);
-		for (unsigned int x = 0; x < m1.getSize().x(); ++x)
+		if (m1.self().getSize() != m2.self().getSize())
 		{
-			for (unsigned int y = 0; y < m1.getSize().y(); ++y)
-			{
-				newMatrix.at(XY(x, y)) = m1.at(XY(x, y)) + m2.at(XY(x, y));
-			}
+			throw IncompatibleMatrixSizesException("operator+(Matrix<T> const & m1, Matrix<T> const & m2): m1 and m2 do not have the same size!", m1.self().getSize(), m2.self().getSize());
 		}
-		return newMatrix;
+		return MatrixBinaryExpression<E1, E2, Operation::Add>(m1.self(), m2.self());
 	}
 
 
 	//Performs entrywise substraction
-	template <typename T> Matrix<T> operator-(Matrix<T> const & m1, Matrix<T> const & m2)
+	template <typename E1, typename E2> MatrixBinaryExpression<E1, E2, Operation::Subtract> operator-(MatrixExpression<E1> const & m1, MatrixExpression<E2> const & m2)
 	{
-		if (m1.getSize() != m2.getSize())
-		{
-			throw IncompatibleMatrixSizesException("operator-(Matrix<T> const & m1, Matrix<T> const & m2): m1 and m2 do not have the same size!", m1.getSize(), m2.getSize());
-		}
-		Matrix<T> newMatrix(m1);
-		for (unsigned int x = 0; x < m1.getSize().x(); ++x)
+		if (m1.self().getSize() != m2.self().getSize())
 		{
-			for (unsigned int y = 0; y < m1.getSize().y(); ++y)
-			{
-				newMatrix.at(XY(x, y)) = m1.at(XY(x, y)) - m2.at(XY(x, y));
-			}
+			throw IncompatibleMatrixSizesException("operator-(Matrix<T> const & m1, Matrix<T> const & m2): m1 and m2 do not have the same size!", m1.self().getSize(), m2.self().getSize());
 		}
-		return newMatrix;
+		return MatrixBinaryExpression<E1, E2, Operation::Subtract>(m1.self(), m2.self());
 	}
 
 
-	//Performs matrix multiplication
+	//Performs matrix multiplication (with Strassen-Winograd for large products if setMultiplicationAlgorithm selects it, see Strassen.hpp)
 	template <typename T> Matrix<T> operator*(Matrix<T> const & m1, Matrix<T> const & m2)
 	{
 		if (m1.getSize().n() != m2.getSize().m())
 		{
 			throw IncompatibleMatrixSizesException("operator*(Matrix<T> const & m1, Matrix<T> const & m2): m1 and m2 cannot be multiplied!", m1.getSize(), m2.getSize());
 		}
+		MATRIX_PROFILE("operator*(Matrix, Matrix)", 2.0 * m1.getSize().m() * m1.getSize().n() * m2.getSize().n(), m1.getSize().x(), m1.getSize().y(), m2.getSize().x(), m2.getSize().y());
 		Matrix<T> matrix(MN(m1.getSize().m(), m2.getSize().n()));
-		for (unsigned int m = 0; m < matrix.getSize().m(); ++m)
+		Kernel::multiply<T>(matrix.getSize().m(), matrix.getSize().n(), m1.getSize().n(),
+			m1.data(), m1.getStride(), m2.data(), m2.getStride(), matrix.data(), matrix.getStride());
+		return matrix;
+	}
+
+
+	//Performs matrix multiplication with Strassen-Winograd regardless of the selected algorithm (recursing down to cutoff)
+	template <typename T> Matrix<T> multiplyStrassenWinograd(Matrix<T> const & m1, Matrix<T> const & m2, std::size_t cutoff = getStrassenCutoff())
+	{
+		if (m1.getSize().n() != m2.getSize().m())
 		{
-			for (unsigned int n = 0; n < matrix.getSize().n(); ++n)
-			{
-				T sum = T(0);
-				for (unsigned int i = 0; i < m1.getSize().n(); ++i)
-				{
-					sum += m1.at(MN(m, i)) * m2.at(MN(i, n));
-				}
-				matrix.at(MN(m, n)) = sum;
-			}
+			throw IncompatibleMatrixSizesException("multiplyStrassenWinograd(Matrix<T> const & m1, Matrix<T> const & m2, std::size_t cutoff): m1 and m2 cannot be multiplied!", m1.getSize(), m2.getSize());
 		}
+		Matrix<T> matrix(MN(m1.getSize().m(), m2.getSize().n()));
+		Kernel::strassenMultiply<T>(matrix.getSize().m(), matrix.getSize().n(), m1.getSize().n(),
+			m1.data(), m1.getStride(), m2.data(), m2.getStride(), matrix.data(), matrix.getStride(), cutoff);
 		return matrix;
 	}
 
 
-	//Performs multiplication with scalar from left
-	template <typename T> Matrix<T> operator*(T const & s, Matrix<T> const & m)
+	//Performs matrix multiplication with the plain triple loop (reference for testing the optimized operator*)
+	template <typename T> Matrix<T> multiplyReference(Matrix<T> const & m1, Matrix<T> const & m2)
 	{
-		Matrix<T> matrix(m);
-		matrix.doForEveryEntry([&s](T& entry, MatrixEntry const & entryPos) {entry = s*entry; });
+		if (m1.getSize().n() != m2.getSize().m())
+		{
+			throw IncompatibleMatrixSizesException("multiplyReference(Matrix<T> const & m1, Matrix<T> const & m2): m1 and m2 cannot be multiplied!", m1.getSize(), m2.getSize());
+		}
+		Matrix<T> matrix(MN(m1.getSize().m(), m2.getSize().n()));
+		Kernel::gemmReference<T>(matrix.getSize().m(), matrix.getSize().n(), m1.getSize().n(), T(1),
+			m1.data(), m1.getStride(), 1, m2.data(), m2.getStride(), 1, T(0), matrix.data(), matrix.getStride());
 		return matrix;
 	}
 
 
+	//Performs multiplication with scalar from left
+	template <typename E> MatrixScalarExpression<E, Operation::Scale> operator*(typename E::ValueType const & s, MatrixExpression<E> const & m)
+	{
+		return MatrixScalarExpression<E, Operation::Scale>(m.self(), s);
+	}
+
+
 	//Performs multiplication with scalar from right
-	template <typename T> Matrix<T> operator*(Matrix<T> const & m, T const & s)
+	template <typename E> MatrixScalarExpression<E, Operation::Scale> operator*(MatrixExpression<E> const & m, typename E::ValueType const & s)
 	{
-		return (s*m);
+		return MatrixScalarExpression<E, Operation::Scale>(m.self(), s);
 	}
 
 
 	//Performs division with scalar
-	template <typename T> Matrix<T> operator/(Matrix<T> const & m, T const & s)
+	template <typename E> MatrixScalarExpression<E, Operation::Divide> operator/(MatrixExpression<E> const & m, typename E::ValueType const & s)
 	{
-		Matrix<T> matrix(m);
-		matrix.doForEveryEntry([&s](T& entry, MatrixEntry const & entryPos) {entry = entry/s; });
-		return matrix;
+		return MatrixScalarExpression<E, Operation::Divide>(m.self(), s);
 	}
 
 
@@ -634,26 +1311,27 @@ namespace Mat
 
 
 	//Returns negative matrix
-	template <typename T> Matrix<T> operator-(Matrix<T> const & m)
+	template <typename E> MatrixUnaryExpression<E, Operation::Negate> operator-(MatrixExpression<E> const & m)
 	{
-		Matrix<T> matrix(m);
-		matrix.doForEveryEntry([](T& entry, MatrixEntry const & entryPos) {entry = -entry; });
-		return matrix;
+		return MatrixUnaryExpression<E, Operation::Negate>(m.self());
 	}
 
 
+	//The compound operators update m1 in its own storage, without allocating (unless m2 partially overlaps m1)
+
+
 	//Adds m2 to m1
-	template <typename T> Matrix<T>& operator+=(Matrix<T> & m1, Matrix<T> const & m2)
+	template <typename T, typename E> Matrix<T>& operator+=(Matrix<T> & m1, MatrixExpression<E> const & m2)
 	{
-		m1 = m1 + m2;
+		m1.getView() += m2;
 		return m1;
 	}
 
 
 	//Subtracts m2 from m1
-	template <typename T> Matrix<T>& operator-=(Matrix<T> & m1, Matrix<T> const & m2)
+	template <typename T, typename E> Matrix<T>& operator-=(Matrix<T> & m1, MatrixExpression<E> const & m2)
 	{
-		m1 = m1 - m2;
+		m1.getView() -= m2;
 		return m1;
 	}
 
@@ -661,7 +1339,7 @@ namespace Mat
 	//Multiplies m by s
 	template <typename T> Matrix<T>& operator*=(Matrix<T> & m, T const & s)
 	{
-		m = m * s;
+		m.getView() *= s;
 		return m;
 	}
 
@@ -669,11 +1347,99 @@ namespace Mat
 	//Divide m by s
 	template <typename T> Matrix<T>& operator/=(Matrix<T> & m, T const & s)
 	{
-		m = m / s;
+		m.getView() /= s;
 		return m;
 	}
 
 
+
+	//The overloads below take an expiring Matrix operand and write the result into its storage instead of allocating
+
+
+	//Performs entrywise addition into the storage of m1
+	template <typename T, typename E> Matrix<T> operator+(Matrix<T> && m1, MatrixExpression<E> const & m2)
+	{
+		m1 += m2;
+		return std::move(m1);
+	}
+
+
+	//Performs entrywise addition into the storage of m2
+	template <typename E, typename T> Matrix<T> operator+(MatrixExpression<E> const & m1, Matrix<T> && m2)
+	{
+		m2 += m1;
+		return std::move(m2);
+	}
+
+
+	//Performs entrywise addition into the storage of m1
+	template <typename T> Matrix<T> operator+(Matrix<T> && m1, Matrix<T> && m2)
+	{
+		m1 += m2;
+		return std::move(m1);
+	}
+
+
+	//Performs entrywise substraction into the storage of m1
+	template <typename T, typename E> Matrix<T> operator-(Matrix<T> && m1, MatrixExpression<E> const & m2)
+	{
+		m1 -= m2;
+		return std::move(m1);
+	}
+
+
+	//Performs entrywise substraction into the storage of m2
+	template <typename E, typename T> Matrix<T> operator-(MatrixExpression<E> const & m1, Matrix<T> && m2)
+	{
+		if (m1.self().getSize() != m2.getSize())
+		{
+			throw IncompatibleMatrixSizesException("operator-(Matrix<T> const & m1, Matrix<T> const & m2): m1 and m2 do not have the same size!", m1.self().getSize(), m2.getSize());
+		}
+		m2.getView() = m1.self() - m2;
+		return std::move(m2);
+	}
+
+
+	//Performs entrywise substraction into the storage of m1
+	template <typename T> Matrix<T> operator-(Matrix<T> && m1, Matrix<T> && m2)
+	{
+		m1 -= m2;
+		return std::move(m1);
+	}
+
+
+	//Performs multiplication with scalar from left into the storage of m
+	template <typename T> Matrix<T> operator*(typename Matrix<T>::ValueType const & s, Matrix<T> && m)
+	{
+		m *= s;
+		return std::move(m);
+	}
+
+
+	//Performs multiplication with scalar from right into the storage of m
+	template <typename T> Matrix<T> operator*(Matrix<T> && m, typename Matrix<T>::ValueType const & s)
+	{
+		m *= s;
+		return std::move(m);
+	}
+
+
+	//Performs division with scalar into the storage of m
+	template <typename T> Matrix<T> operator/(Matrix<T> && m, typename Matrix<T>::ValueType const & s)
+	{
+		m /= s;
+		return std::move(m);
+	}
+
+
+	//Returns negative matrix in the storage of m
+	template <typename T> Matrix<T> operator-(Matrix<T> && m)
+	{
+		m.getView() = -m;
+		return std::move(m);
+	}
+
+
 	//Matrix vector product
 	template <typename T> Vector<T> operator*(Matrix<T> const & mat, Vector<T> const & vec)
 	{
@@ -681,22 +1447,383 @@ namespace Mat
 		{
 			throw IncompatibleMatrixSizesException("operator*(Matrix<T> const & mat, Vector<T> const & vec): mat's and vec's sizes are not compatible for matrix vector multiplication!", mat.getSize(), XY(1, vec.getSize()));
 		}
+		MATRIX_PROFILE("operator*(Matrix, Vector)", 2.0 * mat.getNumberOfEntries(), mat.getSize().x(), mat.getSize().y(), vec.getSize(), 1u);
 		Vector<T> res(mat.getSize().y());
-		for (unsigned int m = 0; m < res.getSize(); ++m)
+		Kernel::gemv<T>(mat.getSize().m(), mat.getSize().n(), T(1), mat.data(), mat.getStride(), 1, vec.data(), 1, T(0), res.data(), 1);
+		return res;
+	}
+
+
+	//Transposed matrix vector product mat^T * vec, computed from the storage of mat without forming the transposed matrix
+	template <typename T> Vector<T> multiplyTransposed(Matrix<T> const & mat, Vector<T> const & vec)
+	{
+		if (mat.getSize().y() != vec.getSize())
 		{
-			T sum = T(0);
-			for (unsigned int n = 0; n < vec.getSize(); ++n)
+			throw IncompatibleMatrixSizesException("multiplyTransposed(Matrix<T> const & mat, Vector<T> const & vec): mat's and vec's sizes are not compatible for transposed matrix vector multiplication!", mat.getSize(), XY(1, vec.getSize()));
+		}
+		MATRIX_PROFILE("multiplyTransposed(Matrix, Vector)", 2.0 * mat.getNumberOfEntries(), mat.getSize().x(), mat.getSize().y(), vec.getSize(), 1u);
+		Vector<T> res(mat.getSize().x());
+		Kernel::gemvTransposed<T>(mat.getSize().m(), mat.getSize().n(), T(1), mat.data(), mat.getStride(), 1, vec.data(), 1, T(0), res.data(), 1);
+		return res;
+	}
+
+
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Struct Template EvaluatedMatrix, which evaluates an expression once so that kernels can work on it
+	//through the constant view view. Matrices and views are only referenced
+	template <typename E> struct EvaluatedMatrix
+	{
+		Matrix<typename E::ValueType> const matrix;
+		MatrixView<typename E::ValueType const> const view;
+		explicit EvaluatedMatrix(E const & expression) : matrix(expression), view(matrix.getView()) {}
+	};
+
+	template <typename T> struct EvaluatedMatrix<Matrix<T>>
+	{
+		MatrixView<T const> const view;
+		explicit EvaluatedMatrix(Matrix<T> const & m) : view(m.getView()) {}
+	};
+
+	template <typename E> struct EvaluatedVector
+	{
+		Vector<typename E::ValueType> const vector;
+		VectorView<typename E::ValueType const> const view;
+		explicit EvaluatedVector(E const & expression) : vector(expression), view(vector.getView()) {}
+	};
+
+	template <typename T> struct EvaluatedVector<Vector<T>>
+	{
+		VectorView<T const> const view;
+		explicit EvaluatedVector(Vector<T> const & v) : view(v.getView()) {}
+	};
+
+
+	//Matrix multiplication of expressions (operands are evaluated once, then multiplied by the GEMM kernel)
+	template <typename E1, typename E2> Matrix<typename E1::ValueType> operator*(MatrixExpression<E1> const & m1, MatrixExpression<E2> const & m2)
+	{
+		typedef typename E1::ValueType T;
+		static_assert(std::is_same<T, typename E2::ValueType>::value, "operator*(MatrixExpression<E1> const & m1, MatrixExpression<E2> const & m2): operands have different value types!");
+		MATRIX_PROFILE("operator*(MatrixExpression, MatrixExpression)", 2.0 * m1.self().getSize().m() * m1.self().getSize().n() * m2.self().getSize().n(), m1.self().getSize().x(), m1.self().getSize().y(), m2.self().getSize().x(), m2.self().getSize().y());
+		EvaluatedMatrix<E1> const a(m1.self());
+		EvaluatedMatrix<E2> const b(m2.self());
+		if (a.view.getSize().n() != b.view.getSize().m())
+		{
+			throw IncompatibleMatrixSizesException("operator*(MatrixExpression<E1> const & m1, MatrixExpression<E2> const & m2): m1 and m2 cannot be multiplied!", a.view.getSize(), b.view.getSize());
+		}
+		Matrix<T> matrix(MN(a.view.getSize().m(), b.view.getSize().n()));
+		Kernel::multiply<T>(matrix.getSize().m(), matrix.getSize().n(), a.view.getSize().n(),
+			a.view.data(), a.view.getStride(), b.view.data(), b.view.getStride(), matrix.data(), matrix.getStride());
+		return matrix;
+	}
+
+
+	//Returns whether the entries spanned by the two views share memory
+	template <typename T> bool storageOverlaps(MatrixView<T const> const & a, MatrixView<T const> const & b)
+	{
+		auto end = [](MatrixView<T const> const & v)
+		{
+			return ((v.getSize().x() == 0) || (v.getSize().y() == 0)) ? v.data() : v.rowPtr(v.getSize().y() - 1) + v.getSize().x();
+		};
+		return rangesOverlap<T>(a.data(), end(a), b.data(), end(b));
+	}
+
+
+	//Computes C = alpha * A * B + beta * C, accumulating into the existing storage of C (beta = 0 overwrites C without reading it)
+	//Matrix and view operands are not copied; only if A or B share memory with C, the product is formed in a temporary first
+	template <typename E1, typename E2> void gemm(typename E1::ValueType const & alpha, MatrixExpression<E1> const & A, MatrixExpression<E2> const & B,
+		typename E1::ValueType const & beta, MatrixView<typename E1::ValueType> C)
+	{
+		typedef typename E1::ValueType T;
+		static_assert(std::is_same<T, typename E2::ValueType>::value, "gemm(alpha, MatrixExpression<E1> const & A, MatrixExpression<E2> const & B, beta, C): operands have different value types!");
+		MATRIX_PROFILE("gemm", 2.0 * A.self().getSize().m() * A.self().getSize().n() * B.self().getSize().n(), A.self().getSize().x(), A.self().getSize().y(), B.self().getSize().x(), B.self().getSize().y());
+		EvaluatedMatrix<E1> const a(A.self());
+		EvaluatedMatrix<E2> const b(B.self());
+		if (a.view.getSize().n() != b.view.getSize().m())
+		{
+			throw IncompatibleMatrixSizesException("gemm(alpha, MatrixExpression<E1> const & A, MatrixExpression<E2> const & B, beta, C): A and B cannot be multiplied!", a.view.getSize(), b.view.getSize());
+		}
+		MatrixSize const size = MN(a.view.getSize().m(), b.view.getSize().n());
+		if (C.getSize() != size)
+		{
+			throw IncompatibleMatrixSizesException("gemm(alpha, MatrixExpression<E1> const & A, MatrixExpression<E2> const & B, beta, C): C does not have the size of A * B!", C.getSize(), size);
+		}
+
+		if (storageOverlaps<T>(a.view, C) || storageOverlaps<T>(b.view, C))
+		{
+			Matrix<T> product(size);
+			Kernel::gemm<T>(size.m(), size.n(), a.view.getSize().n(), alpha,
+				a.view.data(), a.view.getStride(), 1, b.view.data(), b.view.getStride(), 1, T(0), product.data(), product.getStride());
+			if (beta == T(0))
+			{
+				C = product;
+			}
+			else
+			{
+				C = beta * C + product;
+			}
+			return;
+		}
+
+		Kernel::gemm<T>(size.m(), size.n(), a.view.getSize().n(), alpha,
+			a.view.data(), a.view.getStride(), 1, b.view.data(), b.view.getStride(), 1, beta, C.data(), C.getStride());
+	}
+
+
+	//Computes C = alpha * A * B + beta * C, accumulating into the existing storage of C (which has to have the size of A * B)
+	template <typename E1, typename E2> void gemm(typename E1::ValueType const & alpha, MatrixExpression<E1> const & A, MatrixExpression<E2> const & B,
+		typename E1::ValueType const & beta, Matrix<typename E1::ValueType> & C)
+	{
+		gemm(alpha, A, B, beta, C.getView());
+	}
+
+
+	//Returns the pointer behind the last component spanned by v
+	template <typename T> T const * storageEnd(VectorView<T const> const & v)
+	{
+		return (v.getSize() == 0) ? v.data() : v.data() + static_cast<std::size_t>(v.getSize() - 1) * v.getStride() + 1;
+	}
+
+
+	//Returns whether the components spanned by the two views share memory
+	template <typename T> bool storageOverlaps(VectorView<T const> const & a, VectorView<T const> const & b)
+	{
+		return rangesOverlap<T>(a.data(), storageEnd(a), b.data(), storageEnd(b));
+	}
+
+
+	//Returns whether the entries of a and the components of b share memory
+	template <typename T> bool storageOverlaps(MatrixView<T const> const & a, VectorView<T const> const & b)
+	{
+		T const * aEnd = ((a.getSize().x() == 0) || (a.getSize().y() == 0)) ? a.data() : a.rowPtr(a.getSize().y() - 1) + a.getSize().x();
+		return rangesOverlap<T>(a.data(), aEnd, b.data(), storageEnd(b));
+	}
+
+
+	//Computes y = alpha * A * x + beta * y (or y = alpha * A^T * x + beta * y if transposed is true) in the existing storage of y
+	//beta = 0 overwrites y without reading it. Only if A or x share memory with y, the product is formed in a temporary first
+	template <typename E1, typename E2> void gemv(typename E1::ValueType const & alpha, MatrixExpression<E1> const & A, VectorExpression<E2> const & x,
+		typename E1::ValueType const & beta, VectorView<typename E1::ValueType> y, bool transposed = false)
+	{
+		typedef typename E1::ValueType T;
+		static_assert(std::is_same<T, typename E2::ValueType>::value, "gemv(alpha, MatrixExpression<E1> const & A, VectorExpression<E2> const & x, beta, y): operands have different value types!");
+		MATRIX_PROFILE("gemv", 2.0 * A.self().getSize().x() * A.self().getSize().y(), A.self().getSize().x(), A.self().getSize().y(), x.self().getSize(), 1u);
+		EvaluatedMatrix<E1> const a(A.self());
+		EvaluatedVector<E2> const v(x.self());
+		unsigned int const inSize = transposed ? a.view.getSize().y() : a.view.getSize().x();
+		unsigned int const outSize = transposed ? a.view.getSize().x() : a.view.getSize().y();
+		if (v.view.getSize() != inSize)
+		{
+			throw IncompatibleMatrixSizesException("gemv(alpha, MatrixExpression<E1> const & A, VectorExpression<E2> const & x, beta, y): A's and x's sizes are not compatible for matrix vector multiplication!", a.view.getSize(), XY(1, v.view.getSize()));
+		}
+		if (y.getSize() != outSize)
+		{
+			throw IncompatibleMatrixSizesException("gemv(alpha, MatrixExpression<E1> const & A, VectorExpression<E2> const & x, beta, y): y does not have the size of the product!", a.view.getSize(), XY(1, y.getSize()));
+		}
+
+		auto product = [&](T const & b, T* out, std::size_t incy)
+		{
+			if (transposed)
+			{
+				Kernel::gemvTransposed<T>(a.view.getSize().m(), a.view.getSize().n(), alpha, a.view.data(), a.view.getStride(), 1, v.view.data(), v.view.getStride(), b, out, incy);
+			}
+			else
+			{
+				Kernel::gemv<T>(a.view.getSize().m(), a.view.getSize().n(), alpha, a.view.data(), a.view.getStride(), 1, v.view.data(), v.view.getStride(), b, out, incy);
+			}
+		};
+
+		VectorView<T const> const out(y);
+		if (storageOverlaps<T>(a.view, out) || storageOverlaps<T>(v.view, out))
+		{
+			Vector<T> temporary(outSize);
+			product(T(0), temporary.data(), 1);
+			if (beta == T(0))
+			{
+				y = temporary;
+			}
+			else
+			{
+				y = beta * y + temporary;
+			}
+			return;
+		}
+		product(beta, y.data(), y.getStride());
+	}
+
+
+	//Computes y = alpha * A * x + beta * y (or with A^T if transposed is true) in the existing storage of y (which has to have the size of the product)
+	template <typename E1, typename E2> void gemv(typename E1::ValueType const & alpha, MatrixExpression<E1> const & A, VectorExpression<E2> const & x,
+		typename E1::ValueType const & beta, Vector<typename E1::ValueType> & y, bool transposed = false)
+	{
+		gemv(alpha, A, x, beta, y.getView(), transposed);
+	}
+
+
+	//Multiplies mat (or its transposed if transposed is true) with every vector of vectors and stores the products in results
+	//Entries of results that already have the correct size keep their storage. From Kernel::MultiVectorGemmThreshold vectors on,
+	//the vectors become the columns of one matrix and all products are formed by a single GEMM, which reads mat only once per block
+	template <typename T> void multiplyVectors(Matrix<T> const & mat, std::vector<Vector<T>> const & vectors, std::vector<Vector<T>> & results, bool transposed)
+	{
+		unsigned int const inSize = transposed ? mat.getSize().y() : mat.getSize().x();
+		unsigned int const outSize = transposed ? mat.getSize().x() : mat.getSize().y();
+		for (Vector<T> const & vec : vectors)
+		{
+			if (vec.getSize() != inSize)
 			{
-				sum += mat.at(MN(m, n)) * vec.at(n);
+				throw IncompatibleMatrixSizesException("multiplyVectors(Matrix<T> const & mat, std::vector<Vector<T>> const & vectors, std::vector<Vector<T>> & results, bool transposed): mat's size is not compatible with the size of a vector!", mat.getSize(), XY(1, vec.getSize()));
 			}
-			res.at(m) = sum;
 		}
+		std::size_t const count = vectors.size();
+		MATRIX_PROFILE("multiplyVectors(Matrix, vectors)", 2.0 * mat.getNumberOfEntries() * count, mat.getSize().x(), mat.getSize().y(), inSize, static_cast<unsigned int>(count));
+
+		if (&results == &vectors)
+		{
+			std::vector<Vector<T>> products;
+			multiplyVectors(mat, vectors, products, transposed);
+			results = std::move(products);
+			return;
+		}
+
+		if (count < Kernel::MultiVectorGemmThreshold)
+		{
+			results.resize(count);
+			for (std::size_t j = 0; j < count; ++j)
+			{
+				if (results[j].getSize() != outSize)
+				{
+					results[j] = Vector<T>(outSize);
+				}
+				gemv(T(1), mat, vectors[j], T(0), results[j], transposed);
+			}
+			return;
+		}
+
+		//Vector j becomes column j of columns, product j becomes column j of product
+		Matrix<T> columns(MN(inSize, static_cast<unsigned int>(count)));
+		for (std::size_t j = 0; j < count; ++j)
+		{
+			T const * in = vectors[j].data();
+			for (std::size_t p = 0; p < inSize; ++p)
+			{
+				columns.data()[p * count + j] = in[p];
+			}
+		}
+		Matrix<T> product(MN(outSize, static_cast<unsigned int>(count)));
+		if (transposed)
+		{
+			Kernel::gemm<T>(outSize, count, inSize, T(1), mat.data(), 1, mat.getStride(), columns.data(), columns.getStride(), 1,
+				T(0), product.data(), product.getStride());
+		}
+		else
+		{
+			Kernel::multiply<T>(outSize, count, inSize, mat.data(), mat.getStride(), columns.data(), columns.getStride(), product.data(), product.getStride());
+		}
+
+		results.resize(count);
+		for (std::size_t j = 0; j < count; ++j)
+		{
+			if (results[j].getSize() != outSize)
+			{
+				results[j] = Vector<T>(outSize);
+			}
+			T* out = results[j].data();
+			for (std::size_t i = 0; i < outSize; ++i)
+			{
+				out[i] = product.data()[i * count + j];
+			}
+		}
+	}
+
+
+	//Returns mat * vectors[j] for every vector (see multiplyVectors)
+	template <typename T> std::vector<Vector<T>> multiply(Matrix<T> const & mat, std::vector<Vector<T>> const & vectors)
+	{
+		std::vector<Vector<T>> results;
+		multiplyVectors(mat, vectors, results, false);
+		return results;
+	}
+
+
+	//Returns mat^T * vectors[j] for every vector, without forming the transposed matrix (see multiplyVectors)
+	template <typename T> std::vector<Vector<T>> multiplyTransposed(Matrix<T> const & mat, std::vector<Vector<T>> const & vectors)
+	{
+		std::vector<Vector<T>> results;
+		multiplyVectors(mat, vectors, results, true);
+		return results;
+	}
+
+
+	//Matrix vector product of expressions
+	template <typename E1, typename E2> Vector<typename E1::ValueType> operator*(MatrixExpression<E1> const & mat, VectorExpression<E2> const & vec)
+	{
+		typedef typename E1::ValueType T;
+		static_assert(std::is_same<T, typename E2::ValueType>::value, "operator*(MatrixExpression<E1> const & mat, VectorExpression<E2> const & vec): operands have different value types!");
+		MATRIX_PROFILE("operator*(MatrixExpression, VectorExpression)", 2.0 * mat.self().getSize().x() * mat.self().getSize().y(), mat.self().getSize().x(), mat.self().getSize().y(), vec.self().getSize(), 1u);
+		EvaluatedMatrix<E1> const a(mat.self());
+		EvaluatedVector<E2> const v(vec.self());
+		if (a.view.getSize().x() != v.view.getSize())
+		{
+			throw IncompatibleMatrixSizesException("operator*(MatrixExpression<E1> const & mat, VectorExpression<E2> const & vec): mat's and vec's sizes are not compatible for matrix vector multiplication!", a.view.getSize(), XY(1, v.view.getSize()));
+		}
+		Vector<T> res(a.view.getSize().y());
+		Kernel::gemv<T>(a.view.getSize().m(), a.view.getSize().n(), T(1), a.view.data(), a.view.getStride(), 1, v.view.data(), v.view.getStride(), T(0), res.data(), 1);
 		return res;
 	}
 
 
+	//Stores f(src(row, col)) in dst(row, col) for every entry (dst has to have the size of src, but may be src itself)
+	template <typename T, typename U, typename F> void transform(Matrix<T> const & src, Matrix<U> & dst, F f, Execution execution = Execution::Sequential)
+	{
+		if (src.getSize() != dst.getSize())
+		{
+			throw IncompatibleMatrixSizesException("transform(Matrix<T> const & src, Matrix<U> & dst, F f, Execution execution): src and dst do not have the same size!", src.getSize(), dst.getSize());
+		}
+		MATRIX_PROFILE("transform(Matrix, Matrix)", 0.0, src.getSize().x(), src.getSize().y());
+		Kernel::transform(src.getNumberOfEntries(), src.data(), dst.data(), f, execution);
+	}
+
+
+	//Stores f(a(row, col), b(row, col)) in dst(row, col) for every entry (all three have to have the same size; dst may be a or b)
+	template <typename T1, typename T2, typename U, typename F> void transform(Matrix<T1> const & a, Matrix<T2> const & b, Matrix<U> & dst, F f, Execution execution = Execution::Sequential)
+	{
+		if (a.getSize() != b.getSize())
+		{
+			throw IncompatibleMatrixSizesException("transform(Matrix<T1> const & a, Matrix<T2> const & b, Matrix<U> & dst, F f, Execution execution): a and b do not have the same size!", a.getSize(), b.getSize());
+		}
+		if (a.getSize() != dst.getSize())
+		{
+			throw IncompatibleMatrixSizesException("transform(Matrix<T1> const & a, Matrix<T2> const & b, Matrix<U> & dst, F f, Execution execution): a and dst do not have the same size!", a.getSize(), dst.getSize());
+		}
+		MATRIX_PROFILE("transform(Matrix, Matrix, Matrix)", 0.0, a.getSize().x(), a.getSize().y());
+		Kernel::transform(a.getNumberOfEntries(), a.data(), b.data(), dst.data(), f, execution);
+	}
+
+
+	//Returns init folded with map(entry) for every entry of m by op, as R result = op(result, map(entry))
+	//Entries are visited in row-major order; see Kernel::mapReduce for how they are grouped (sequential and parallel results are identical)
+	template <typename T, typename R, typename Map, typename Op> R mapReduce(Matrix<T> const & m, R init, Map map, Op op, Execution execution = Execution::Sequential)
+	{
+		MATRIX_PROFILE("mapReduce(Matrix)", 0.0, m.getSize().x(), m.getSize().y());
+		return Kernel::mapReduce(m.getNumberOfEntries(), m.data(), init, map, op, execution);
+	}
+
+
+	//Returns init folded with every entry of m by op (see mapReduce)
+	template <typename T, typename R, typename Op> R reduce(Matrix<T> const & m, R init, Op op, Execution execution = Execution::Sequential)
+	{
+		auto identity = [](T const & entry) -> T const & { return entry; };
+		return mapReduce(m, init, identity, op, execution);
+	}
+
+
 
 } //Namespace Mat
 
+
+#include "MatrixView.hpp"
+#include "LU.hpp"
+#include "FixedMatrix.hpp"
+
 #endif //MATRIX_HPP
 
@@ -0,0 +1,278 @@
+#include "MatrixFile.hpp"
+
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+namespace Mat
+{
+
+	namespace
+	{
+
+		const char MatrixFileMagic[8] = { 'M', 'A', 'T', 'F', 'I', 'L', 'E', '\0' };
+
+
+		std::uint64_t alignUp(std::uint64_t value, std::uint64_t alignment)
+		{
+			return (value + alignment - 1) / alignment * alignment;
+		}
+
+	} //Anonymous namespace
+
+
+
+	//////////////////////////////
+	//Struct MatrixFileException
+
+	MatrixFileException::MatrixFileException(std::string const & _message, std::string const & _path)
+		: message(_message), path(_path)
+	{}
+
+
+
+	////////////////////
+	//Matrix file header
+
+	MatrixFileHeader makeMatrixFileHeader(MatrixFileElementType elementType, std::size_t elementSize, MatrixSize const & size, MatrixFileLayout layout)
+	{
+		MatrixFileHeader header = MatrixFileHeader();
+		std::memcpy(header.magic, MatrixFileMagic, sizeof(header.magic));
+		header.byteOrder = MatrixFileByteOrder;
+		header.version = MatrixFileVersion;
+		header.elementType = static_cast<std::uint32_t>(elementType);
+		header.elementSize = static_cast<std::uint32_t>(elementSize);
+		header.layout = static_cast<std::uint32_t>(layout);
+		header.sizeX = size.x();
+		header.sizeY = size.y();
+		header.stride = (layout == MatrixFileLayout::RowMajor) ? size.x() : size.y();
+		header.dataOffset = alignUp(sizeof(MatrixFileHeader), BufferAlignment);
+		return header;
+	}
+
+
+	MatrixFileHeader checkMatrixFileHeader(void const * bytes, std::uint64_t fileSize, MatrixFileElementType elementType, std::size_t elementSize, std::string const & path)
+	{
+		if (fileSize < sizeof(MatrixFileHeader))
+		{
+			throw MatrixFileException("checkMatrixFileHeader: file is too short to be a matrix file!", path);
+		}
+		MatrixFileHeader header;
+		std::memcpy(&header, bytes, sizeof(header));
+
+		if (std::memcmp(header.magic, MatrixFileMagic, sizeof(header.magic)) != 0)
+		{
+			throw MatrixFileException("checkMatrixFileHeader: file is no matrix file!", path);
+		}
+		if (header.byteOrder != MatrixFileByteOrder)
+		{
+			throw MatrixFileException("checkMatrixFileHeader: file was written with a different byte order!", path);
+		}
+		if (header.version != MatrixFileVersion)
+		{
+			throw MatrixFileException("checkMatrixFileHeader: file has an unsupported version!", path);
+		}
+		if (header.elementType != static_cast<std::uint32_t>(elementType))
+		{
+			throw MatrixFileException("checkMatrixFileHeader: file holds entries of a different type!", path);
+		}
+		if (header.elementSize != elementSize)
+		{
+			throw MatrixFileException("checkMatrixFileHeader: file has an invalid entry size!", path);
+		}
+		if (header.layout > static_cast<std::uint32_t>(MatrixFileLayout::ColumnMajor))
+		{
+			throw MatrixFileException("checkMatrixFileHeader: file has an unknown layout!", path);
+		}
+
+		std::uint64_t const maxIndex = std::numeric_limits<unsigned int>::max();
+		bool const rowMajor = (header.layout == static_cast<std::uint32_t>(MatrixFileLayout::RowMajor));
+		std::uint64_t const lines = rowMajor ? header.sizeY : header.sizeX;
+		std::uint64_t const lineLength = rowMajor ? header.sizeX : header.sizeY;
+		if ((header.sizeX > maxIndex) || (header.sizeY > maxIndex) || (header.stride > maxIndex) || (header.stride < lineLength))
+		{
+			throw MatrixFileException("checkMatrixFileHeader: file has invalid sizes!", path);
+		}
+		if ((header.dataOffset < sizeof(MatrixFileHeader)) || (header.dataOffset % BufferAlignment != 0) || (header.dataOffset > fileSize))
+		{
+			throw MatrixFileException("checkMatrixFileHeader: file has an invalid data offset!", path);
+		}
+
+		//All entries have to be inside the file (the last line does not need the padding up to stride)
+		std::uint64_t const available = (fileSize - header.dataOffset) / header.elementSize;
+		if ((lines != 0) && (lineLength != 0) && ((lines - 1 > available / header.stride) || ((lines - 1) * header.stride + lineLength > available)))
+		{
+			throw MatrixFileException("checkMatrixFileHeader: file is truncated!", path);
+		}
+		return header;
+	}
+
+
+
+	///////////////////
+	//Class MappedFile
+
+#ifdef _WIN32
+
+	MappedFile::MappedFile(std::string const & path)
+		: mData(nullptr), mSize(0), mFile(INVALID_HANDLE_VALUE), mMapping(nullptr)
+	{
+		mFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (mFile == INVALID_HANDLE_VALUE)
+		{
+			throw MatrixFileException("MappedFile::MappedFile(std::string const & path): path cannot be opened!", path);
+		}
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(mFile, &size))
+		{
+			this->unmap();
+			throw MatrixFileException("MappedFile::MappedFile(std::string const & path): size of path cannot be determined!", path);
+		}
+		mSize = static_cast<std::size_t>(size.QuadPart);
+		if (mSize == 0)
+		{
+			return; //Empty files cannot be mapped
+		}
+		mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		mData = (mMapping != nullptr) ? MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+		if (mData == nullptr)
+		{
+			this->unmap();
+			throw MatrixFileException("MappedFile::MappedFile(std::string const & path): path cannot be mapped!", path);
+		}
+	}
+
+
+	void MappedFile::unmap()
+	{
+		if (mData != nullptr)
+		{
+			UnmapViewOfFile(mData);
+		}
+		if (mMapping != nullptr)
+		{
+			CloseHandle(mMapping);
+		}
+		if (mFile != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(mFile);
+		}
+		mData = nullptr;
+		mSize = 0;
+		mMapping = nullptr;
+		mFile = INVALID_HANDLE_VALUE;
+	}
+
+
+	MappedFile::MappedFile(MappedFile && other)
+		: mData(other.mData), mSize(other.mSize), mFile(other.mFile), mMapping(other.mMapping)
+	{
+		other.mData = nullptr;
+		other.mSize = 0;
+		other.mFile = INVALID_HANDLE_VALUE;
+		other.mMapping = nullptr;
+	}
+
+
+	MappedFile& MappedFile::operator=(MappedFile && other)
+	{
+		if (this != &other)
+		{
+			this->unmap();
+			std::swap(mData, other.mData);
+			std::swap(mSize, other.mSize);
+			std::swap(mFile, other.mFile);
+			std::swap(mMapping, other.mMapping);
+		}
+		return *this;
+	}
+
+#else
+
+	MappedFile::MappedFile(std::string const & path)
+		: mData(nullptr), mSize(0)
+	{
+		int const fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			throw MatrixFileException("MappedFile::MappedFile(std::string const & path): path cannot be opened!", path);
+		}
+		struct stat status;
+		if (fstat(fd, &status) != 0)
+		{
+			close(fd);
+			throw MatrixFileException("MappedFile::MappedFile(std::string const & path): size of path cannot be determined!", path);
+		}
+		mSize = static_cast<std::size_t>(status.st_size);
+		if (mSize == 0)
+		{
+			close(fd);
+			return; //Empty files cannot be mapped
+		}
+
+		//The mapping keeps the file alive, so the descriptor is not needed any more
+		void* data = mmap(nullptr, mSize, PROT_READ, MAP_SHARED, fd, 0);
+		close(fd);
+		if (data == MAP_FAILED)
+		{
+			mSize = 0;
+			throw MatrixFileException("MappedFile::MappedFile(std::string const & path): path cannot be mapped!", path);
+		}
+		mData = data;
+	}
+
+
+	void MappedFile::unmap()
+	{
+		if (mData != nullptr)
+		{
+			munmap(const_cast<void*>(mData), mSize);
+		}
+		mData = nullptr;
+		mSize = 0;
+	}
+
+
+	MappedFile::MappedFile(MappedFile && other)
+		: mData(other.mData), mSize(other.mSize)
+	{
+		other.mData = nullptr;
+		other.mSize = 0;
+	}
+
+
+	MappedFile& MappedFile::operator=(MappedFile && other)
+	{
+		if (this != &other)
+		{
+			this->unmap();
+			std::swap(mData, other.mData);
+			std::swap(mSize, other.mSize);
+		}
+		return *this;
+	}
+
+#endif
+
+
+	MappedFile::~MappedFile()
+	{
+		this->unmap();
+	}
+
+
+
+} //Namespace: Mat
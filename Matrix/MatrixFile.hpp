@@ -0,0 +1,465 @@
+#ifndef MATRIXFILE_HPP
+#define MATRIXFILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <fstream>
+#include <type_traits>
+#include <algorithm>
+
+#include "Matrix.hpp"
+
+
+
+namespace Mat
+{
+	//Binary matrix file (all fields in the byte order of the writing machine, which byteOrder records):
+	//a 64 byte MatrixFileHeader, then the raw entries from dataOffset (a multiple of BufferAlignment) on.
+	//Row-major files store row y at dataOffset + y * stride * elementSize, column-major files store column x there
+	const std::uint32_t MatrixFileVersion = 1;
+	const std::uint32_t MatrixFileByteOrder = 0x01020304;
+
+
+	//Type of the stored entries
+	enum class MatrixFileElementType : std::uint32_t
+	{
+		Unsupported = 0,
+		Int8, UInt8, Int16, UInt16, Int32, UInt32, Int64, UInt64,
+		Float32, Float64
+	};
+
+
+	//Order of the stored entries
+	enum class MatrixFileLayout : std::uint32_t
+	{
+		RowMajor = 0,
+		ColumnMajor = 1
+	};
+
+
+	struct MatrixFileHeader
+	{
+		char magic[8]; //"MATFILE" and a terminating zero
+		std::uint32_t byteOrder; //MatrixFileByteOrder as written by the producing machine
+		std::uint32_t version;
+		std::uint32_t elementType; //MatrixFileElementType
+		std::uint32_t elementSize;
+		std::uint32_t layout; //MatrixFileLayout
+		std::uint32_t reserved;
+		std::uint64_t sizeX;
+		std::uint64_t sizeY;
+		std::uint64_t stride; //Distance (in entries) between the starts of two stored rows (columns for column-major)
+		std::uint64_t dataOffset; //Offset (in bytes) of the first entry from the start of the file
+	};
+
+	static_assert(sizeof(MatrixFileHeader) == 64, "MatrixFileHeader has to be exactly 64 bytes!");
+
+
+	//Returns the file element type of T (Unsupported for everything but fixed-width integers and IEEE float/double)
+	template <typename T> constexpr MatrixFileElementType getMatrixFileElementType()
+	{
+		return (std::is_same<T, bool>::value || !std::is_arithmetic<T>::value) ? MatrixFileElementType::Unsupported
+			: std::is_floating_point<T>::value ? ((sizeof(T) == 4) ? MatrixFileElementType::Float32 : (sizeof(T) == 8) ? MatrixFileElementType::Float64 : MatrixFileElementType::Unsupported)
+			: (sizeof(T) == 1) ? (std::is_signed<T>::value ? MatrixFileElementType::Int8 : MatrixFileElementType::UInt8)
+			: (sizeof(T) == 2) ? (std::is_signed<T>::value ? MatrixFileElementType::Int16 : MatrixFileElementType::UInt16)
+			: (sizeof(T) == 4) ? (std::is_signed<T>::value ? MatrixFileElementType::Int32 : MatrixFileElementType::UInt32)
+			: (sizeof(T) == 8) ? (std::is_signed<T>::value ? MatrixFileElementType::Int64 : MatrixFileElementType::UInt64)
+			: MatrixFileElementType::Unsupported;
+	}
+
+
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Struct MatrixFileException, which is thrown if a matrix file cannot be written, read or mapped
+	struct MatrixFileException
+	{
+		std::string message;
+		std::string path;
+		MatrixFileException(std::string const & _message, std::string const & _path);
+	};
+
+
+	//Returns the header for a matrix of size size with entries of type elementType
+	MatrixFileHeader makeMatrixFileHeader(MatrixFileElementType elementType, std::size_t elementSize, MatrixSize const & size, MatrixFileLayout layout);
+
+	//Checks that bytes (fileSize bytes long) begins with a valid header for entries of type elementType and size elementSize
+	//and that the file holds all entries; throws MatrixFileException otherwise
+	MatrixFileHeader checkMatrixFileHeader(void const * bytes, std::uint64_t fileSize, MatrixFileElementType elementType, std::size_t elementSize, std::string const & path);
+
+
+
+	///////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class MappedFile, which maps a whole file read-only into memory (mmap on POSIX, MapViewOfFile on Windows)
+	//Pages are loaded on first access and shared through the page cache with every other process mapping the file
+	class MappedFile
+	{
+	private:
+		void const * mData;
+		std::size_t mSize;
+#ifdef _WIN32
+		void* mFile;
+		void* mMapping;
+#endif
+
+	public:
+		//Maps the file at path; throws MatrixFileException if it cannot be opened or mapped
+		explicit MappedFile(std::string const & path);
+		~MappedFile();
+
+		MappedFile(MappedFile && other);
+		MappedFile& operator=(MappedFile && other);
+		MappedFile(MappedFile const &) = delete;
+		MappedFile& operator=(MappedFile const &) = delete;
+
+		//Returns the first byte of the file
+		void const * data() const
+		{
+			return mData;
+		}
+
+		//Returns the size of the file in bytes
+		std::size_t getSize() const
+		{
+			return mSize;
+		}
+
+	private:
+		void unmap();
+
+	}; //Class: MappedFile
+
+
+
+	//Writes mat to the binary file at path (entries in the given layout); throws MatrixFileException on failure
+	template <typename T> void writeMatrixFile(std::string const & path, MatrixView<T const> const & mat, MatrixFileLayout layout = MatrixFileLayout::RowMajor)
+	{
+		static_assert(getMatrixFileElementType<T>() != MatrixFileElementType::Unsupported, "writeMatrixFile: T is not supported by the matrix file format!");
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file)
+		{
+			throw MatrixFileException("writeMatrixFile(std::string const & path, MatrixView<T const> const & mat, MatrixFileLayout layout): path cannot be opened for writing!", path);
+		}
+		MatrixFileHeader const header = makeMatrixFileHeader(getMatrixFileElementType<T>(), sizeof(T), mat.getSize(), layout);
+		file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+
+		if (layout == MatrixFileLayout::RowMajor)
+		{
+			for (unsigned int y = 0; y < mat.getSize().y(); ++y)
+			{
+				file.write(reinterpret_cast<char const *>(mat.rowPtr(y)), static_cast<std::streamsize>(mat.getSize().x() * sizeof(T)));
+			}
+		}
+		else
+		{
+			Matrix<T> transposed(XY(mat.getSize().y(), mat.getSize().x()));
+			Kernel::transpose<T>(mat.getSize().y(), mat.getSize().x(), mat.data(), mat.getStride(), transposed.data(), transposed.getStride());
+			file.write(reinterpret_cast<char const *>(transposed.data()), static_cast<std::streamsize>(transposed.getNumberOfEntries() * sizeof(T)));
+		}
+
+		file.flush();
+		if (!file)
+		{
+			throw MatrixFileException("writeMatrixFile(std::string const & path, MatrixView<T const> const & mat, MatrixFileLayout layout): writing failed!", path);
+		}
+	}
+
+
+	//Writes the entries referenced by mat to the binary file at path (entries in the given layout); throws MatrixFileException on failure
+	template <typename T> void writeMatrixFile(std::string const & path, MatrixView<T> const & mat, MatrixFileLayout layout = MatrixFileLayout::RowMajor)
+	{
+		writeMatrixFile<typename std::remove_const<T>::type>(path, MatrixView<T const>(mat), layout);
+	}
+
+
+	//Writes mat to the binary file at path (entries in the given layout); throws MatrixFileException on failure
+	template <typename T> void writeMatrixFile(std::string const & path, Matrix<T> const & mat, MatrixFileLayout layout = MatrixFileLayout::RowMajor)
+	{
+		writeMatrixFile<T>(path, mat.getView(), layout);
+	}
+
+
+	//Reads the binary file at path into a new matrix (both layouts); throws MatrixFileException if it is no valid file of T entries
+	template <typename T> Matrix<T> readMatrixFile(std::string const & path)
+	{
+		static_assert(getMatrixFileElementType<T>() != MatrixFileElementType::Unsupported, "readMatrixFile: T is not supported by the matrix file format!");
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file)
+		{
+			throw MatrixFileException("readMatrixFile(std::string const & path): path cannot be opened for reading!", path);
+		}
+		std::uint64_t const fileSize = static_cast<std::uint64_t>(file.tellg());
+		MatrixFileHeader header = MatrixFileHeader();
+		file.seekg(0);
+		file.read(reinterpret_cast<char*>(&header), std::min<std::uint64_t>(sizeof(header), fileSize));
+		header = checkMatrixFileHeader(&header, fileSize, getMatrixFileElementType<T>(), sizeof(T), path);
+
+		MatrixSize const size = XY(static_cast<unsigned int>(header.sizeX), static_cast<unsigned int>(header.sizeY));
+		bool const rowMajor = (header.layout == static_cast<std::uint32_t>(MatrixFileLayout::RowMajor));
+		unsigned int const lines = rowMajor ? size.y() : size.x();
+		unsigned int const lineLength = rowMajor ? size.x() : size.y();
+		Matrix<T> stored(XY(lineLength, lines));
+		for (unsigned int line = 0; line < lines; ++line)
+		{
+			file.seekg(static_cast<std::streamoff>(header.dataOffset + static_cast<std::uint64_t>(line) * header.stride * sizeof(T)));
+			file.read(reinterpret_cast<char*>(stored.rowPtr(line)), static_cast<std::streamsize>(lineLength * sizeof(T)));
+		}
+		if (!file)
+		{
+			throw MatrixFileException("readMatrixFile(std::string const & path): reading failed!", path);
+		}
+		if (!rowMajor)
+		{
+			stored.transpose();
+		}
+		return stored;
+	}
+
+
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template MatrixFileReader, which reads arbitrary blocks of a row-major matrix file with T entries
+	//(for files that are too large to be loaded or mapped as a whole)
+	template <typename T> class MatrixFileReader
+	{
+		static_assert(getMatrixFileElementType<T>() != MatrixFileElementType::Unsupported, "MatrixFileReader<T>: T is not supported by the matrix file format!");
+
+	private:
+		std::string mPath;
+		std::ifstream mFile;
+		MatrixFileHeader mHeader;
+
+	public:
+		//Constructor that opens the file at path; throws MatrixFileException if it is no valid row-major file of T entries
+		explicit MatrixFileReader(std::string const & path)
+			: mPath(path), mFile(path, std::ios::binary | std::ios::ate), mHeader()
+		{
+			if (!mFile)
+			{
+				throw MatrixFileException("MatrixFileReader<T>::MatrixFileReader(std::string const & path): path cannot be opened for reading!", path);
+			}
+			std::uint64_t const fileSize = static_cast<std::uint64_t>(mFile.tellg());
+			mFile.seekg(0);
+			mFile.read(reinterpret_cast<char*>(&mHeader), std::min<std::uint64_t>(sizeof(mHeader), fileSize));
+			mHeader = checkMatrixFileHeader(&mHeader, fileSize, getMatrixFileElementType<T>(), sizeof(T), path);
+			if (mHeader.layout != static_cast<std::uint32_t>(MatrixFileLayout::RowMajor))
+			{
+				throw MatrixFileException("MatrixFileReader<T>::MatrixFileReader(std::string const & path): only row-major files can be read blockwise!", path);
+			}
+		}
+
+
+		//Destructor and all other constructors stay default!
+
+
+	public:
+		//Returns the size of the stored matrix
+		MatrixSize getSize() const
+		{
+			return XY(static_cast<unsigned int>(mHeader.sizeX), static_cast<unsigned int>(mHeader.sizeY));
+		}
+
+
+		//Reads the block beginning at origin with size size into dst (row pitch ldd)
+		void readBlock(MatrixEntry const & origin, MatrixSize const & size, T* dst, std::size_t ldd)
+		{
+			if ((static_cast<std::uint64_t>(origin.x()) + size.x() > mHeader.sizeX) || (static_cast<std::uint64_t>(origin.y()) + size.y() > mHeader.sizeY))
+			{
+				throw InvalidIndicesException("MatrixFileReader<T>::readBlock(MatrixEntry const & origin, MatrixSize const & size, T* dst, std::size_t ldd): block is out of range!", origin);
+			}
+			if ((size.x() == mHeader.stride) && (ldd == size.x()))
+			{
+				//Whole rows into a packed buffer: one contiguous read
+				mFile.seekg(static_cast<std::streamoff>(mHeader.dataOffset + origin.y() * mHeader.stride * sizeof(T)));
+				mFile.read(reinterpret_cast<char*>(dst), static_cast<std::streamsize>(static_cast<std::uint64_t>(size.y()) * size.x() * sizeof(T)));
+			}
+			else
+			{
+				for (unsigned int y = 0; y < size.y(); ++y)
+				{
+					mFile.seekg(static_cast<std::streamoff>(mHeader.dataOffset + ((origin.y() + y) * mHeader.stride + origin.x()) * sizeof(T)));
+					mFile.read(reinterpret_cast<char*>(dst + y * ldd), static_cast<std::streamsize>(size.x() * sizeof(T)));
+				}
+			}
+			if (!mFile)
+			{
+				throw MatrixFileException("MatrixFileReader<T>::readBlock(MatrixEntry const & origin, MatrixSize const & size, T* dst, std::size_t ldd): reading failed!", mPath);
+			}
+		}
+
+
+	}; //Class Template: MatrixFileReader
+
+
+
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template MatrixFileWriter, which creates a row-major matrix file of a given size and fills it block by block
+	template <typename T> class MatrixFileWriter
+	{
+		static_assert(getMatrixFileElementType<T>() != MatrixFileElementType::Unsupported, "MatrixFileWriter<T>: T is not supported by the matrix file format!");
+
+	private:
+		std::string mPath;
+		std::ofstream mFile;
+		MatrixFileHeader mHeader;
+
+	public:
+		//Constructor that creates the file at path for a matrix of size size (entries that are never written stay zero)
+		MatrixFileWriter(std::string const & path, MatrixSize const & size)
+			: mPath(path), mFile(path, std::ios::binary | std::ios::trunc),
+			mHeader(makeMatrixFileHeader(getMatrixFileElementType<T>(), sizeof(T), size, MatrixFileLayout::RowMajor))
+		{
+			if (!mFile)
+			{
+				throw MatrixFileException("MatrixFileWriter<T>::MatrixFileWriter(std::string const & path, MatrixSize const & size): path cannot be opened for writing!", path);
+			}
+			mFile.write(reinterpret_cast<char const *>(&mHeader), sizeof(mHeader));
+
+			//Extend the file to its final size, so that blocks can be written in any order
+			std::uint64_t const dataSize = mHeader.sizeX * mHeader.sizeY * sizeof(T);
+			if (dataSize != 0)
+			{
+				mFile.seekp(static_cast<std::streamoff>(mHeader.dataOffset + dataSize - 1));
+				mFile.put('\0');
+			}
+			if (!mFile)
+			{
+				throw MatrixFileException("MatrixFileWriter<T>::MatrixFileWriter(std::string const & path, MatrixSize const & size): writing failed!", path);
+			}
+		}
+
+
+		//Destructor and all other constructors stay default!
+
+
+	public:
+		//Returns the size of the matrix in the file
+		MatrixSize getSize() const
+		{
+			return XY(static_cast<unsigned int>(mHeader.sizeX), static_cast<unsigned int>(mHeader.sizeY));
+		}
+
+
+		//Writes the block src (row pitch lds) of size size to origin
+		void writeBlock(MatrixEntry const & origin, MatrixSize const & size, T const * src, std::size_t lds)
+		{
+			if ((static_cast<std::uint64_t>(origin.x()) + size.x() > mHeader.sizeX) || (static_cast<std::uint64_t>(origin.y()) + size.y() > mHeader.sizeY))
+			{
+				throw InvalidIndicesException("MatrixFileWriter<T>::writeBlock(MatrixEntry const & origin, MatrixSize const & size, T const * src, std::size_t lds): block is out of range!", origin);
+			}
+			for (unsigned int y = 0; y < size.y(); ++y)
+			{
+				mFile.seekp(static_cast<std::streamoff>(mHeader.dataOffset + ((origin.y() + y) * mHeader.stride + origin.x()) * sizeof(T)));
+				mFile.write(reinterpret_cast<char const *>(src + y * lds), static_cast<std::streamsize>(size.x() * sizeof(T)));
+			}
+			if (!mFile)
+			{
+				throw MatrixFileException("MatrixFileWriter<T>::writeBlock(MatrixEntry const & origin, MatrixSize const & size, T const * src, std::size_t lds): writing failed!", mPath);
+			}
+		}
+
+
+		//Writes everything buffered to the file
+		void flush()
+		{
+			mFile.flush();
+			if (!mFile)
+			{
+				throw MatrixFileException("MatrixFileWriter<T>::flush(): writing failed!", mPath);
+			}
+		}
+
+
+	}; //Class Template: MatrixFileWriter
+
+
+
+	///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template MappedMatrix, which exposes a row-major matrix file as read-only matrix without copying it
+	//getView() takes part in all arithmetic like any other constant view; it stays valid as long as the MappedMatrix
+	template <typename T> class MappedMatrix
+	{
+		static_assert(getMatrixFileElementType<T>() != MatrixFileElementType::Unsupported, "MappedMatrix<T>: T is not supported by the matrix file format!");
+
+	public:
+		typedef T ValueType;
+
+	private:
+		MappedFile mFile;
+		MatrixSize mSize;
+		unsigned int mStride;
+		T const * mData;
+
+	public:
+		//Constructor that maps the file at path; throws MatrixFileException if it is no valid row-major file of T entries
+		explicit MappedMatrix(std::string const & path)
+			: mFile(path), mSize(XY(0u, 0u)), mStride(0), mData(nullptr)
+		{
+			MatrixFileHeader const header = checkMatrixFileHeader(mFile.data(), mFile.getSize(), getMatrixFileElementType<T>(), sizeof(T), path);
+			if (header.layout != static_cast<std::uint32_t>(MatrixFileLayout::RowMajor))
+			{
+				throw MatrixFileException("MappedMatrix<T>::MappedMatrix(std::string const & path): only row-major files can be mapped, use readMatrixFile!", path);
+			}
+			mSize = XY(static_cast<unsigned int>(header.sizeX), static_cast<unsigned int>(header.sizeY));
+			mStride = static_cast<unsigned int>(header.stride);
+			mData = reinterpret_cast<T const *>(static_cast<char const *>(mFile.data()) + header.dataOffset);
+		}
+
+
+		//Destructor and all other constructors stay default!
+
+
+	public:
+		//Returns the size of the matrix
+		MatrixSize getSize() const
+		{
+			return mSize;
+		}
+
+
+		//Returns the distance (in entries) between the starts of two rows
+		unsigned int getStride() const
+		{
+			return mStride;
+		}
+
+
+		//Gives direct access to the mapped entries
+		T const * data() const
+		{
+			return mData;
+		}
+
+
+		//Gives constant access to entries
+		T const & at(MatrixEntry const & pos) const
+		{
+			if ((pos.x() >= mSize.x()) || (pos.y() >= mSize.y()))
+			{
+				throw InvalidIndicesException("MappedMatrix<T>::at(MatrixEntry const & pos) const: pos is out of range!", pos);
+			}
+			return mData[static_cast<std::size_t>(pos.y()) * mStride + pos.x()];
+		}
+
+
+		//Returns a read-only view of the mapped entries
+		MatrixView<T const> getView() const
+		{
+			return MatrixView<T const>(mData, mSize, mStride);
+		}
+
+
+		//Copies the mapped entries into a new Matrix
+		Matrix<T> toMatrix() const
+		{
+			return this->getView().toMatrix();
+		}
+
+
+	}; //Class Template: MappedMatrix
+
+
+
+} //Namespace: Mat
+
+#endif //MATRIXFILE_HPP
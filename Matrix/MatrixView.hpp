@@ -0,0 +1,342 @@
+#ifndef MATRIX_VIEW_HPP
+#define MATRIX_VIEW_HPP
+
+#include <list>
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+
+#include "Expression.hpp"
+#include "StridedIterator.hpp"
+#include "Matrix.hpp"
+#include "VectorView.hpp"
+
+
+
+namespace Mat
+{
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template MatrixView, which references a block of a row-major buffer without owning it
+	//Entry (x, y) lives at data[y * stride + x]. MatrixView<T const> only reads. Views are cheap to copy (copies
+	//reference the same entries), but assigning to a view overwrites the referenced entries, just like assigning to a Matrix
+	template <typename T> class MatrixView : public MatrixExpression<MatrixView<T>>
+	{
+	public:
+		typedef typename std::remove_const<T>::type ValueType;
+		typedef T* row_iterator;
+		typedef StridedIterator<T> column_iterator;
+
+	private:
+		T* mData;
+		MatrixSize mSize;
+		unsigned int mStride; //Distance (in elements) between the starts of two consecutive rows
+
+	public:
+		//Standard constructor constructs an empty view
+		MatrixView()
+			: mData(nullptr), mSize(XY(0u, 0u)), mStride(0u)
+		{}
+
+
+		//Constructor that references the block of size size beginning at data with row pitch stride
+		MatrixView(T* data, MatrixSize const & size, unsigned int stride)
+			: mData(data), mSize(size), mStride(stride)
+		{}
+
+
+		//Mutable views convert implicitly to constant views
+		template <typename S, typename = typename std::enable_if<std::is_same<S const, T>::value && !std::is_same<S, T>::value>::type>
+		MatrixView(MatrixView<S> const & other)
+			: mData(other.data()), mSize(other.getSize()), mStride(other.getStride())
+		{}
+
+
+		MatrixView(MatrixView<T> const & other) = default;
+
+
+		//Copies the entries of other into the entries of this view
+		MatrixView<T>& operator=(MatrixView<T> const & other)
+		{
+			return this->assign(other);
+		}
+
+
+		//Evaluates a matrix expression into the entries of this view (sizes have to match)
+		template <typename E> typename std::enable_if<std::is_same<typename E::ValueType, ValueType>::value, MatrixView<T>&>::type
+		operator=(MatrixExpression<E> const & expression)
+		{
+			return this->assign(expression);
+		}
+
+
+	public:
+		//Returns the size of the view
+		MatrixSize getSize() const
+		{
+			return mSize;
+		}
+
+
+		//Returns the row pitch of the referenced buffer in elements
+		unsigned int getStride() const
+		{
+			return mStride;
+		}
+
+
+		//Returns a pointer to the entry (0, 0)
+		T* data() const
+		{
+			return mData;
+		}
+
+
+		//Returns a pointer to the first entry of row y (no bounds check)
+		T* rowPtr(unsigned int y) const
+		{
+			return mData + static_cast<std::size_t>(y) * mStride;
+		}
+
+
+		//Gives access to the components
+		T& at(MatrixEntry const & pos) const
+		{
+			if ((pos.x() >= mSize.x()) || (pos.y() >= mSize.y()))
+			{
+				throw InvalidIndicesException("MatrixView<T>::at(MatrixEntry const & pos) const: pos is out of range!", pos);
+			}
+			return mData[static_cast<std::size_t>(pos.y()) * mStride + pos.x()];
+		}
+
+
+		//Gives access to the entry in row row and column column (MN-mode), bounds are only checked in debug builds
+		T& operator()(unsigned int row, unsigned int column) const
+		{
+#ifdef MATRIX_DEBUG_CHECKS
+			if ((column >= mSize.x()) || (row >= mSize.y()))
+			{
+				throw InvalidIndicesException("MatrixView<T>::operator()(unsigned int row, unsigned int column) const: entry is out of range!", MN(row, column));
+			}
+#endif
+			return mData[static_cast<std::size_t>(row) * mStride + column];
+		}
+
+
+		//Iterators over the entries of row y (no bounds check; rows are contiguous even in views)
+		row_iterator rowBegin(unsigned int y) const
+		{
+			return this->rowPtr(y);
+		}
+
+		row_iterator rowEnd(unsigned int y) const
+		{
+			return this->rowPtr(y) + mSize.x();
+		}
+
+
+		//Iterators over the entries of column x (no bounds check)
+		column_iterator columnBegin(unsigned int x) const
+		{
+			return column_iterator(mData + x, mStride);
+		}
+
+		column_iterator columnEnd(unsigned int x) const
+		{
+			return column_iterator(mData + x, mStride) + mSize.y();
+		}
+
+
+		//Returns the entry at (x, y) without bounds check (used by the expression evaluation)
+		ValueType const & evaluateAt(unsigned int x, unsigned int y) const
+		{
+			return mData[static_cast<std::size_t>(y) * mStride + x];
+		}
+
+
+		//Returns whether writing the block of size size at data (row pitch stride) could change this before it is read
+		//Writing exactly the entries of this view is fine, because every entry is read right before it is written
+		bool mayAlias(ValueType const * data, unsigned int stride, MatrixSize const & size) const
+		{
+			if ((data == mData) && (stride == mStride))
+			{
+				return false;
+			}
+			return rangesOverlap<ValueType>(mData, MatrixView<T>::getEnd(mData, mStride, mSize), data, MatrixView<T>::getEnd(data, stride, size));
+		}
+
+
+		//Calculates trace
+		ValueType trace() const
+		{
+			ValueType sum = ValueType(0);
+			for (unsigned int i = 0; i < std::min(mSize.x(), mSize.y()); ++i)
+			{
+				sum += this->evaluateAt(i, i);
+			}
+			return sum;
+		}
+
+
+		//Finds all EntryPositions which have dist tolerance or less from val
+		std::list<MatrixEntry> find(ValueType const & val, ValueType const & tolerance = ValueType(0)) const
+		{
+			std::list<MatrixEntry> list;
+			for (unsigned int x = 0; x < mSize.x(); ++x)
+			{
+				for (unsigned int y = 0; y < mSize.y(); ++y)
+				{
+					if (std::abs(this->evaluateAt(x, y) - val) <= tolerance)
+					{
+						list.push_back(XY(x, y));
+					}
+				}
+			}
+			return list;
+		}
+
+
+		//Fills every referenced entry with value
+		void fillWith(ValueType const & value) const
+		{
+			for (unsigned int y = 0; y < mSize.y(); ++y)
+			{
+				std::fill(this->rowPtr(y), this->rowPtr(y) + mSize.x(), value);
+			}
+		}
+
+
+		//Returns a view of the block beginning at origin with size size (Non overlapping parts will be cut out, like in Matrix<T>::getSubmatrix)
+		MatrixView<T> getSubmatrixView(MatrixEntry const & origin, MatrixSize const & size) const
+		{
+			if ((origin.x() >= mSize.x()) || (origin.y() >= mSize.y()))
+			{
+				return MatrixView<T>(mData, XY(0u, 0u), mStride);
+			}
+			MatrixSize newSize = XY(std::min(mSize.x() - origin.x(), size.x()), std::min(mSize.y() - origin.y(), size.y()));
+			return MatrixView<T>(this->rowPtr(origin.y()) + origin.x(), newSize, mStride);
+		}
+
+
+		//Returns a view of row y
+		VectorView<T> getRowView(unsigned int y) const
+		{
+			if (y >= mSize.y())
+			{
+				throw InvalidIndicesException("MatrixView<T>::getRowView(unsigned int y) const: y is no valid y index!", XY(0, y));
+			}
+			return VectorView<T>(this->rowPtr(y), mSize.x(), 1u);
+		}
+
+
+		//Returns a view of column x
+		VectorView<T> getColumnView(unsigned int x) const
+		{
+			if (x >= mSize.x())
+			{
+				throw InvalidIndicesException("MatrixView<T>::getColumnView(unsigned int x) const: x is no valid x index!", XY(x, 0));
+			}
+			return VectorView<T>(mData + x, mSize.y(), mStride);
+		}
+
+
+		//Returns a view of the main diagonal
+		VectorView<T> getDiagonalView() const
+		{
+			return VectorView<T>(mData, std::min(mSize.x(), mSize.y()), mStride + 1);
+		}
+
+
+		//Copies the referenced entries into a new Matrix
+		Matrix<ValueType> toMatrix() const
+		{
+			return Matrix<ValueType>(*this);
+		}
+
+
+		//Adds m to the referenced entries
+		template <typename E> MatrixView<T>& operator+=(MatrixExpression<E> const & m)
+		{
+			return *this = *this + m;
+		}
+
+
+		//Subtracts m from the referenced entries
+		template <typename E> MatrixView<T>& operator-=(MatrixExpression<E> const & m)
+		{
+			return *this = *this - m;
+		}
+
+
+		//Multiplies the referenced entries by s
+		MatrixView<T>& operator*=(ValueType const & s)
+		{
+			return *this = *this * s;
+		}
+
+
+		//Divides the referenced entries by s
+		MatrixView<T>& operator/=(ValueType const & s)
+		{
+			return *this = *this / s;
+		}
+
+
+	private:
+		template <typename E> MatrixView<T>& assign(MatrixExpression<E> const & expression)
+		{
+			E const & e = expression.self();
+			if (e.getSize() != mSize)
+			{
+				throw IncompatibleMatrixSizesException("MatrixView<T>::operator=(MatrixExpression<E> const & expression): expression and view do not have the same size!", mSize, e.getSize());
+			}
+
+			//Overlapping operands are evaluated into a temporary first, so that no entry is overwritten before it is read
+			if (e.mayAlias(mData, mStride, mSize))
+			{
+				Matrix<ValueType> const temporary(e);
+				evaluateMatrixExpression(mData, mStride, temporary);
+			}
+			else
+			{
+				evaluateMatrixExpression(mData, mStride, e);
+			}
+			return *this;
+		}
+
+
+		//Returns the pointer behind the last referenced entry
+		template <typename P> static P* getEnd(P* data, unsigned int stride, MatrixSize const & size)
+		{
+			if ((size.x() == 0) || (size.y() == 0))
+			{
+				return data;
+			}
+			return data + static_cast<std::size_t>(size.y() - 1) * stride + size.x();
+		}
+
+
+	}; //Class Template: MatrixView
+
+
+	template <typename T> struct IsStoredMatrix<MatrixView<T>> : std::true_type {};
+
+
+	template <typename T> struct EvaluatedMatrix<MatrixView<T>>
+	{
+		MatrixView<typename MatrixView<T>::ValueType const> const view;
+		explicit EvaluatedMatrix(MatrixView<T> const & m) : view(m) {}
+	};
+
+
+	template <typename T> struct EvaluatedVector<VectorView<T>>
+	{
+		VectorView<typename VectorView<T>::ValueType const> const view;
+		explicit EvaluatedVector(VectorView<T> const & v) : view(v) {}
+	};
+
+
+
+} //Namespace: Mat
+
+#endif //MATRIX_VIEW_HPP
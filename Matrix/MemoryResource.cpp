@@ -0,0 +1,327 @@
+#include "MemoryResource.hpp"
+#include "AlignedAllocator.hpp"
+
+#include <cstdint>
+#include <algorithm>
+#include <new>
+
+
+namespace Mat
+{
+
+	namespace
+	{
+
+		//Resource on top of alignedAllocate and alignedFree
+		class HeapResource : public MemoryResource
+		{
+		private:
+			void* doAllocate(std::size_t bytes, std::size_t alignment) override
+			{
+				return alignedAllocate(bytes, std::max(alignment, sizeof(void*)));
+			}
+
+			void doDeallocate(void* ptr, std::size_t, std::size_t) override
+			{
+				alignedFree(ptr);
+			}
+		};
+
+
+		thread_local MemoryResource* sDefaultResource = nullptr;
+
+
+		std::size_t alignUp(std::size_t value, std::size_t alignment)
+		{
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+
+	} //Anonymous namespace
+
+
+
+	////////////////////////
+	//Resource management
+
+	MemoryResource* getHeapResource()
+	{
+		static HeapResource heap;
+		return &heap;
+	}
+
+
+	MemoryResource* getDefaultResource()
+	{
+		return (sDefaultResource != nullptr) ? sDefaultResource : getHeapResource();
+	}
+
+
+	MemoryResource* setDefaultResource(MemoryResource* resource)
+	{
+		MemoryResource* previous = getDefaultResource();
+		sDefaultResource = resource;
+		return previous;
+	}
+
+
+
+	/////////////////////////////
+	//Class ScopedMemoryResource
+
+	ScopedMemoryResource::ScopedMemoryResource(MemoryResource& resource)
+		: mPrevious(setDefaultResource(&resource))
+	{
+	}
+
+
+	ScopedMemoryResource::~ScopedMemoryResource()
+	{
+		setDefaultResource(mPrevious);
+	}
+
+
+
+	//////////////////////
+	//Class ArenaResource
+
+	ArenaResource::ArenaResource(std::size_t initialChunkSize, MemoryResource* upstream)
+		: mUpstream(upstream), mNextChunkSize(std::max<std::size_t>(initialChunkSize, BufferAlignment)), mChunks(), mCurrent(0), mOffset(0)
+	{
+	}
+
+
+	ArenaResource::~ArenaResource()
+	{
+		this->release();
+	}
+
+
+	void ArenaResource::reset()
+	{
+		mCurrent = 0;
+		mOffset = 0;
+	}
+
+
+	void ArenaResource::release()
+	{
+		for (Chunk const & chunk : mChunks)
+		{
+			mUpstream->deallocate(chunk.begin, chunk.size, BufferAlignment);
+		}
+		mChunks.clear();
+		this->reset();
+	}
+
+
+	std::size_t ArenaResource::getCapacity() const
+	{
+		std::size_t capacity = 0;
+		for (Chunk const & chunk : mChunks)
+		{
+			capacity += chunk.size;
+		}
+		return capacity;
+	}
+
+
+	void* ArenaResource::doAllocate(std::size_t bytes, std::size_t alignment)
+	{
+		bytes = std::max<std::size_t>(bytes, 1);
+
+		//Bump in the current chunk, or move on to the next chunk the request fits into
+		for (; mCurrent < mChunks.size(); ++mCurrent, mOffset = 0)
+		{
+			Chunk const & chunk = mChunks[mCurrent];
+			std::uintptr_t const base = reinterpret_cast<std::uintptr_t>(chunk.begin);
+			std::size_t const offset = alignUp(base + mOffset, alignment) - base;
+			if ((offset <= chunk.size) && (bytes <= chunk.size - offset))
+			{
+				mOffset = offset + bytes;
+				return chunk.begin + offset;
+			}
+		}
+
+		//No chunk left: add one that is at least twice as large as the last one
+		std::size_t const size = std::max(mNextChunkSize, alignUp(bytes, BufferAlignment) + std::max(alignment, BufferAlignment));
+		Chunk chunk = { static_cast<char*>(mUpstream->allocate(size, BufferAlignment)), size };
+		mChunks.push_back(chunk);
+		mNextChunkSize = 2 * size;
+		mCurrent = mChunks.size() - 1;
+		mOffset = 0;
+		return this->doAllocate(bytes, alignment);
+	}
+
+
+	void ArenaResource::doDeallocate(void*, std::size_t, std::size_t)
+	{
+		//Memory is only released by reset() and release()
+	}
+
+
+	ArenaResource& getThreadArena()
+	{
+		thread_local ArenaResource arena;
+		return arena;
+	}
+
+
+
+	/////////////////////
+	//Class PoolResource
+
+	const std::size_t PoolResource::PoolSmallestBlock;
+	const std::size_t PoolResource::PoolLargestBlock;
+	const std::size_t PoolResource::PoolSlabSize;
+
+
+	PoolResource::PoolResource(MemoryResource* upstream)
+		: mUpstream(upstream), mMutex(), mFreeLists(PoolResource::getSizeClass(PoolLargestBlock, 1) + 1, nullptr), mSlabs()
+	{
+	}
+
+
+	PoolResource::~PoolResource()
+	{
+		this->release();
+	}
+
+
+	void PoolResource::release()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		for (Slab const & slab : mSlabs)
+		{
+			mUpstream->deallocate(slab.begin, slab.size, BufferAlignment);
+		}
+		mSlabs.clear();
+		std::fill(mFreeLists.begin(), mFreeLists.end(), nullptr);
+	}
+
+
+	std::size_t PoolResource::getSizeClass(std::size_t bytes, std::size_t alignment)
+	{
+		if ((bytes > PoolLargestBlock) || (alignment > PoolSmallestBlock))
+		{
+			return static_cast<std::size_t>(-1);
+		}
+		std::size_t sizeClass = 0;
+		for (std::size_t blockSize = PoolSmallestBlock; blockSize < bytes; blockSize *= 2)
+		{
+			++sizeClass;
+		}
+		return sizeClass;
+	}
+
+
+	void* PoolResource::doAllocate(std::size_t bytes, std::size_t alignment)
+	{
+		std::size_t const sizeClass = PoolResource::getSizeClass(bytes, alignment);
+		if (sizeClass >= mFreeLists.size())
+		{
+			return mUpstream->allocate(bytes, alignment);
+		}
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		if (mFreeLists[sizeClass] == nullptr)
+		{
+			//Carve a new slab into blocks of this class and chain them into the free list
+			std::size_t const blockSize = PoolSmallestBlock << sizeClass;
+			std::size_t const slabSize = std::max(PoolSlabSize, blockSize);
+			char* slab = static_cast<char*>(mUpstream->allocate(slabSize, BufferAlignment));
+			Slab entry = { slab, slabSize };
+			mSlabs.push_back(entry);
+			for (std::size_t offset = slabSize; offset >= blockSize; offset -= blockSize)
+			{
+				void* block = slab + offset - blockSize;
+				*static_cast<void**>(block) = mFreeLists[sizeClass];
+				mFreeLists[sizeClass] = block;
+			}
+		}
+		void* block = mFreeLists[sizeClass];
+		mFreeLists[sizeClass] = *static_cast<void**>(block);
+		return block;
+	}
+
+
+	void PoolResource::doDeallocate(void* ptr, std::size_t bytes, std::size_t alignment)
+	{
+		std::size_t const sizeClass = PoolResource::getSizeClass(bytes, alignment);
+		if (sizeClass >= mFreeLists.size())
+		{
+			mUpstream->deallocate(ptr, bytes, alignment);
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		*static_cast<void**>(ptr) = mFreeLists[sizeClass];
+		mFreeLists[sizeClass] = ptr;
+	}
+
+
+
+
+	/////////////////////////
+	//Class CountingResource
+
+	CountingResource::CountingResource(MemoryResource* upstream)
+		: mUpstream(upstream), mAllocations(0), mDeallocations(0), mBytesInUse(0), mPeakBytesInUse(0)
+	{
+	}
+
+
+	std::size_t CountingResource::getAllocationCount() const
+	{
+		return mAllocations.load();
+	}
+
+
+	std::size_t CountingResource::getDeallocationCount() const
+	{
+		return mDeallocations.load();
+	}
+
+
+	std::size_t CountingResource::getBytesInUse() const
+	{
+		return mBytesInUse.load();
+	}
+
+
+	std::size_t CountingResource::getPeakBytesInUse() const
+	{
+		return mPeakBytesInUse.load();
+	}
+
+
+	void CountingResource::resetCounts()
+	{
+		mAllocations = 0;
+		mDeallocations = 0;
+		mPeakBytesInUse = mBytesInUse.load();
+	}
+
+
+	void* CountingResource::doAllocate(std::size_t bytes, std::size_t alignment)
+	{
+		void* ptr = mUpstream->allocate(bytes, alignment);
+		++mAllocations;
+		std::size_t const inUse = (mBytesInUse += bytes);
+		std::size_t peak = mPeakBytesInUse.load();
+		while ((inUse > peak) && !mPeakBytesInUse.compare_exchange_weak(peak, inUse))
+		{
+		}
+		return ptr;
+	}
+
+
+	void CountingResource::doDeallocate(void* ptr, std::size_t bytes, std::size_t alignment)
+	{
+		mUpstream->deallocate(ptr, bytes, alignment);
+		++mDeallocations;
+		mBytesInUse -= bytes;
+	}
+
+
+
+} //Namespace: Mat
@@ -0,0 +1,205 @@
+#ifndef MEMORYRESOURCE_HPP
+#define MEMORYRESOURCE_HPP
+
+#include <cstddef>
+#include <vector>
+#include <mutex>
+#include <atomic>
+
+
+
+namespace Mat
+{
+
+	///////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class MemoryResource, the interface every buffer of Matrix and Vector is allocated through
+	//Storage remembers the resource it came from and is always given back to it
+	class MemoryResource
+	{
+	public:
+		virtual ~MemoryResource() = default;
+
+		//Allocates bytes bytes aligned to alignment (a power of two); throws std::bad_alloc on failure
+		void* allocate(std::size_t bytes, std::size_t alignment)
+		{
+			return this->doAllocate(bytes, alignment);
+		}
+
+		//Gives back memory obtained from allocate with the same bytes and alignment
+		void deallocate(void* ptr, std::size_t bytes, std::size_t alignment)
+		{
+			this->doDeallocate(ptr, bytes, alignment);
+		}
+
+	private:
+		virtual void* doAllocate(std::size_t bytes, std::size_t alignment) = 0;
+		virtual void doDeallocate(void* ptr, std::size_t bytes, std::size_t alignment) = 0;
+
+	}; //Class: MemoryResource
+
+
+
+	//Returns the resource that allocates directly from the aligned global heap (thread-safe)
+	MemoryResource* getHeapResource();
+
+	//Returns the resource new matrices and vectors of the calling thread allocate from (the heap resource unless changed)
+	MemoryResource* getDefaultResource();
+
+	//Sets the default resource of the calling thread (nullptr restores the heap resource) and returns the previous one
+	MemoryResource* setDefaultResource(MemoryResource* resource);
+
+
+
+	////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class ScopedMemoryResource, which makes resource the default of the calling thread in its scope
+	class ScopedMemoryResource
+	{
+	private:
+		MemoryResource* mPrevious;
+
+	public:
+		explicit ScopedMemoryResource(MemoryResource& resource);
+		~ScopedMemoryResource();
+
+		ScopedMemoryResource(ScopedMemoryResource const &) = delete;
+		ScopedMemoryResource& operator=(ScopedMemoryResource const &) = delete;
+
+	}; //Class: ScopedMemoryResource
+
+
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class ArenaResource, a bump allocator: allocating is a pointer increment, deallocating does nothing,
+	//and reset() releases everything at once. Chunks are kept over resets, so a warmed-up arena stops allocating.
+	//Not synchronized: use one arena per thread (see getThreadArena). Storage from an arena must not be used after its reset
+	class ArenaResource : public MemoryResource
+	{
+	private:
+		struct Chunk
+		{
+			char* begin;
+			std::size_t size;
+		};
+
+		MemoryResource* mUpstream;
+		std::size_t mNextChunkSize;
+		std::vector<Chunk> mChunks;
+		std::size_t mCurrent; //Chunk allocations are bumped from
+		std::size_t mOffset; //First free byte in mChunks[mCurrent]
+
+	public:
+		explicit ArenaResource(std::size_t initialChunkSize = std::size_t(1) << 20, MemoryResource* upstream = getHeapResource());
+		~ArenaResource();
+
+		ArenaResource(ArenaResource const &) = delete;
+		ArenaResource& operator=(ArenaResource const &) = delete;
+
+		//Makes all chunks free again (everything allocated from the arena becomes invalid)
+		void reset();
+
+		//Like reset, but also gives all chunks back to the upstream resource
+		void release();
+
+		//Returns the total size of all chunks
+		std::size_t getCapacity() const;
+
+	private:
+		void* doAllocate(std::size_t bytes, std::size_t alignment) override;
+		void doDeallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+
+	}; //Class: ArenaResource
+
+
+	//Returns the arena of the calling thread
+	ArenaResource& getThreadArena();
+
+
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class PoolResource, which serves requests from free lists of power-of-two size classes (PoolSmallestBlock up to
+	//PoolLargestBlock bytes), carved from larger slabs; larger or more strictly aligned requests go to the upstream resource.
+	//Freed blocks are reused by later requests of the same class. Thread-safe
+	class PoolResource : public MemoryResource
+	{
+	public:
+		static const std::size_t PoolSmallestBlock = 64;
+		static const std::size_t PoolLargestBlock = std::size_t(1) << 20;
+		static const std::size_t PoolSlabSize = std::size_t(1) << 20;
+
+	private:
+		struct Slab
+		{
+			void* begin;
+			std::size_t size;
+		};
+
+		MemoryResource* mUpstream;
+		std::mutex mMutex;
+		std::vector<void*> mFreeLists; //One singly linked list per size class, the link is stored in the free block itself
+		std::vector<Slab> mSlabs;
+
+	public:
+		explicit PoolResource(MemoryResource* upstream = getHeapResource());
+		~PoolResource();
+
+		PoolResource(PoolResource const &) = delete;
+		PoolResource& operator=(PoolResource const &) = delete;
+
+		//Gives all slabs back to the upstream resource (everything allocated from the pool becomes invalid)
+		void release();
+
+	private:
+		void* doAllocate(std::size_t bytes, std::size_t alignment) override;
+		void doDeallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+
+		//Size class of a request, or std::size_t(-1) if it has to go upstream
+		static std::size_t getSizeClass(std::size_t bytes, std::size_t alignment);
+
+	}; //Class: PoolResource
+
+
+
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class CountingResource, which forwards to an upstream resource and counts allocations and bytes (thread-safe)
+	//E.g. to check that a loop of in-place updates does not allocate: make it the default resource and compare counts
+	class CountingResource : public MemoryResource
+	{
+	private:
+		MemoryResource* mUpstream;
+		std::atomic<std::size_t> mAllocations;
+		std::atomic<std::size_t> mDeallocations;
+		std::atomic<std::size_t> mBytesInUse;
+		std::atomic<std::size_t> mPeakBytesInUse;
+
+	public:
+		explicit CountingResource(MemoryResource* upstream = getHeapResource());
+
+		CountingResource(CountingResource const &) = delete;
+		CountingResource& operator=(CountingResource const &) = delete;
+
+		//Returns the number of allocations since construction or the last resetCounts()
+		std::size_t getAllocationCount() const;
+
+		//Returns the number of deallocations since construction or the last resetCounts()
+		std::size_t getDeallocationCount() const;
+
+		//Returns the number of bytes currently allocated through this resource
+		std::size_t getBytesInUse() const;
+
+		//Returns the largest value getBytesInUse() had since construction or the last resetCounts()
+		std::size_t getPeakBytesInUse() const;
+
+		//Sets the allocation and deallocation counts to zero and the peak to the bytes currently in use
+		void resetCounts();
+
+	private:
+		void* doAllocate(std::size_t bytes, std::size_t alignment) override;
+		void doDeallocate(void* ptr, std::size_t bytes, std::size_t alignment) override;
+
+	}; //Class: CountingResource
+
+
+
+} //Namespace: Mat
+
+#endif //MEMORYRESOURCE_HPP
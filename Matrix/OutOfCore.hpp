@@ -0,0 +1,191 @@
+#ifndef OUTOFCORE_HPP
+#define OUTOFCORE_HPP
+
+#include <cstddef>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <future>
+#include <algorithm>
+
+#include "Matrix.hpp"
+#include "MatrixFile.hpp"
+
+
+
+namespace Mat
+{
+	//Working set of the out-of-core products unless a memory budget is given (in bytes)
+	const std::size_t OutOfCoreDefaultMemoryBudget = std::size_t(1) << 30;
+
+	//Tiles of the out-of-core matrix product are at least this long on every side (unless the matrices are smaller),
+	//even if the memory budget is too small for that, since tinier tiles would spend all their time in I/O calls
+	const std::size_t OutOfCoreMinimumTileSize = 64;
+
+
+	namespace Kernel
+	{
+
+		//Runs load(0), then for every step s: waits for load(s), starts load(s + 1) in the background, and runs compute(s)
+		//(double buffering: load(s) has to fill buffer s % 2, which compute(s) then reads while load(s + 1) fills the other one)
+		template <typename Load, typename Compute> void streamDoubleBuffered(std::size_t steps, Load const & load, Compute const & compute)
+		{
+			if (steps == 0)
+			{
+				return;
+			}
+			std::future<void> pending = std::async(std::launch::async, load, std::size_t(0));
+			for (std::size_t step = 0; step < steps; ++step)
+			{
+				pending.get();
+				if (step + 1 < steps)
+				{
+					pending = std::async(std::launch::async, load, step + 1);
+				}
+				try
+				{
+					compute(step);
+				}
+				catch (...)
+				{
+					if (pending.valid())
+					{
+						pending.wait();
+					}
+					throw;
+				}
+			}
+		}
+
+	} //Namespace: Kernel
+
+
+
+	//Multiplies the matrices stored in the row-major files pathA and pathB and writes the product to the file pathC,
+	//keeping only tiles of A, B and C in memory: two tiles of A and B each (one being computed with, one being loaded
+	//in the background) and one of C, which together take at most about memoryBudget bytes.
+	//Every tile of C is accumulated over the whole inner dimension by the GEMM kernel and then written once
+	template <typename T> void multiplyMatrixFiles(std::string const & pathA, std::string const & pathB, std::string const & pathC, std::size_t memoryBudget = OutOfCoreDefaultMemoryBudget)
+	{
+		MatrixFileReader<T> readerA(pathA);
+		MatrixFileReader<T> readerB(pathB);
+		MatrixSize const sizeA = readerA.getSize();
+		MatrixSize const sizeB = readerB.getSize();
+		if (sizeA.n() != sizeB.m())
+		{
+			throw IncompatibleMatrixSizesException("multiplyMatrixFiles(std::string const & pathA, std::string const & pathB, std::string const & pathC, std::size_t memoryBudget): A and B cannot be multiplied!", sizeA, sizeB);
+		}
+		std::size_t const m = sizeA.m();
+		std::size_t const n = sizeB.n();
+		std::size_t const k = sizeA.n();
+		MatrixFileWriter<T> writerC(pathC, MN(static_cast<unsigned int>(m), static_cast<unsigned int>(n)));
+		if ((m == 0) || (n == 0))
+		{
+			writerC.flush();
+			return;
+		}
+
+		//Square C tiles of side t with 5 t^2 entries in total; the rest of the budget goes into the depth of the A and B tiles
+		std::size_t const entries = std::max<std::size_t>(memoryBudget / sizeof(T), 5);
+		std::size_t const t = std::max(OutOfCoreMinimumTileSize, static_cast<std::size_t>(std::sqrt(static_cast<double>(entries) / 5.0)));
+		std::size_t const mb = std::min(m, t);
+		std::size_t const nb = std::min(n, t);
+		std::size_t const kb = std::min(std::max<std::size_t>(k, 1), std::max(OutOfCoreMinimumTileSize, (entries - std::min(entries, mb * nb)) / (2 * (mb + nb))));
+
+		std::size_t const tilesM = (m + mb - 1) / mb;
+		std::size_t const tilesN = (n + nb - 1) / nb;
+		std::size_t const tilesK = std::max<std::size_t>(1, (k + kb - 1) / kb);
+
+		Matrix<T> tilesA[2] = { Matrix<T>(MN(static_cast<unsigned int>(mb), static_cast<unsigned int>(kb))), Matrix<T>(MN(static_cast<unsigned int>(mb), static_cast<unsigned int>(kb))) };
+		Matrix<T> tilesB[2] = { Matrix<T>(MN(static_cast<unsigned int>(kb), static_cast<unsigned int>(nb))), Matrix<T>(MN(static_cast<unsigned int>(kb), static_cast<unsigned int>(nb))) };
+		Matrix<T> tileC(MN(static_cast<unsigned int>(mb), static_cast<unsigned int>(nb)));
+
+		//Step s works on C tile s / tilesK (row-major order of tiles) and the inner block s % tilesK
+		struct Step
+		{
+			std::size_t ic, jc, pc, mc, nc, kc;
+		};
+		auto getStep = [&](std::size_t step)
+		{
+			std::size_t const tile = step / tilesK;
+			Step s;
+			s.ic = (tile / tilesN) * mb;
+			s.jc = (tile % tilesN) * nb;
+			s.pc = (step % tilesK) * kb;
+			s.mc = std::min(mb, m - s.ic);
+			s.nc = std::min(nb, n - s.jc);
+			s.kc = std::min(kb, k - std::min(k, s.pc));
+			return s;
+		};
+
+		auto load = [&](std::size_t step)
+		{
+			Step const s = getStep(step);
+			if (s.kc == 0)
+			{
+				return;
+			}
+			readerA.readBlock(XY(static_cast<unsigned int>(s.pc), static_cast<unsigned int>(s.ic)), MN(static_cast<unsigned int>(s.mc), static_cast<unsigned int>(s.kc)), tilesA[step % 2].data(), tilesA[step % 2].getStride());
+			readerB.readBlock(XY(static_cast<unsigned int>(s.jc), static_cast<unsigned int>(s.pc)), MN(static_cast<unsigned int>(s.kc), static_cast<unsigned int>(s.nc)), tilesB[step % 2].data(), tilesB[step % 2].getStride());
+		};
+
+		auto compute = [&](std::size_t step)
+		{
+			Step const s = getStep(step);
+			Matrix<T> const & a = tilesA[step % 2];
+			Matrix<T> const & b = tilesB[step % 2];
+			Kernel::gemm<T>(s.mc, s.nc, s.kc, T(1), a.data(), a.getStride(), 1, b.data(), b.getStride(), 1, (s.pc == 0) ? T(0) : T(1), tileC.data(), tileC.getStride());
+			if (step % tilesK == tilesK - 1)
+			{
+				writerC.writeBlock(XY(static_cast<unsigned int>(s.jc), static_cast<unsigned int>(s.ic)), MN(static_cast<unsigned int>(s.mc), static_cast<unsigned int>(s.nc)), tileC.data(), tileC.getStride());
+			}
+		};
+
+		Kernel::streamDoubleBuffered(tilesM * tilesN * tilesK, load, compute);
+		writerC.flush();
+	}
+
+
+	//Multiplies the matrix stored in the row-major file pathA with vec, streaming A in panels of rows:
+	//one panel is multiplied while the next one is loaded in the background, both together take at most about memoryBudget bytes
+	template <typename T> Vector<T> multiplyMatrixFile(std::string const & pathA, Vector<T> const & vec, std::size_t memoryBudget = OutOfCoreDefaultMemoryBudget)
+	{
+		MatrixFileReader<T> readerA(pathA);
+		MatrixSize const sizeA = readerA.getSize();
+		if (sizeA.x() != vec.getSize())
+		{
+			throw IncompatibleMatrixSizesException("multiplyMatrixFile(std::string const & pathA, Vector<T> const & vec, std::size_t memoryBudget): A's and vec's sizes are not compatible for matrix vector multiplication!", sizeA, XY(1, vec.getSize()));
+		}
+		std::size_t const m = sizeA.m();
+		std::size_t const n = sizeA.n();
+		Vector<T> res(static_cast<unsigned int>(m), T(0));
+		if ((m == 0) || (n == 0))
+		{
+			return res;
+		}
+
+		std::size_t const rows = std::min(m, std::max<std::size_t>(1, memoryBudget / (2 * n * sizeof(T))));
+		Matrix<T> panels[2] = { Matrix<T>(MN(static_cast<unsigned int>(rows), static_cast<unsigned int>(n))), Matrix<T>(MN(static_cast<unsigned int>(rows), static_cast<unsigned int>(n))) };
+
+		auto load = [&](std::size_t step)
+		{
+			std::size_t const row = step * rows;
+			readerA.readBlock(XY(0u, static_cast<unsigned int>(row)), MN(static_cast<unsigned int>(std::min(rows, m - row)), static_cast<unsigned int>(n)), panels[step % 2].data(), panels[step % 2].getStride());
+		};
+
+		auto compute = [&](std::size_t step)
+		{
+			std::size_t const row = step * rows;
+			Matrix<T> const & panel = panels[step % 2];
+			Kernel::gemv<T>(std::min(rows, m - row), n, T(1), panel.data(), panel.getStride(), 1, vec.data(), 1, T(0), res.data() + row, 1);
+		};
+
+		Kernel::streamDoubleBuffered((m + rows - 1) / rows, load, compute);
+		return res;
+	}
+
+
+
+} //Namespace: Mat
+
+#endif //OUTOFCORE_HPP
@@ -0,0 +1,279 @@
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+
+
+namespace Mat
+{
+	namespace Profiling
+	{
+
+		namespace
+		{
+
+			//Everything one thread recorded; its mutex is only contended while statistics are read or reset
+			struct ThreadRecord
+			{
+				std::mutex mutex;
+				std::uint32_t id;
+				std::map<char const *, OperationStatistics> statistics; //Keyed by the address of the name literal
+				std::vector<TraceEvent> events;
+			};
+
+
+			//Records stay alive until the end of the program, so that spans of finished threads can still be read
+			struct Registry
+			{
+				std::mutex mutex;
+				std::vector<std::unique_ptr<ThreadRecord>> records;
+			};
+
+
+			Registry& getRegistry()
+			{
+				static Registry registry;
+				return registry;
+			}
+
+
+			ThreadRecord& getThreadRecord()
+			{
+				thread_local ThreadRecord* record = nullptr;
+				if (record == nullptr)
+				{
+					Registry& registry = getRegistry();
+					std::lock_guard<std::mutex> lock(registry.mutex);
+					registry.records.emplace_back(new ThreadRecord());
+					record = registry.records.back().get();
+					record->id = static_cast<std::uint32_t>(registry.records.size());
+				}
+				return *record;
+			}
+
+
+			thread_local std::uint64_t sBytesAllocated = 0;
+
+
+			std::uint64_t now()
+			{
+				typedef std::chrono::steady_clock Clock;
+				static Clock::time_point const epoch = Clock::now();
+				return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch).count());
+			}
+
+
+			std::uint64_t getEntries(unsigned int x, unsigned int y)
+			{
+				return static_cast<std::uint64_t>(x) * y;
+			}
+
+
+			//Writes name as JSON string (the names are identifiers, but quotes and backslashes are escaped anyway)
+			void writeJsonString(std::ostream& oStream, char const * name)
+			{
+				oStream << '"';
+				for (char const * c = name; *c != '\0'; ++c)
+				{
+					if ((*c == '"') || (*c == '\\'))
+					{
+						oStream << '\\';
+					}
+					oStream << *c;
+				}
+				oStream << '"';
+			}
+
+		} //Anonymous namespace
+
+
+
+		///////////////////////
+		//Statistics and trace
+
+		std::vector<OperationStatistics> getStatistics()
+		{
+			std::map<std::string, OperationStatistics> merged;
+			Registry& registry = getRegistry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			for (auto const & record : registry.records)
+			{
+				std::lock_guard<std::mutex> recordLock(record->mutex);
+				for (auto const & entry : record->statistics)
+				{
+					OperationStatistics const & s = entry.second;
+					auto inserted = merged.insert(std::make_pair(s.name, s));
+					if (!inserted.second)
+					{
+						OperationStatistics& m = inserted.first->second;
+						m.calls += s.calls;
+						m.nanoseconds += s.nanoseconds;
+						m.flops += s.flops;
+						m.bytesAllocated += s.bytesAllocated;
+						m.operandEntries += s.operandEntries;
+						m.largestOperandEntries = std::max(m.largestOperandEntries, s.largestOperandEntries);
+					}
+				}
+			}
+
+			std::vector<OperationStatistics> statistics;
+			statistics.reserve(merged.size());
+			for (auto const & entry : merged)
+			{
+				statistics.push_back(entry.second);
+			}
+			return statistics;
+		}
+
+
+		std::vector<TraceEvent> getTraceEvents()
+		{
+			std::vector<TraceEvent> events;
+			Registry& registry = getRegistry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			for (auto const & record : registry.records)
+			{
+				std::lock_guard<std::mutex> recordLock(record->mutex);
+				events.insert(events.end(), record->events.begin(), record->events.end());
+			}
+			std::stable_sort(events.begin(), events.end(), [](TraceEvent const & a, TraceEvent const & b)
+			{
+				return a.start < b.start;
+			});
+			return events;
+		}
+
+
+		void reset()
+		{
+			Registry& registry = getRegistry();
+			std::lock_guard<std::mutex> lock(registry.mutex);
+			for (auto const & record : registry.records)
+			{
+				std::lock_guard<std::mutex> recordLock(record->mutex);
+				record->statistics.clear();
+				record->events.clear();
+			}
+		}
+
+
+		void writeChromeTrace(std::string const & path)
+		{
+			std::vector<TraceEvent> const events = getTraceEvents();
+			std::ofstream file(path);
+			if (!file)
+			{
+				throw std::runtime_error("Profiling::writeChromeTrace(std::string const & path): path cannot be written!");
+			}
+
+			//Complete events ("ph": "X") with timestamps and durations in microseconds
+			file << std::fixed << std::setprecision(3);
+			file << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+			for (std::size_t i = 0; i < events.size(); ++i)
+			{
+				TraceEvent const & e = events[i];
+				file << ((i == 0) ? "\n" : ",\n");
+				file << "{\"name\": ";
+				writeJsonString(file, e.name);
+				file << ", \"cat\": \"Matrix\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << e.thread
+					<< ", \"ts\": " << static_cast<double>(e.start) * 1e-3 << ", \"dur\": " << static_cast<double>(e.duration) * 1e-3
+					<< ", \"args\": {\"flops\": " << std::setprecision(0) << e.flops << std::setprecision(3)
+					<< ", \"bytesAllocated\": " << e.bytesAllocated
+					<< ", \"operand1\": \"" << e.operandSizes[0] << "x" << e.operandSizes[1] << "\"";
+				if ((e.operandSizes[2] != 0) || (e.operandSizes[3] != 0))
+				{
+					file << ", \"operand2\": \"" << e.operandSizes[2] << "x" << e.operandSizes[3] << "\"";
+				}
+				file << "}}";
+			}
+			file << "\n]}\n";
+			if (!file)
+			{
+				throw std::runtime_error("Profiling::writeChromeTrace(std::string const & path): path cannot be written!");
+			}
+		}
+
+
+		void printStatistics(std::ostream& oStream)
+		{
+			std::ios::fmtflags const flags = oStream.flags();
+			oStream << std::left << std::setw(28) << "operation" << std::right << std::setw(10) << "calls" << std::setw(14) << "time [ms]"
+				<< std::setw(12) << "GFLOP/s" << std::setw(16) << "bytes alloc." << std::setw(16) << "largest operand" << '\n';
+			oStream << std::fixed;
+			for (OperationStatistics const & s : getStatistics())
+			{
+				double const seconds = static_cast<double>(s.nanoseconds) * 1e-9;
+				oStream << std::left << std::setw(28) << s.name << std::right << std::setw(10) << s.calls
+					<< std::setw(14) << std::setprecision(3) << seconds * 1e3
+					<< std::setw(12) << std::setprecision(3) << ((seconds > 0.0) ? s.flops / seconds * 1e-9 : 0.0)
+					<< std::setw(16) << s.bytesAllocated << std::setw(16) << s.largestOperandEntries << '\n';
+			}
+			oStream.flags(flags);
+		}
+
+
+		void recordAllocation(std::size_t bytes)
+		{
+			sBytesAllocated += bytes;
+		}
+
+
+
+		/////////////
+		//Class Span
+
+		Span::Span(char const * name, double flops, unsigned int sizeX1, unsigned int sizeY1, unsigned int sizeX2, unsigned int sizeY2)
+			: mName(name), mFlops(flops), mOperandSizes{ sizeX1, sizeY1, sizeX2, sizeY2 }, mStart(now()), mAllocatedAtStart(sBytesAllocated)
+		{
+		}
+
+
+		Span::~Span()
+		{
+			std::uint64_t const duration = now() - mStart;
+			std::uint64_t const allocated = sBytesAllocated - mAllocatedAtStart;
+			std::uint64_t const entries1 = getEntries(mOperandSizes[0], mOperandSizes[1]);
+			std::uint64_t const entries2 = getEntries(mOperandSizes[2], mOperandSizes[3]);
+
+			ThreadRecord& record = getThreadRecord();
+			std::lock_guard<std::mutex> lock(record.mutex);
+			auto found = record.statistics.find(mName);
+			if (found == record.statistics.end())
+			{
+				OperationStatistics s = OperationStatistics();
+				s.name = mName;
+				found = record.statistics.insert(std::make_pair(mName, s)).first;
+			}
+			OperationStatistics& s = found->second;
+			s.calls += 1;
+			s.nanoseconds += duration;
+			s.flops += mFlops;
+			s.bytesAllocated += allocated;
+			s.operandEntries += entries1 + entries2;
+			s.largestOperandEntries = std::max(s.largestOperandEntries, std::max(entries1, entries2));
+
+			if (record.events.size() < MaxTraceEventsPerThread)
+			{
+				TraceEvent e;
+				e.name = mName;
+				e.start = mStart;
+				e.duration = duration;
+				e.thread = record.id;
+				e.flops = mFlops;
+				e.bytesAllocated = allocated;
+				std::memcpy(e.operandSizes, mOperandSizes, sizeof(e.operandSizes));
+				record.events.push_back(e);
+			}
+		}
+
+	} //Namespace: Profiling
+
+} //Namespace: Mat
@@ -0,0 +1,109 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <iosfwd>
+#include <vector>
+
+
+
+//Instrumentation of the main Matrix and Vector operations is compiled in only if MATRIX_ENABLE_PROFILING is defined
+//(CMake option MATRIX_PROFILING); otherwise MATRIX_PROFILE expands to nothing and its arguments are not evaluated.
+//The API below always exists, so code reading the statistics builds either way (they just stay empty).
+//MATRIX_PROFILE(name, flops, sizeX1, sizeY1[, sizeX2, sizeY2]) opens a span lasting until the end of the enclosing scope,
+//name has to be a string literal (it is stored by pointer)
+#ifdef MATRIX_ENABLE_PROFILING
+#define MATRIX_PROFILE_CONCATENATE_IMPL(a, b) a##b
+#define MATRIX_PROFILE_CONCATENATE(a, b) MATRIX_PROFILE_CONCATENATE_IMPL(a, b)
+#define MATRIX_PROFILE(...) ::Mat::Profiling::Span MATRIX_PROFILE_CONCATENATE(matrixProfilingSpan, __LINE__)(__VA_ARGS__)
+#else
+#define MATRIX_PROFILE(...) static_cast<void>(0)
+#endif
+
+
+
+namespace Mat
+{
+	namespace Profiling
+	{
+
+		//At most this many trace events are kept per thread; later spans still update the statistics
+		const std::size_t MaxTraceEventsPerThread = std::size_t(1) << 20;
+
+
+		////////////////////////////////////////////////////////////////////////////
+		//Struct OperationStatistics, which accumulates all calls of one operation
+		struct OperationStatistics
+		{
+			std::string name;
+			std::uint64_t calls;
+			std::uint64_t nanoseconds; //Cumulative wall time (nested operations are included in the time of the outer one)
+			double flops; //Cumulative floating point (or integer) operations
+			std::uint64_t bytesAllocated; //Cumulative bytes of Matrix and Vector buffers allocated while the operation ran
+			std::uint64_t operandEntries; //Cumulative number of entries of all operands
+			std::uint64_t largestOperandEntries; //Number of entries of the largest operand seen
+		};
+
+
+		/////////////////////////////////////////////////////////////////////////////////////////////
+		//Struct TraceEvent, one recorded span (times in nanoseconds since the first recorded span)
+		struct TraceEvent
+		{
+			char const * name;
+			std::uint64_t start;
+			std::uint64_t duration;
+			std::uint32_t thread; //Small id, assigned in the order threads record their first span
+			double flops;
+			std::uint64_t bytesAllocated;
+			unsigned int operandSizes[4]; //x and y of the first and second operand (0 if there is none)
+		};
+
+
+		//Returns the statistics of all operations recorded since the start or the last reset, sorted by name
+		std::vector<OperationStatistics> getStatistics();
+
+		//Returns the trace events recorded since the start or the last reset, sorted by start time
+		std::vector<TraceEvent> getTraceEvents();
+
+		//Clears statistics and trace events of all threads
+		void reset();
+
+		//Writes the trace events in the Chrome trace event format (JSON), viewable in chrome://tracing or Perfetto
+		//Throws std::runtime_error if path cannot be written
+		void writeChromeTrace(std::string const & path);
+
+		//Prints a table of getStatistics() to oStream
+		void printStatistics(std::ostream& oStream);
+
+		//Adds bytes to the allocation counter of the calling thread (called by AlignedAllocator::allocate for every Matrix and Vector buffer)
+		void recordAllocation(std::size_t bytes);
+
+
+
+		////////////////////////////////////////////////////////////////////////////////////////////
+		//Class Span, which measures its own lifetime and records it as one call of operation name
+		class Span
+		{
+		private:
+			char const * mName;
+			double mFlops;
+			unsigned int mOperandSizes[4];
+			std::uint64_t mStart;
+			std::uint64_t mAllocatedAtStart;
+
+		public:
+			Span(char const * name, double flops, unsigned int sizeX1, unsigned int sizeY1, unsigned int sizeX2 = 0, unsigned int sizeY2 = 0);
+			~Span();
+
+			Span(Span const &) = delete;
+			Span& operator=(Span const &) = delete;
+
+		}; //Class: Span
+
+	} //Namespace: Profiling
+
+} //Namespace: Mat
+
+#endif //PROFILER_HPP
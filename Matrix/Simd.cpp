@@ -0,0 +1,1075 @@
+#include "Simd.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MAT_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+//GCC and Clang need per-function target attributes to emit instructions beyond the compile flags; MSVC does not
+#if defined(MAT_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define MAT_TARGET_SSE2 __attribute__((target("sse2")))
+#define MAT_TARGET_AVX2 __attribute__((target("avx2")))
+#define MAT_TARGET_AVX512 __attribute__((target("avx512f,avx512dq")))
+#else
+#define MAT_TARGET_SSE2
+#define MAT_TARGET_AVX2
+#define MAT_TARGET_AVX512
+#endif
+
+
+namespace Mat
+{
+	namespace Simd
+	{
+
+		namespace
+		{
+
+			////////////////////
+			//CPU feature check
+
+#ifdef MAT_SIMD_X86
+			void cpuid(unsigned int leaf, unsigned int subLeaf, unsigned int regs[4])
+			{
+#if defined(_MSC_VER)
+				int r[4];
+				__cpuidex(r, static_cast<int>(leaf), static_cast<int>(subLeaf));
+				for (int i = 0; i < 4; ++i)
+				{
+					regs[i] = static_cast<unsigned int>(r[i]);
+				}
+#else
+				regs[0] = regs[1] = regs[2] = regs[3] = 0;
+				__cpuid_count(leaf, subLeaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+			}
+
+
+			//Reads XCR0, which tells which register states the operating system saves on context switches
+			unsigned long long readXcr0()
+			{
+#if defined(_MSC_VER)
+				return _xgetbv(0);
+#else
+				unsigned int lo = 0;
+				unsigned int hi = 0;
+				__asm__ volatile ("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+				return (static_cast<unsigned long long>(hi) << 32) | lo;
+#endif
+			}
+#endif
+
+
+			InstructionSet detectInstructionSet()
+			{
+#ifdef MAT_SIMD_X86
+				unsigned int regs[4];
+				cpuid(0, 0, regs);
+				unsigned int const maxLeaf = regs[0];
+				if (maxLeaf < 1)
+				{
+					return InstructionSet::Scalar;
+				}
+
+				cpuid(1, 0, regs);
+				bool const sse2 = (regs[3] & (1u << 26)) != 0;
+				bool const osxsave = (regs[2] & (1u << 27)) != 0;
+				bool const avx = (regs[2] & (1u << 28)) != 0;
+				if (!sse2)
+				{
+					return InstructionSet::Scalar;
+				}
+				if (!osxsave || !avx || (maxLeaf < 7))
+				{
+					return InstructionSet::SSE2;
+				}
+
+				unsigned long long const xcr0 = readXcr0();
+				bool const ymmState = (xcr0 & 0x6) == 0x6;
+				bool const zmmState = (xcr0 & 0xE6) == 0xE6;
+
+				cpuid(7, 0, regs);
+				bool const avx2 = (regs[1] & (1u << 5)) != 0;
+				bool const avx512f = (regs[1] & (1u << 16)) != 0;
+				bool const avx512dq = (regs[1] & (1u << 17)) != 0;
+
+				if (avx512f && avx512dq && zmmState)
+				{
+					return InstructionSet::AVX512;
+				}
+				if (avx2 && ymmState)
+				{
+					return InstructionSet::AVX2;
+				}
+				return InstructionSet::SSE2;
+#else
+				return InstructionSet::Scalar;
+#endif
+			}
+
+
+			std::atomic<int>& activeInstructionSet()
+			{
+				static std::atomic<int> active(static_cast<int>(getSupportedInstructionSet()));
+				return active;
+			}
+
+
+
+			////////////////////////////////////////////////////////////////////////////////////////////////
+			//Register wrappers: one struct per instruction set and element type with the operations we need
+
+#ifdef MAT_SIMD_X86
+			struct Sse2Float
+			{
+				typedef __m128 Register;
+				static const std::size_t Width = 4;
+				MAT_TARGET_SSE2 static Register load(float const * p) { return _mm_loadu_ps(p); }
+				MAT_TARGET_SSE2 static void store(float* p, Register r) { _mm_storeu_ps(p, r); }
+				MAT_TARGET_SSE2 static Register set1(float s) { return _mm_set1_ps(s); }
+				MAT_TARGET_SSE2 static Register add(Register a, Register b) { return _mm_add_ps(a, b); }
+				MAT_TARGET_SSE2 static Register sub(Register a, Register b) { return _mm_sub_ps(a, b); }
+				MAT_TARGET_SSE2 static Register mul(Register a, Register b) { return _mm_mul_ps(a, b); }
+				MAT_TARGET_SSE2 static Register div(Register a, Register b) { return _mm_div_ps(a, b); }
+				MAT_TARGET_SSE2 static Register neg(Register a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+				MAT_TARGET_SSE2 static Register abs(Register a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+				//max and min return b if either operand is NaN (same for all wrappers), so NaN entries passed as a are skipped
+				MAT_TARGET_SSE2 static Register max(Register a, Register b) { return _mm_max_ps(a, b); }
+				MAT_TARGET_SSE2 static Register min(Register a, Register b) { return _mm_min_ps(a, b); }
+				//Bit i is set if lane i of a is less or equal to lane i of b (false for NaN)
+				MAT_TARGET_SSE2 static unsigned int lessEqualMask(Register a, Register b) { return static_cast<unsigned int>(_mm_movemask_ps(_mm_cmple_ps(a, b))); }
+			};
+
+			struct Sse2Double
+			{
+				typedef __m128d Register;
+				static const std::size_t Width = 2;
+				MAT_TARGET_SSE2 static Register load(double const * p) { return _mm_loadu_pd(p); }
+				MAT_TARGET_SSE2 static void store(double* p, Register r) { _mm_storeu_pd(p, r); }
+				MAT_TARGET_SSE2 static Register set1(double s) { return _mm_set1_pd(s); }
+				MAT_TARGET_SSE2 static Register add(Register a, Register b) { return _mm_add_pd(a, b); }
+				MAT_TARGET_SSE2 static Register sub(Register a, Register b) { return _mm_sub_pd(a, b); }
+				MAT_TARGET_SSE2 static Register mul(Register a, Register b) { return _mm_mul_pd(a, b); }
+				MAT_TARGET_SSE2 static Register div(Register a, Register b) { return _mm_div_pd(a, b); }
+				MAT_TARGET_SSE2 static Register neg(Register a) { return _mm_xor_pd(a, _mm_set1_pd(-0.0)); }
+				MAT_TARGET_SSE2 static Register abs(Register a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+				MAT_TARGET_SSE2 static Register max(Register a, Register b) { return _mm_max_pd(a, b); }
+				MAT_TARGET_SSE2 static Register min(Register a, Register b) { return _mm_min_pd(a, b); }
+				MAT_TARGET_SSE2 static unsigned int lessEqualMask(Register a, Register b) { return static_cast<unsigned int>(_mm_movemask_pd(_mm_cmple_pd(a, b))); }
+			};
+
+			template <typename E> struct Sse2Int32
+			{
+				typedef __m128i Register;
+				static const std::size_t Width = 4;
+				MAT_TARGET_SSE2 static Register load(E const * p) { return _mm_loadu_si128(reinterpret_cast<__m128i const *>(p)); }
+				MAT_TARGET_SSE2 static void store(E* p, Register r) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), r); }
+				MAT_TARGET_SSE2 static Register set1(E s) { return _mm_set1_epi32(static_cast<int>(s)); }
+				MAT_TARGET_SSE2 static Register add(Register a, Register b) { return _mm_add_epi32(a, b); }
+				MAT_TARGET_SSE2 static Register sub(Register a, Register b) { return _mm_sub_epi32(a, b); }
+				MAT_TARGET_SSE2 static Register neg(Register a) { return _mm_sub_epi32(_mm_setzero_si128(), a); }
+				//SSE2 has no 32 bit low multiply: multiply even and odd lanes separately and interleave the low halves
+				MAT_TARGET_SSE2 static Register mul(Register a, Register b)
+				{
+					__m128i even = _mm_mul_epu32(a, b);
+					__m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+					return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+				}
+			};
+
+			template <typename E> struct Sse2Int64
+			{
+				typedef __m128i Register;
+				static const std::size_t Width = 2;
+				MAT_TARGET_SSE2 static Register load(E const * p) { return _mm_loadu_si128(reinterpret_cast<__m128i const *>(p)); }
+				MAT_TARGET_SSE2 static void store(E* p, Register r) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), r); }
+				MAT_TARGET_SSE2 static Register set1(E s) { return _mm_set1_epi64x(static_cast<long long>(s)); }
+				MAT_TARGET_SSE2 static Register add(Register a, Register b) { return _mm_add_epi64(a, b); }
+				MAT_TARGET_SSE2 static Register sub(Register a, Register b) { return _mm_sub_epi64(a, b); }
+				MAT_TARGET_SSE2 static Register neg(Register a) { return _mm_sub_epi64(_mm_setzero_si128(), a); }
+				//Low 64 bits of the product from three 32 x 32 -> 64 bit multiplies
+				MAT_TARGET_SSE2 static Register mul(Register a, Register b)
+				{
+					__m128i lowLow = _mm_mul_epu32(a, b);
+					__m128i lowHigh = _mm_mul_epu32(a, _mm_srli_epi64(b, 32));
+					__m128i highLow = _mm_mul_epu32(_mm_srli_epi64(a, 32), b);
+					return _mm_add_epi64(lowLow, _mm_slli_epi64(_mm_add_epi64(lowHigh, highLow), 32));
+				}
+			};
+
+
+			struct Avx2Float
+			{
+				typedef __m256 Register;
+				static const std::size_t Width = 8;
+				MAT_TARGET_AVX2 static Register load(float const * p) { return _mm256_loadu_ps(p); }
+				MAT_TARGET_AVX2 static void store(float* p, Register r) { _mm256_storeu_ps(p, r); }
+				MAT_TARGET_AVX2 static Register set1(float s) { return _mm256_set1_ps(s); }
+				MAT_TARGET_AVX2 static Register add(Register a, Register b) { return _mm256_add_ps(a, b); }
+				MAT_TARGET_AVX2 static Register sub(Register a, Register b) { return _mm256_sub_ps(a, b); }
+				MAT_TARGET_AVX2 static Register mul(Register a, Register b) { return _mm256_mul_ps(a, b); }
+				MAT_TARGET_AVX2 static Register div(Register a, Register b) { return _mm256_div_ps(a, b); }
+				MAT_TARGET_AVX2 static Register neg(Register a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+				MAT_TARGET_AVX2 static Register abs(Register a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+				MAT_TARGET_AVX2 static Register max(Register a, Register b) { return _mm256_max_ps(a, b); }
+				MAT_TARGET_AVX2 static Register min(Register a, Register b) { return _mm256_min_ps(a, b); }
+				MAT_TARGET_AVX2 static unsigned int lessEqualMask(Register a, Register b) { return static_cast<unsigned int>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LE_OQ))); }
+			};
+
+			struct Avx2Double
+			{
+				typedef __m256d Register;
+				static const std::size_t Width = 4;
+				MAT_TARGET_AVX2 static Register load(double const * p) { return _mm256_loadu_pd(p); }
+				MAT_TARGET_AVX2 static void store(double* p, Register r) { _mm256_storeu_pd(p, r); }
+				MAT_TARGET_AVX2 static Register set1(double s) { return _mm256_set1_pd(s); }
+				MAT_TARGET_AVX2 static Register add(Register a, Register b) { return _mm256_add_pd(a, b); }
+				MAT_TARGET_AVX2 static Register sub(Register a, Register b) { return _mm256_sub_pd(a, b); }
+				MAT_TARGET_AVX2 static Register mul(Register a, Register b) { return _mm256_mul_pd(a, b); }
+				MAT_TARGET_AVX2 static Register div(Register a, Register b) { return _mm256_div_pd(a, b); }
+				MAT_TARGET_AVX2 static Register neg(Register a) { return _mm256_xor_pd(a, _mm256_set1_pd(-0.0)); }
+				MAT_TARGET_AVX2 static Register abs(Register a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+				MAT_TARGET_AVX2 static Register max(Register a, Register b) { return _mm256_max_pd(a, b); }
+				MAT_TARGET_AVX2 static Register min(Register a, Register b) { return _mm256_min_pd(a, b); }
+				MAT_TARGET_AVX2 static unsigned int lessEqualMask(Register a, Register b) { return static_cast<unsigned int>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LE_OQ))); }
+			};
+
+			template <typename E> struct Avx2Int32
+			{
+				typedef __m256i Register;
+				static const std::size_t Width = 8;
+				MAT_TARGET_AVX2 static Register load(E const * p) { return _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p)); }
+				MAT_TARGET_AVX2 static void store(E* p, Register r) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), r); }
+				MAT_TARGET_AVX2 static Register set1(E s) { return _mm256_set1_epi32(static_cast<int>(s)); }
+				MAT_TARGET_AVX2 static Register add(Register a, Register b) { return _mm256_add_epi32(a, b); }
+				MAT_TARGET_AVX2 static Register sub(Register a, Register b) { return _mm256_sub_epi32(a, b); }
+				MAT_TARGET_AVX2 static Register mul(Register a, Register b) { return _mm256_mullo_epi32(a, b); }
+				MAT_TARGET_AVX2 static Register neg(Register a) { return _mm256_sub_epi32(_mm256_setzero_si256(), a); }
+			};
+
+			template <typename E> struct Avx2Int64
+			{
+				typedef __m256i Register;
+				static const std::size_t Width = 4;
+				MAT_TARGET_AVX2 static Register load(E const * p) { return _mm256_loadu_si256(reinterpret_cast<__m256i const *>(p)); }
+				MAT_TARGET_AVX2 static void store(E* p, Register r) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), r); }
+				MAT_TARGET_AVX2 static Register set1(E s) { return _mm256_set1_epi64x(static_cast<long long>(s)); }
+				MAT_TARGET_AVX2 static Register add(Register a, Register b) { return _mm256_add_epi64(a, b); }
+				MAT_TARGET_AVX2 static Register sub(Register a, Register b) { return _mm256_sub_epi64(a, b); }
+				MAT_TARGET_AVX2 static Register neg(Register a) { return _mm256_sub_epi64(_mm256_setzero_si256(), a); }
+				//AVX2 has no 64 bit low multiply either
+				MAT_TARGET_AVX2 static Register mul(Register a, Register b)
+				{
+					__m256i lowLow = _mm256_mul_epu32(a, b);
+					__m256i lowHigh = _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32));
+					__m256i highLow = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b);
+					return _mm256_add_epi64(lowLow, _mm256_slli_epi64(_mm256_add_epi64(lowHigh, highLow), 32));
+				}
+			};
+
+
+			struct Avx512Float
+			{
+				typedef __m512 Register;
+				static const std::size_t Width = 16;
+				MAT_TARGET_AVX512 static Register load(float const * p) { return _mm512_loadu_ps(p); }
+				MAT_TARGET_AVX512 static void store(float* p, Register r) { _mm512_storeu_ps(p, r); }
+				MAT_TARGET_AVX512 static Register set1(float s) { return _mm512_set1_ps(s); }
+				MAT_TARGET_AVX512 static Register add(Register a, Register b) { return _mm512_add_ps(a, b); }
+				MAT_TARGET_AVX512 static Register sub(Register a, Register b) { return _mm512_sub_ps(a, b); }
+				MAT_TARGET_AVX512 static Register mul(Register a, Register b) { return _mm512_mul_ps(a, b); }
+				MAT_TARGET_AVX512 static Register div(Register a, Register b) { return _mm512_div_ps(a, b); }
+				MAT_TARGET_AVX512 static Register neg(Register a) { return _mm512_xor_ps(a, _mm512_set1_ps(-0.0f)); }
+				MAT_TARGET_AVX512 static Register abs(Register a) { return _mm512_andnot_ps(_mm512_set1_ps(-0.0f), a); }
+				//The all-lanes masked forms do the same as _mm512_max_ps / _mm512_min_ps, whose undefined pass-through register makes GCC warn
+				MAT_TARGET_AVX512 static Register max(Register a, Register b) { return _mm512_mask_max_ps(b, static_cast<__mmask16>(0xFFFF), a, b); }
+				MAT_TARGET_AVX512 static Register min(Register a, Register b) { return _mm512_mask_min_ps(b, static_cast<__mmask16>(0xFFFF), a, b); }
+				MAT_TARGET_AVX512 static unsigned int lessEqualMask(Register a, Register b) { return static_cast<unsigned int>(_mm512_cmp_ps_mask(a, b, _CMP_LE_OQ)); }
+			};
+
+			struct Avx512Double
+			{
+				typedef __m512d Register;
+				static const std::size_t Width = 8;
+				MAT_TARGET_AVX512 static Register load(double const * p) { return _mm512_loadu_pd(p); }
+				MAT_TARGET_AVX512 static void store(double* p, Register r) { _mm512_storeu_pd(p, r); }
+				MAT_TARGET_AVX512 static Register set1(double s) { return _mm512_set1_pd(s); }
+				MAT_TARGET_AVX512 static Register add(Register a, Register b) { return _mm512_add_pd(a, b); }
+				MAT_TARGET_AVX512 static Register sub(Register a, Register b) { return _mm512_sub_pd(a, b); }
+				MAT_TARGET_AVX512 static Register mul(Register a, Register b) { return _mm512_mul_pd(a, b); }
+				MAT_TARGET_AVX512 static Register div(Register a, Register b) { return _mm512_div_pd(a, b); }
+				MAT_TARGET_AVX512 static Register neg(Register a) { return _mm512_xor_pd(a, _mm512_set1_pd(-0.0)); }
+				MAT_TARGET_AVX512 static Register abs(Register a) { return _mm512_andnot_pd(_mm512_set1_pd(-0.0), a); }
+				MAT_TARGET_AVX512 static Register max(Register a, Register b) { return _mm512_mask_max_pd(b, static_cast<__mmask8>(0xFF), a, b); }
+				MAT_TARGET_AVX512 static Register min(Register a, Register b) { return _mm512_mask_min_pd(b, static_cast<__mmask8>(0xFF), a, b); }
+				MAT_TARGET_AVX512 static unsigned int lessEqualMask(Register a, Register b) { return static_cast<unsigned int>(_mm512_cmp_pd_mask(a, b, _CMP_LE_OQ)); }
+			};
+
+			template <typename E> struct Avx512Int32
+			{
+				typedef __m512i Register;
+				static const std::size_t Width = 16;
+				MAT_TARGET_AVX512 static Register load(E const * p) { return _mm512_loadu_si512(p); }
+				MAT_TARGET_AVX512 static void store(E* p, Register r) { _mm512_storeu_si512(p, r); }
+				MAT_TARGET_AVX512 static Register set1(E s) { return _mm512_set1_epi32(static_cast<int>(s)); }
+				MAT_TARGET_AVX512 static Register add(Register a, Register b) { return _mm512_add_epi32(a, b); }
+				MAT_TARGET_AVX512 static Register sub(Register a, Register b) { return _mm512_sub_epi32(a, b); }
+				MAT_TARGET_AVX512 static Register mul(Register a, Register b) { return _mm512_mullo_epi32(a, b); }
+				MAT_TARGET_AVX512 static Register neg(Register a) { return _mm512_sub_epi32(_mm512_setzero_si512(), a); }
+			};
+
+			template <typename E> struct Avx512Int64
+			{
+				typedef __m512i Register;
+				static const std::size_t Width = 8;
+				MAT_TARGET_AVX512 static Register load(E const * p) { return _mm512_loadu_si512(p); }
+				MAT_TARGET_AVX512 static void store(E* p, Register r) { _mm512_storeu_si512(p, r); }
+				MAT_TARGET_AVX512 static Register set1(E s) { return _mm512_set1_epi64(static_cast<long long>(s)); }
+				MAT_TARGET_AVX512 static Register add(Register a, Register b) { return _mm512_add_epi64(a, b); }
+				MAT_TARGET_AVX512 static Register sub(Register a, Register b) { return _mm512_sub_epi64(a, b); }
+				MAT_TARGET_AVX512 static Register mul(Register a, Register b) { return _mm512_mullo_epi64(a, b); }
+				MAT_TARGET_AVX512 static Register neg(Register a) { return _mm512_sub_epi64(_mm512_setzero_si512(), a); }
+			};
+#endif
+
+
+
+			//Returns the match bits of the (at most 64) entries of a
+			template <typename E> std::uint64_t matchWord(std::size_t n, E const * a, E value, E tolerance)
+			{
+				std::uint64_t word = 0;
+				for (std::size_t i = 0; i < n; ++i)
+				{
+					if (std::abs(a[i] - value) <= tolerance)
+					{
+						word |= std::uint64_t(1) << i;
+					}
+				}
+				return word;
+			}
+
+
+			//The compensated loops are latency bound (three dependent additions per step), so they interleave this many register chains
+			const std::size_t CompensatedAccumulators = 4;
+
+
+			//Kahan summation of scalars, used to combine the lanes of the compensated loops
+			template <typename E> struct KahanSum
+			{
+				E sum = E(0);
+				E compensation = E(0);
+
+				void add(E value)
+				{
+					E const term = value - compensation;
+					E const next = sum + term;
+					compensation = (next - sum) - term;
+					sum = next;
+				}
+
+				E get() const
+				{
+					return sum - compensation;
+				}
+			};
+
+
+
+			//////////////////////////////////////////////////////////////////////////////////////////
+			//Loops: full registers first, scalar remainder; one copy per instruction set (target attribute)
+
+#define MAT_DEFINE_SIMD_LOOPS(Suffix, Target) \
+			template <typename V, typename E> Target void addLoop##Suffix(std::size_t n, E const * a, E const * b, E* dst) \
+			{ \
+				std::size_t i = 0; \
+				for (; i + V::Width <= n; i += V::Width) \
+				{ \
+					V::store(dst + i, V::add(V::load(a + i), V::load(b + i))); \
+				} \
+				for (; i < n; ++i) \
+				{ \
+					dst[i] = a[i] + b[i]; \
+				} \
+			} \
+			template <typename V, typename E> Target void subtractLoop##Suffix(std::size_t n, E const * a, E const * b, E* dst) \
+			{ \
+				std::size_t i = 0; \
+				for (; i + V::Width <= n; i += V::Width) \
+				{ \
+					V::store(dst + i, V::sub(V::load(a + i), V::load(b + i))); \
+				} \
+				for (; i < n; ++i) \
+				{ \
+					dst[i] = a[i] - b[i]; \
+				} \
+			} \
+			template <typename V, typename E> Target void scaleLoop##Suffix(std::size_t n, E const * a, E s, E* dst) \
+			{ \
+				typename V::Register const factor = V::set1(s); \
+				std::size_t i = 0; \
+				for (; i + V::Width <= n; i += V::Width) \
+				{ \
+					V::store(dst + i, V::mul(V::load(a + i), factor)); \
+				} \
+				for (; i < n; ++i) \
+				{ \
+					dst[i] = a[i] * s; \
+				} \
+			} \
+			template <typename V, typename E> Target void divideLoop##Suffix(std::size_t n, E const * a, E s, E* dst) \
+			{ \
+				typename V::Register const divisor = V::set1(s); \
+				std::size_t i = 0; \
+				for (; i + V::Width <= n; i += V::Width) \
+				{ \
+					V::store(dst + i, V::div(V::load(a + i), divisor)); \
+				} \
+				for (; i < n; ++i) \
+				{ \
+					dst[i] = a[i] / s; \
+				} \
+			} \
+			template <typename V, typename E> Target void negateLoop##Suffix(std::size_t n, E const * a, E* dst) \
+			{ \
+				std::size_t i = 0; \
+				for (; i + V::Width <= n; i += V::Width) \
+				{ \
+					V::store(dst + i, V::neg(V::load(a + i))); \
+				} \
+				for (; i < n; ++i) \
+				{ \
+					dst[i] = -a[i]; \
+				} \
+			} \
+			template <typename V, typename E> Target E dotLoop##Suffix(std::size_t n, E const * a, E const * b) \
+			{ \
+				typename V::Register sum0 = V::set1(E(0)); \
+				typename V::Register sum1 = V::set1(E(0)); \
+				std::size_t i = 0; \
+				for (; i + 2 * V::Width <= n; i += 2 * V::Width) \
+				{ \
+					sum0 = V::add(sum0, V::mul(V::load(a + i), V::load(b + i))); \
+					sum1 = V::add(sum1, V::mul(V::load(a + i + V::Width), V::load(b + i + V::Width))); \
+				} \
+				if (i + V::Width <= n) \
+				{ \
+					sum0 = V::add(sum0, V::mul(V::load(a + i), V::load(b + i))); \
+					i += V::Width; \
+				} \
+				E lanes[V::Width]; \
+				V::store(lanes, V::add(sum0, sum1)); \
+				E sum = E(0); \
+				for (std::size_t lane = 0; lane < V::Width; ++lane) \
+				{ \
+					sum += lanes[lane]; \
+				} \
+				for (; i < n; ++i) \
+				{ \
+					sum += a[i] * b[i]; \
+				} \
+				return sum; \
+			} \
+			template <typename V, typename E> Target E dotCompensatedLoop##Suffix(std::size_t n, E const * a, E const * b) \
+			{ \
+				typename V::Register sum[CompensatedAccumulators]; \
+				typename V::Register compensation[CompensatedAccumulators]; \
+				for (std::size_t k = 0; k < CompensatedAccumulators; ++k) \
+				{ \
+					sum[k] = V::set1(E(0)); \
+					compensation[k] = V::set1(E(0)); \
+				} \
+				std::size_t i = 0; \
+				for (; i + CompensatedAccumulators * V::Width <= n; i += CompensatedAccumulators * V::Width) \
+				{ \
+					for (std::size_t k = 0; k < CompensatedAccumulators; ++k) \
+					{ \
+						typename V::Register const term = V::sub(V::mul(V::load(a + i + k * V::Width), V::load(b + i + k * V::Width)), compensation[k]); \
+						typename V::Register const next = V::add(sum[k], term); \
+						compensation[k] = V::sub(V::sub(next, sum[k]), term); \
+						sum[k] = next; \
+					} \
+				} \
+				KahanSum<E> total; \
+				for (std::size_t k = 0; k < CompensatedAccumulators; ++k) \
+				{ \
+					E sums[V::Width]; \
+					E compensations[V::Width]; \
+					V::store(sums, sum[k]); \
+					V::store(compensations, compensation[k]); \
+					for (std::size_t lane = 0; lane < V::Width; ++lane) \
+					{ \
+						total.add(sums[lane]); \
+						total.add(-compensations[lane]); \
+					} \
+				} \
+				for (; i < n; ++i) \
+				{ \
+					total.add(a[i] * b[i]); \
+				} \
+				return total.get(); \
+			} \
+			template <typename V, typename E> Target E sumAbsLoop##Suffix(std::size_t n, E const * a) \
+			{ \
+				typename V::Register sum0 = V::set1(E(0)); \
+				typename V::Register sum1 = V::set1(E(0)); \
+				std::size_t i = 0; \
+				for (; i + 2 * V::Width <= n; i += 2 * V::Width) \
+				{ \
+					sum0 = V::add(sum0, V::abs(V::load(a + i))); \
+					sum1 = V::add(sum1, V::abs(V::load(a + i + V::Width))); \
+				} \
+				if (i + V::Width <= n) \
+				{ \
+					sum0 = V::add(sum0, V::abs(V::load(a + i))); \
+					i += V::Width; \
+				} \
+				E lanes[V::Width]; \
+				V::store(lanes, V::add(sum0, sum1)); \
+				E sum = E(0); \
+				for (std::size_t lane = 0; lane < V::Width; ++lane) \
+				{ \
+					sum += lanes[lane]; \
+				} \
+				for (; i < n; ++i) \
+				{ \
+					sum += std::abs(a[i]); \
+				} \
+				return sum; \
+			} \
+			template <typename V, typename E> Target E sumAbsCompensatedLoop##Suffix(std::size_t n, E const * a) \
+			{ \
+				typename V::Register sum[CompensatedAccumulators]; \
+				typename V::Register compensation[CompensatedAccumulators]; \
+				for (std::size_t k = 0; k < CompensatedAccumulators; ++k) \
+				{ \
+					sum[k] = V::set1(E(0)); \
+					compensation[k] = V::set1(E(0)); \
+				} \
+				std::size_t i = 0; \
+				for (; i + CompensatedAccumulators * V::Width <= n; i += CompensatedAccumulators * V::Width) \
+				{ \
+					for (std::size_t k = 0; k < CompensatedAccumulators; ++k) \
+					{ \
+						typename V::Register const term = V::sub(V::abs(V::load(a + i + k * V::Width)), compensation[k]); \
+						typename V::Register const next = V::add(sum[k], term); \
+						compensation[k] = V::sub(V::sub(next, sum[k]), term); \
+						sum[k] = next; \
+					} \
+				} \
+				KahanSum<E> total; \
+				for (std::size_t k = 0; k < CompensatedAccumulators; ++k) \
+				{ \
+					E sums[V::Width]; \
+					E compensations[V::Width]; \
+					V::store(sums, sum[k]); \
+					V::store(compensations, compensation[k]); \
+					for (std::size_t lane = 0; lane < V::Width; ++lane) \
+					{ \
+						total.add(sums[lane]); \
+						total.add(-compensations[lane]); \
+					} \
+				} \
+				for (; i < n; ++i) \
+				{ \
+					total.add(std::abs(a[i])); \
+				} \
+				return total.get(); \
+			} \
+			template <typename V, typename E> Target E maxAbsLoop##Suffix(std::size_t n, E const * a) \
+			{ \
+				typename V::Register best = V::set1(E(0)); \
+				std::size_t i = 0; \
+				for (; i + V::Width <= n; i += V::Width) \
+				{ \
+					best = V::max(V::abs(V::load(a + i)), best); \
+				} \
+				E lanes[V::Width]; \
+				V::store(lanes, best); \
+				E result = E(0); \
+				for (std::size_t lane = 0; lane < V::Width; ++lane) \
+				{ \
+					result = (lanes[lane] > result) ? lanes[lane] : result; \
+				} \
+				for (; i < n; ++i) \
+				{ \
+					result = (std::abs(a[i]) > result) ? std::abs(a[i]) : result; \
+				} \
+				return result; \
+			} \
+			template <typename V, typename E> Target E minAbsLoop##Suffix(std::size_t n, E const * a) \
+			{ \
+				typename V::Register best = V::set1(std::numeric_limits<E>::infinity()); \
+				std::size_t i = 0; \
+				for (; i + V::Width <= n; i += V::Width) \
+				{ \
+					best = V::min(V::abs(V::load(a + i)), best); \
+				} \
+				E lanes[V::Width]; \
+				V::store(lanes, best); \
+				E result = std::numeric_limits<E>::infinity(); \
+				for (std::size_t lane = 0; lane < V::Width; ++lane) \
+				{ \
+					result = (lanes[lane] < result) ? lanes[lane] : result; \
+				} \
+				for (; i < n; ++i) \
+				{ \
+					result = (std::abs(a[i]) < result) ? std::abs(a[i]) : result; \
+				} \
+				return result; \
+			} \
+			template <typename V, typename E> Target void matchMaskLoop##Suffix(std::size_t n, E const * a, E value, E tolerance, std::uint64_t* bits) \
+			{ \
+				typename V::Register const center = V::set1(value); \
+				typename V::Register const radius = V::set1(tolerance); \
+				std::size_t i = 0; \
+				for (; i + 64 <= n; i += 64) \
+				{ \
+					std::uint64_t word = 0; \
+					for (std::size_t lane = 0; lane < 64; lane += V::Width) \
+					{ \
+						word |= static_cast<std::uint64_t>(V::lessEqualMask(V::abs(V::sub(V::load(a + i + lane), center)), radius)) << lane; \
+					} \
+					bits[i / 64] = word; \
+				} \
+				if (i < n) \
+				{ \
+					bits[i / 64] = matchWord(n - i, a + i, value, tolerance); \
+				} \
+			} \
+			template <typename V, typename E> Target void axpyLoop##Suffix(std::size_t n, E alpha, E const * x, E* y) \
+			{ \
+				typename V::Register const factor = V::set1(alpha); \
+				std::size_t i = 0; \
+				for (; i + V::Width <= n; i += V::Width) \
+				{ \
+					V::store(y + i, V::add(V::load(y + i), V::mul(V::load(x + i), factor))); \
+				} \
+				for (; i < n; ++i) \
+				{ \
+					y[i] += alpha * x[i]; \
+				} \
+			}
+
+#ifdef MAT_SIMD_X86
+			MAT_DEFINE_SIMD_LOOPS(Sse2, MAT_TARGET_SSE2)
+			MAT_DEFINE_SIMD_LOOPS(Avx2, MAT_TARGET_AVX2)
+			MAT_DEFINE_SIMD_LOOPS(Avx512, MAT_TARGET_AVX512)
+#endif
+
+#undef MAT_DEFINE_SIMD_LOOPS
+
+
+
+			/////////////////////////////////////////////////////////////////////
+			//Registers: maps an element type to its wrapper per instruction set
+
+#ifdef MAT_SIMD_X86
+			template <typename E, bool isFloat = std::is_floating_point<E>::value, std::size_t size = sizeof(E)> struct Registers;
+
+			template <> struct Registers<float, true, sizeof(float)>
+			{
+				typedef Sse2Float Sse2;
+				typedef Avx2Float Avx2;
+				typedef Avx512Float Avx512;
+			};
+
+			template <> struct Registers<double, true, sizeof(double)>
+			{
+				typedef Sse2Double Sse2;
+				typedef Avx2Double Avx2;
+				typedef Avx512Double Avx512;
+			};
+
+			template <typename E> struct Registers<E, false, 4>
+			{
+				typedef Sse2Int32<E> Sse2;
+				typedef Avx2Int32<E> Avx2;
+				typedef Avx512Int32<E> Avx512;
+			};
+
+			template <typename E> struct Registers<E, false, 8>
+			{
+				typedef Sse2Int64<E> Sse2;
+				typedef Avx2Int64<E> Avx2;
+				typedef Avx512Int64<E> Avx512;
+			};
+#endif
+
+
+
+			///////////////////////////////////////////////
+			//Dispatchers: pick the loop for the active set
+
+			InstructionSet active()
+			{
+				return static_cast<InstructionSet>(activeInstructionSet().load(std::memory_order_relaxed));
+			}
+
+
+			template <typename E> void addDispatch(std::size_t n, E const * a, E const * b, E* dst)
+			{
+#ifdef MAT_SIMD_X86
+				switch (active())
+				{
+				case InstructionSet::AVX512: addLoopAvx512<typename Registers<E>::Avx512>(n, a, b, dst); return;
+				case InstructionSet::AVX2: addLoopAvx2<typename Registers<E>::Avx2>(n, a, b, dst); return;
+				case InstructionSet::SSE2: addLoopSse2<typename Registers<E>::Sse2>(n, a, b, dst); return;
+				default: break;
+				}
+#endif
+				for (std::size_t i = 0; i < n; ++i)
+				{
+					dst[i] = a[i] + b[i];
+				}
+			}
+
+
+			template <typename E> void subtractDispatch(std::size_t n, E const * a, E const * b, E* dst)
+			{
+#ifdef MAT_SIMD_X86
+				switch (active())
+				{
+				case InstructionSet::AVX512: subtractLoopAvx512<typename Registers<E>::Avx512>(n, a, b, dst); return;
+				case InstructionSet::AVX2: subtractLoopAvx2<typename Registers<E>::Avx2>(n, a, b, dst); return;
+				case InstructionSet::SSE2: subtractLoopSse2<typename Registers<E>::Sse2>(n, a, b, dst); return;
+				default: break;
+				}
+#endif
+				for (std::size_t i = 0; i < n; ++i)
+				{
+					dst[i] = a[i] - b[i];
+				}
+			}
+
+
+			template <typename E> void scaleDispatch(std::size_t n, E const * a, E s, E* dst)
+			{
+#ifdef MAT_SIMD_X86
+				switch (active())
+				{
+				case InstructionSet::AVX512: scaleLoopAvx512<typename Registers<E>::Avx512>(n, a, s, dst); return;
+				case InstructionSet::AVX2: scaleLoopAvx2<typename Registers<E>::Avx2>(n, a, s, dst); return;
+				case InstructionSet::SSE2: scaleLoopSse2<typename Registers<E>::Sse2>(n, a, s, dst); return;
+				default: break;
+				}
+#endif
+				for (std::size_t i = 0; i < n; ++i)
+				{
+					dst[i] = a[i] * s;
+				}
+			}
+
+
+			//Only floating point types have a vector division
+			template <typename E> void divideDispatch(std::size_t n, E const * a, E s, E* dst)
+			{
+#ifdef MAT_SIMD_X86
+				switch (active())
+				{
+				case InstructionSet::AVX512: divideLoopAvx512<typename Registers<E>::Avx512>(n, a, s, dst); return;
+				case InstructionSet::AVX2: divideLoopAvx2<typename Registers<E>::Avx2>(n, a, s, dst); return;
+				case InstructionSet::SSE2: divideLoopSse2<typename Registers<E>::Sse2>(n, a, s, dst); return;
+				default: break;
+				}
+#endif
+				for (std::size_t i = 0; i < n; ++i)
+				{
+					dst[i] = a[i] / s;
+				}
+			}
+
+
+			template <typename E> void divideScalar(std::size_t n, E const * a, E s, E* dst)
+			{
+				for (std::size_t i = 0; i < n; ++i)
+				{
+					dst[i] = a[i] / s;
+				}
+			}
+
+
+			template <typename E> void negateDispatch(std::size_t n, E const * a, E* dst)
+			{
+#ifdef MAT_SIMD_X86
+				switch (active())
+				{
+				case InstructionSet::AVX512: negateLoopAvx512<typename Registers<E>::Avx512>(n, a, dst); return;
+				case InstructionSet::AVX2: negateLoopAvx2<typename Registers<E>::Avx2>(n, a, dst); return;
+				case InstructionSet::SSE2: negateLoopSse2<typename Registers<E>::Sse2>(n, a, dst); return;
+				default: break;
+				}
+#endif
+				for (std::size_t i = 0; i < n; ++i)
+				{
+					dst[i] = -a[i];
+				}
+			}
+
+
+
+			template <typename E> E dotDispatch(std::size_t n, E const * a, E const * b)
+			{
+#ifdef MAT_SIMD_X86
+				switch (active())
+				{
+				case InstructionSet::AVX512: return dotLoopAvx512<typename Registers<E>::Avx512>(n, a, b);
+				case InstructionSet::AVX2: return dotLoopAvx2<typename Registers<E>::Avx2>(n, a, b);
+				case InstructionSet::SSE2: return dotLoopSse2<typename Registers<E>::Sse2>(n, a, b);
+				default: break;
+				}
+#endif
+				E sum = E(0);
+				for (std::size_t i = 0; i < n; ++i)
+				{
+					sum += a[i] * b[i];
+				}
+				return sum;
+			}
+
+
+			template <typename E> void axpyDispatch(std::size_t n, E alpha, E const * x, E* y)
+			{
+#ifdef MAT_SIMD_X86
+				switch (active())
+				{
+				case InstructionSet::AVX512: axpyLoopAvx512<typename Registers<E>::Avx512>(n, alpha, x, y); return;
+				case InstructionSet::AVX2: axpyLoopAvx2<typename Registers<E>::Avx2>(n, alpha, x, y); return;
+				case InstructionSet::SSE2: axpyLoopSse2<typename Registers<E>::Sse2>(n, alpha, x, y); return;
+				default: break;
+				}
+#endif
+				for (std::size_t i = 0; i < n; ++i)
+				{
+					y[i] += alpha * x[i];
+				}
+			}
+
+
+			template <typename E> E dotCompensatedDispatch(std::size_t n, E const * a, E const * b)
+			{
+#ifdef MAT_SIMD_X86
+				switch (active())
+				{
+				case InstructionSet::AVX512: return dotCompensatedLoopAvx512<typename Registers<E>::Avx512>(n, a, b);
+				case InstructionSet::AVX2: return dotCompensatedLoopAvx2<typename Registers<E>::Avx2>(n, a, b);
+				case InstructionSet::SSE2: return dotCompensatedLoopSse2<typename Registers<E>::Sse2>(n, a, b);
+				default: break;
+				}
+#endif
+				KahanSum<E> total;
+				for (std::size_t i = 0; i < n; ++i)
+				{
+					total.add(a[i] * b[i]);
+				}
+				return total.get();
+			}
+
+
+			template <typename E> E sumAbsDispatch(std::size_t n, E const * a)
+			{
+#ifdef MAT_SIMD_X86
+				switch (active())
+				{
+				case InstructionSet::AVX512: return sumAbsLoopAvx512<typename Registers<E>::Avx512>(n, a);
+				case InstructionSet::AVX2: return sumAbsLoopAvx2<typename Registers<E>::Avx2>(n, a);
+				case InstructionSet::SSE2: return sumAbsLoopSse2<typename Registers<E>::Sse2>(n, a);
+				default: break;
+				}
+#endif
+				E sum = E(0);
+				for (std::size_t i = 0; i < n; ++i)
+				{
+					sum += std::abs(a[i]);
+				}
+				return sum;
+			}
+
+
+			template <typename E> E sumAbsCompensatedDispatch(std::size_t n, E const * a)
+			{
+#ifdef MAT_SIMD_X86
+				switch (active())
+				{
+				case InstructionSet::AVX512: return sumAbsCompensatedLoopAvx512<typename Registers<E>::Avx512>(n, a);
+				case InstructionSet::AVX2: return sumAbsCompensatedLoopAvx2<typename Registers<E>::Avx2>(n, a);
+				case InstructionSet::SSE2: return sumAbsCompensatedLoopSse2<typename Registers<E>::Sse2>(n, a);
+				default: break;
+				}
+#endif
+				KahanSum<E> total;
+				for (std::size_t i = 0; i < n; ++i)
+				{
+					total.add(std::abs(a[i]));
+				}
+				return total.get();
+			}
+
+
+			template <typename E> E maxAbsDispatch(std::size_t n, E const * a)
+			{
+#ifdef MAT_SIMD_X86
+				switch (active())
+				{
+				case InstructionSet::AVX512: return maxAbsLoopAvx512<typename Registers<E>::Avx512>(n, a);
+				case InstructionSet::AVX2: return maxAbsLoopAvx2<typename Registers<E>::Avx2>(n, a);
+				case InstructionSet::SSE2: return maxAbsLoopSse2<typename Registers<E>::Sse2>(n, a);
+				default: break;
+				}
+#endif
+				E result = E(0);
+				for (std::size_t i = 0; i < n; ++i)
+				{
+					result = (std::abs(a[i]) > result) ? std::abs(a[i]) : result;
+				}
+				return result;
+			}
+
+
+			template <typename E> E minAbsDispatch(std::size_t n, E const * a)
+			{
+#ifdef MAT_SIMD_X86
+				switch (active())
+				{
+				case InstructionSet::AVX512: return minAbsLoopAvx512<typename Registers<E>::Avx512>(n, a);
+				case InstructionSet::AVX2: return minAbsLoopAvx2<typename Registers<E>::Avx2>(n, a);
+				case InstructionSet::SSE2: return minAbsLoopSse2<typename Registers<E>::Sse2>(n, a);
+				default: break;
+				}
+#endif
+				E result = std::numeric_limits<E>::infinity();
+				for (std::size_t i = 0; i < n; ++i)
+				{
+					result = (std::abs(a[i]) < result) ? std::abs(a[i]) : result;
+				}
+				return result;
+			}
+
+
+			template <typename E> void matchMaskDispatch(std::size_t n, E const * a, E value, E tolerance, std::uint64_t* bits)
+			{
+#ifdef MAT_SIMD_X86
+				switch (active())
+				{
+				case InstructionSet::AVX512: matchMaskLoopAvx512<typename Registers<E>::Avx512>(n, a, value, tolerance, bits); return;
+				case InstructionSet::AVX2: matchMaskLoopAvx2<typename Registers<E>::Avx2>(n, a, value, tolerance, bits); return;
+				case InstructionSet::SSE2: matchMaskLoopSse2<typename Registers<E>::Sse2>(n, a, value, tolerance, bits); return;
+				default: break;
+				}
+#endif
+				for (std::size_t i = 0; i < n; i += 64)
+				{
+					bits[i / 64] = matchWord(std::min<std::size_t>(64, n - i), a + i, value, tolerance);
+				}
+			}
+
+		} //Anonymous namespace
+
+
+
+		/////////////////////
+		//Instruction sets
+
+		InstructionSet getSupportedInstructionSet()
+		{
+			static InstructionSet const supported = detectInstructionSet();
+			return supported;
+		}
+
+
+		InstructionSet getInstructionSet()
+		{
+			return active();
+		}
+
+
+		void setInstructionSet(InstructionSet instructionSet)
+		{
+			if (static_cast<int>(instructionSet) > static_cast<int>(getSupportedInstructionSet()))
+			{
+				instructionSet = getSupportedInstructionSet();
+			}
+			activeInstructionSet().store(static_cast<int>(instructionSet));
+		}
+
+
+
+		/////////////////////
+		//Exported kernels
+
+		void add(std::size_t n, float const * a, float const * b, float* dst) { addDispatch(n, a, b, dst); }
+		void add(std::size_t n, double const * a, double const * b, double* dst) { addDispatch(n, a, b, dst); }
+		void add(std::size_t n, int const * a, int const * b, int* dst) { addDispatch(n, a, b, dst); }
+		void add(std::size_t n, long const * a, long const * b, long* dst) { addDispatch(n, a, b, dst); }
+		void add(std::size_t n, long long const * a, long long const * b, long long* dst) { addDispatch(n, a, b, dst); }
+
+		void subtract(std::size_t n, float const * a, float const * b, float* dst) { subtractDispatch(n, a, b, dst); }
+		void subtract(std::size_t n, double const * a, double const * b, double* dst) { subtractDispatch(n, a, b, dst); }
+		void subtract(std::size_t n, int const * a, int const * b, int* dst) { subtractDispatch(n, a, b, dst); }
+		void subtract(std::size_t n, long const * a, long const * b, long* dst) { subtractDispatch(n, a, b, dst); }
+		void subtract(std::size_t n, long long const * a, long long const * b, long long* dst) { subtractDispatch(n, a, b, dst); }
+
+		void scale(std::size_t n, float const * a, float s, float* dst) { scaleDispatch(n, a, s, dst); }
+		void scale(std::size_t n, double const * a, double s, double* dst) { scaleDispatch(n, a, s, dst); }
+		void scale(std::size_t n, int const * a, int s, int* dst) { scaleDispatch(n, a, s, dst); }
+		void scale(std::size_t n, long const * a, long s, long* dst) { scaleDispatch(n, a, s, dst); }
+		void scale(std::size_t n, long long const * a, long long s, long long* dst) { scaleDispatch(n, a, s, dst); }
+
+		void divide(std::size_t n, float const * a, float s, float* dst) { divideDispatch(n, a, s, dst); }
+		void divide(std::size_t n, double const * a, double s, double* dst) { divideDispatch(n, a, s, dst); }
+		void divide(std::size_t n, int const * a, int s, int* dst) { divideScalar(n, a, s, dst); }
+		void divide(std::size_t n, long const * a, long s, long* dst) { divideScalar(n, a, s, dst); }
+		void divide(std::size_t n, long long const * a, long long s, long long* dst) { divideScalar(n, a, s, dst); }
+
+		void negate(std::size_t n, float const * a, float* dst) { negateDispatch(n, a, dst); }
+		void negate(std::size_t n, double const * a, double* dst) { negateDispatch(n, a, dst); }
+		void negate(std::size_t n, int const * a, int* dst) { negateDispatch(n, a, dst); }
+		void negate(std::size_t n, long const * a, long* dst) { negateDispatch(n, a, dst); }
+		void negate(std::size_t n, long long const * a, long long* dst) { negateDispatch(n, a, dst); }
+
+		float dot(std::size_t n, float const * a, float const * b) { return dotDispatch(n, a, b); }
+		double dot(std::size_t n, double const * a, double const * b) { return dotDispatch(n, a, b); }
+		int dot(std::size_t n, int const * a, int const * b) { return dotDispatch(n, a, b); }
+		long dot(std::size_t n, long const * a, long const * b) { return dotDispatch(n, a, b); }
+		long long dot(std::size_t n, long long const * a, long long const * b) { return dotDispatch(n, a, b); }
+
+		void axpy(std::size_t n, float alpha, float const * x, float* y) { axpyDispatch(n, alpha, x, y); }
+		void axpy(std::size_t n, double alpha, double const * x, double* y) { axpyDispatch(n, alpha, x, y); }
+		void axpy(std::size_t n, int alpha, int const * x, int* y) { axpyDispatch(n, alpha, x, y); }
+		void axpy(std::size_t n, long alpha, long const * x, long* y) { axpyDispatch(n, alpha, x, y); }
+		void axpy(std::size_t n, long long alpha, long long const * x, long long* y) { axpyDispatch(n, alpha, x, y); }
+
+		float dotCompensated(std::size_t n, float const * a, float const * b) { return dotCompensatedDispatch(n, a, b); }
+		double dotCompensated(std::size_t n, double const * a, double const * b) { return dotCompensatedDispatch(n, a, b); }
+
+		float sumAbs(std::size_t n, float const * a) { return sumAbsDispatch(n, a); }
+		double sumAbs(std::size_t n, double const * a) { return sumAbsDispatch(n, a); }
+
+		float sumAbsCompensated(std::size_t n, float const * a) { return sumAbsCompensatedDispatch(n, a); }
+		double sumAbsCompensated(std::size_t n, double const * a) { return sumAbsCompensatedDispatch(n, a); }
+
+		float maxAbs(std::size_t n, float const * a) { return maxAbsDispatch(n, a); }
+		double maxAbs(std::size_t n, double const * a) { return maxAbsDispatch(n, a); }
+
+		float minAbs(std::size_t n, float const * a) { return minAbsDispatch(n, a); }
+		double minAbs(std::size_t n, double const * a) { return minAbsDispatch(n, a); }
+
+		void matchMask(std::size_t n, float const * a, float value, float tolerance, std::uint64_t* bits) { matchMaskDispatch(n, a, value, tolerance, bits); }
+		void matchMask(std::size_t n, double const * a, double value, double tolerance, std::uint64_t* bits) { matchMaskDispatch(n, a, value, tolerance, bits); }
+
+
+
+	} //Namespace: Simd
+
+} //Namespace: Mat
+
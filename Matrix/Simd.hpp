@@ -0,0 +1,309 @@
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+
+
+namespace Mat
+{
+	namespace Simd
+	{
+
+		//Instruction sets the elementwise kernels can run on (ordered from weakest to strongest)
+		enum class InstructionSet
+		{
+			Scalar,
+			SSE2,
+			AVX2,
+			AVX512
+		};
+
+
+		//Returns the strongest instruction set supported by CPU and operating system (detected once)
+		InstructionSet getSupportedInstructionSet();
+
+		//Returns the instruction set the kernels currently dispatch to
+		InstructionSet getInstructionSet();
+
+		//Limits dispatch to instructionSet (clamped to the supported one), e.g. for reproducing results of weaker machines
+		void setInstructionSet(InstructionSet instructionSet);
+
+
+
+		//Explicit SIMD kernels for float, double and 32/64 bit signed integers (dispatched at runtime)
+		//dst may alias a or b, but the ranges must not overlap partially
+
+		//dst[i] = a[i] + b[i]
+		void add(std::size_t n, float const * a, float const * b, float* dst);
+		void add(std::size_t n, double const * a, double const * b, double* dst);
+		void add(std::size_t n, int const * a, int const * b, int* dst);
+		void add(std::size_t n, long const * a, long const * b, long* dst);
+		void add(std::size_t n, long long const * a, long long const * b, long long* dst);
+
+		//dst[i] = a[i] - b[i]
+		void subtract(std::size_t n, float const * a, float const * b, float* dst);
+		void subtract(std::size_t n, double const * a, double const * b, double* dst);
+		void subtract(std::size_t n, int const * a, int const * b, int* dst);
+		void subtract(std::size_t n, long const * a, long const * b, long* dst);
+		void subtract(std::size_t n, long long const * a, long long const * b, long long* dst);
+
+		//dst[i] = a[i] * s
+		void scale(std::size_t n, float const * a, float s, float* dst);
+		void scale(std::size_t n, double const * a, double s, double* dst);
+		void scale(std::size_t n, int const * a, int s, int* dst);
+		void scale(std::size_t n, long const * a, long s, long* dst);
+		void scale(std::size_t n, long long const * a, long long s, long long* dst);
+
+		//dst[i] = a[i] / s
+		void divide(std::size_t n, float const * a, float s, float* dst);
+		void divide(std::size_t n, double const * a, double s, double* dst);
+		void divide(std::size_t n, int const * a, int s, int* dst);
+		void divide(std::size_t n, long const * a, long s, long* dst);
+		void divide(std::size_t n, long long const * a, long long s, long long* dst);
+
+		//dst[i] = -a[i]
+		void negate(std::size_t n, float const * a, float* dst);
+		void negate(std::size_t n, double const * a, double* dst);
+		void negate(std::size_t n, int const * a, int* dst);
+		void negate(std::size_t n, long const * a, long* dst);
+		void negate(std::size_t n, long long const * a, long long* dst);
+
+		//Returns the sum of a[i] * b[i]; every lane accumulates on its own and the lanes are combined in a fixed order,
+		//so the result only depends on the instruction set, never on alignment or on the calling thread
+		float dot(std::size_t n, float const * a, float const * b);
+		double dot(std::size_t n, double const * a, double const * b);
+		int dot(std::size_t n, int const * a, int const * b);
+		long dot(std::size_t n, long const * a, long const * b);
+		long long dot(std::size_t n, long long const * a, long long const * b);
+
+		//y[i] += alpha * x[i] (x and y must not overlap)
+		void axpy(std::size_t n, float alpha, float const * x, float* y);
+		void axpy(std::size_t n, double alpha, double const * x, double* y);
+		void axpy(std::size_t n, int alpha, int const * x, int* y);
+		void axpy(std::size_t n, long alpha, long const * x, long* y);
+		void axpy(std::size_t n, long long alpha, long long const * x, long long* y);
+
+
+		//Reductions the level 1 BLAS needs for floating point vectors. Like dot, they combine their lanes in a fixed order
+
+		//Sum of a[i] * b[i] with Kahan compensation in every lane
+		float dotCompensated(std::size_t n, float const * a, float const * b);
+		double dotCompensated(std::size_t n, double const * a, double const * b);
+
+		//Sum of |a[i]|
+		float sumAbs(std::size_t n, float const * a);
+		double sumAbs(std::size_t n, double const * a);
+
+		//Sum of |a[i]| with Kahan compensation in every lane
+		float sumAbsCompensated(std::size_t n, float const * a);
+		double sumAbsCompensated(std::size_t n, double const * a);
+
+		//Largest |a[i]|, skipping NaN entries (0 if there is none)
+		float maxAbs(std::size_t n, float const * a);
+		double maxAbs(std::size_t n, double const * a);
+
+		//Smallest |a[i]|, skipping NaN entries (infinity if there is none)
+		float minAbs(std::size_t n, float const * a);
+		double minAbs(std::size_t n, double const * a);
+
+
+		//Sets bit i % 64 of bits[i / 64] if |a[i] - value| <= tolerance and clears it otherwise (bits of the last word behind n are cleared too)
+		void matchMask(std::size_t n, float const * a, float value, float tolerance, std::uint64_t* bits);
+		void matchMask(std::size_t n, double const * a, double value, double tolerance, std::uint64_t* bits);
+
+
+
+		//Scalar fallbacks for all other element types
+
+
+		////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+		//Struct Template Magnitude, the type of |x| and its computation. Integers use their unsigned type, so that |INT_MIN|
+		//is representable and computed without overflow
+		template <typename T, bool = std::is_integral<T>::value> struct Magnitude
+		{
+			typedef T Type;
+
+			static Type of(T const & x)
+			{
+				return std::abs(x);
+			}
+		};
+
+		template <typename T> struct Magnitude<T, true>
+		{
+			typedef typename std::make_unsigned<T>::type Type;
+
+			static Type of(T const & x)
+			{
+				//Negative values wrap to above the largest T, and 0 - u is their magnitude in unsigned arithmetic
+				Type const u = static_cast<Type>(x);
+				return (u > static_cast<Type>(std::numeric_limits<T>::max())) ? Type(0) - u : u;
+			}
+		};
+
+
+		template <typename T> void add(std::size_t n, T const * a, T const * b, T* dst)
+		{
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				dst[i] = a[i] + b[i];
+			}
+		}
+
+
+		template <typename T> void subtract(std::size_t n, T const * a, T const * b, T* dst)
+		{
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				dst[i] = a[i] - b[i];
+			}
+		}
+
+
+		template <typename T> void scale(std::size_t n, T const * a, T const & s, T* dst)
+		{
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				dst[i] = a[i] * s;
+			}
+		}
+
+
+		template <typename T> void divide(std::size_t n, T const * a, T const & s, T* dst)
+		{
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				dst[i] = a[i] / s;
+			}
+		}
+
+
+		template <typename T> void negate(std::size_t n, T const * a, T* dst)
+		{
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				dst[i] = -a[i];
+			}
+		}
+
+
+		template <typename T> T dot(std::size_t n, T const * a, T const * b)
+		{
+			T sum = T(0);
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				sum += a[i] * b[i];
+			}
+			return sum;
+		}
+
+
+		template <typename T> void axpy(std::size_t n, T const & alpha, T const * x, T* y)
+		{
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				y[i] += alpha * x[i];
+			}
+		}
+
+
+
+		template <typename T> T dotCompensated(std::size_t n, T const * a, T const * b)
+		{
+			T sum = T(0);
+			T compensation = T(0);
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				T const term = a[i] * b[i] - compensation;
+				T const next = sum + term;
+				compensation = (next - sum) - term;
+				sum = next;
+			}
+			return sum - compensation;
+		}
+
+
+		template <typename T> T sumAbs(std::size_t n, T const * a)
+		{
+			T sum = T(0);
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				sum += std::abs(a[i]);
+			}
+			return sum;
+		}
+
+
+		template <typename T> T sumAbsCompensated(std::size_t n, T const * a)
+		{
+			T sum = T(0);
+			T compensation = T(0);
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				T const term = std::abs(a[i]) - compensation;
+				T const next = sum + term;
+				compensation = (next - sum) - term;
+				sum = next;
+			}
+			return sum - compensation;
+		}
+
+
+		template <typename T> typename Magnitude<T>::Type maxAbs(std::size_t n, T const * a)
+		{
+			typedef typename Magnitude<T>::Type M;
+			M result = M(0);
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				M const magnitude = Magnitude<T>::of(a[i]);
+				result = (magnitude > result) ? magnitude : result;
+			}
+			return result;
+		}
+
+
+		template <typename T> typename Magnitude<T>::Type minAbs(std::size_t n, T const * a)
+		{
+			typedef typename Magnitude<T>::Type M;
+			M result = std::numeric_limits<M>::has_infinity ? std::numeric_limits<M>::infinity() : std::numeric_limits<M>::max();
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				M const magnitude = Magnitude<T>::of(a[i]);
+				result = (magnitude < result) ? magnitude : result;
+			}
+			return result;
+		}
+
+
+
+		template <typename T> void matchMask(std::size_t n, T const * a, T const & value, T const & tolerance, std::uint64_t* bits)
+		{
+			for (std::size_t i = 0; i < n; i += 64)
+			{
+				std::uint64_t word = 0;
+				std::size_t const count = (n - i < 64) ? n - i : 64;
+				for (std::size_t j = 0; j < count; ++j)
+				{
+					if (std::abs(a[i + j] - value) <= tolerance)
+					{
+						word |= std::uint64_t(1) << j;
+					}
+				}
+				bits[i / 64] = word;
+			}
+		}
+
+
+
+	} //Namespace: Simd
+
+} //Namespace: Mat
+
+#endif //SIMD_HPP
+
@@ -0,0 +1,600 @@
+#ifndef SPARSE_MATRIX_HPP
+#define SPARSE_MATRIX_HPP
+
+#include <iostream>
+#include <vector>
+#include <list>
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+#include "Matrix.hpp"
+#include "ThreadPool.hpp"
+
+
+
+namespace Mat
+{
+
+	//Compressed layouts of SparseMatrix: CSR compresses rows (entries sorted by row, then column), CSC compresses columns
+	enum class SparseLayout
+	{
+		CSR,
+		CSC
+	};
+
+
+	//////////////////////////////////////////////////////////////////////
+	//Struct Template SparseTriplet, which holds one COO entry (pos, value)
+	template <typename T> struct SparseTriplet
+	{
+		MatrixEntry pos;
+		T value;
+		SparseTriplet(MatrixEntry const & _pos, T const & _value)
+			: pos(_pos), value(_value)
+		{}
+	};
+
+
+	namespace Kernel
+	{
+
+		//Sparse products with at least this many stored entries involved are split over the thread pool
+		const std::size_t SparseParallelThreshold = 1 << 15;
+
+
+		//Runs body(begin, end) over [0, count) in chunks on the thread pool if work is large enough, else serially
+		template <typename Body> void sparseParallelFor(std::size_t count, std::size_t work, Body const & body)
+		{
+			ThreadPool& pool = ThreadPool::instance();
+			if ((work < SparseParallelThreshold) || (pool.getThreadCount() == 1) || (count < 2))
+			{
+				body(0, count);
+				return;
+			}
+			std::size_t grainSize = std::max<std::size_t>(1, count / (4 * static_cast<std::size_t>(pool.getThreadCount())));
+			pool.parallelFor(0, count, grainSize, body);
+		}
+
+
+		//Computes y = A * x for the CSR arrays of A (rows rows, nonZeros stored entries), rows split over the thread pool
+		template <typename T> void csrMultiply(std::size_t rows, std::size_t nonZeros, std::size_t const * offsets, unsigned int const * indices, T const * values, T const * x, T* y)
+		{
+			sparseParallelFor(rows, nonZeros, [&](std::size_t begin, std::size_t end)
+			{
+				for (std::size_t row = begin; row < end; ++row)
+				{
+					T sum = T(0);
+					for (std::size_t k = offsets[row]; k < offsets[row + 1]; ++k)
+					{
+						sum += values[k] * x[indices[k]];
+					}
+					y[row] = sum;
+				}
+			});
+		}
+
+	} //Namespace: Kernel
+
+
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template SparseMatrix, which only stores the non-zero entries of a matrix in compressed form (CSR or CSC)
+	//For CSR, the entries of row y are mIndices/mValues[mOffsets[y] .. mOffsets[y + 1]) with their column in mIndices;
+	//CSC is the same with rows and columns exchanged. Indices are sorted and unique within every row (column)
+	template <typename T> class SparseMatrix
+	{
+	public:
+		typedef T ValueType;
+
+	private:
+		MatrixSize mSize;
+		SparseLayout mLayout;
+		std::vector<std::size_t> mOffsets;
+		std::vector<unsigned int> mIndices;
+		std::vector<T> mValues;
+
+	public:
+		//Standard constructor constructs 0x0 matrix
+		SparseMatrix()
+			: SparseMatrix(XY(0u, 0u))
+		{}
+
+
+		//Constructor that constructs a matrix of size size without non-zero entries
+		explicit SparseMatrix(MatrixSize const & size, SparseLayout layout = SparseLayout::CSR)
+			: mSize(size), mLayout(layout), mOffsets(SparseMatrix<T>::getMajorCount(size, layout) + 1, 0), mIndices(), mValues()
+		{}
+
+
+		//Constructor that constructs a matrix of size size from COO triplets (entries at the same position are summed up)
+		SparseMatrix(MatrixSize const & size, std::vector<SparseTriplet<T>> const & triplets, SparseLayout layout = SparseLayout::CSR)
+			: SparseMatrix(size, layout)
+		{
+			for (auto const & triplet : triplets)
+			{
+				if ((triplet.pos.x() >= mSize.x()) || (triplet.pos.y() >= mSize.y()))
+				{
+					throw InvalidIndicesException("SparseMatrix<T>::SparseMatrix(MatrixSize const & size, std::vector<SparseTriplet<T>> const & triplets, SparseLayout layout): a triplet is out of range!", triplet.pos);
+				}
+			}
+
+			//Counting sort by major index, then sort every row (column) by minor index and merge duplicates
+			std::vector<std::size_t> offsets(mOffsets.size(), 0);
+			for (auto const & triplet : triplets)
+			{
+				++offsets[this->getMajor(triplet.pos) + 1];
+			}
+			std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+			std::vector<std::pair<unsigned int, T>> entries(triplets.size());
+			std::vector<std::size_t> next(offsets.begin(), offsets.end() - 1);
+			for (auto const & triplet : triplets)
+			{
+				entries[next[this->getMajor(triplet.pos)]++] = std::make_pair(this->getMinor(triplet.pos), triplet.value);
+			}
+
+			mIndices.reserve(entries.size());
+			mValues.reserve(entries.size());
+			for (std::size_t major = 0; major + 1 < offsets.size(); ++major)
+			{
+				auto begin = entries.begin() + offsets[major];
+				auto end = entries.begin() + offsets[major + 1];
+				std::stable_sort(begin, end, [](std::pair<unsigned int, T> const & a, std::pair<unsigned int, T> const & b) { return a.first < b.first; });
+				for (auto it = begin; it != end; ++it)
+				{
+					if ((mIndices.size() > mOffsets[major]) && (mIndices.back() == it->first))
+					{
+						mValues.back() += it->second;
+					}
+					else
+					{
+						mIndices.push_back(it->first);
+						mValues.push_back(it->second);
+					}
+				}
+				mOffsets[major + 1] = mIndices.size();
+			}
+		}
+
+
+		//Constructor that constructs a sparse matrix from the non-zero entries of a dense matrix
+		explicit SparseMatrix(Matrix<T> const & dense, SparseLayout layout = SparseLayout::CSR)
+			: SparseMatrix(dense.getSize(), layout)
+		{
+			for (unsigned int major = 0; major + 1 < mOffsets.size(); ++major)
+			{
+				for (unsigned int minor = 0; minor < SparseMatrix<T>::getMajorCount(mSize, this->getOtherLayout()); ++minor)
+				{
+					T const & value = (mLayout == SparseLayout::CSR) ? dense.evaluateAt(minor, major) : dense.evaluateAt(major, minor);
+					if (value != T(0))
+					{
+						mIndices.push_back(minor);
+						mValues.push_back(value);
+					}
+				}
+				mOffsets[major + 1] = mIndices.size();
+			}
+		}
+
+
+		//Destructor and all other constructors stay default!
+
+
+	private:
+		//Constructor that takes over compressed arrays
+		SparseMatrix(MatrixSize const & size, SparseLayout layout, std::vector<std::size_t> && offsets, std::vector<unsigned int> && indices, std::vector<T> && values)
+			: mSize(size), mLayout(layout), mOffsets(std::move(offsets)), mIndices(std::move(indices)), mValues(std::move(values))
+		{}
+
+
+	public:
+		//Returns the size of the matrix
+		MatrixSize getSize() const
+		{
+			return mSize;
+		}
+
+
+		//Returns the compressed layout
+		SparseLayout getLayout() const
+		{
+			return mLayout;
+		}
+
+
+		//Returns the number of stored entries
+		std::size_t getNumberOfNonZeros() const
+		{
+			return mValues.size();
+		}
+
+
+		//Returns the offsets of the rows (CSR) or columns (CSC) into getIndices() and getValues() (one more than rows or columns)
+		std::vector<std::size_t> const & getOffsets() const
+		{
+			return mOffsets;
+		}
+
+
+		//Returns the column (CSR) or row (CSC) of every stored entry
+		std::vector<unsigned int> const & getIndices() const
+		{
+			return mIndices;
+		}
+
+
+		//Returns the values of the stored entries
+		std::vector<T> const & getValues() const
+		{
+			return mValues;
+		}
+
+
+		//Returns the entry at pos (zero if it is not stored)
+		T at(MatrixEntry const & pos) const
+		{
+			if ((pos.x() >= mSize.x()) || (pos.y() >= mSize.y()))
+			{
+				throw InvalidIndicesException("SparseMatrix<T>::at(MatrixEntry const & pos) const: pos is out of range!", pos);
+			}
+			unsigned int const major = this->getMajor(pos);
+			auto begin = mIndices.begin() + mOffsets[major];
+			auto end = mIndices.begin() + mOffsets[major + 1];
+			auto it = std::lower_bound(begin, end, this->getMinor(pos));
+			return ((it != end) && (*it == this->getMinor(pos))) ? mValues[it - mIndices.begin()] : T(0);
+		}
+
+
+		//Calculates trace
+		T trace() const
+		{
+			T sum = T(0);
+			for (unsigned int i = 0; i < std::min(mSize.x(), mSize.y()); ++i)
+			{
+				sum += this->at(XY(i, i));
+			}
+			return sum;
+		}
+
+
+		//Finds the positions of all stored entries which have dist tolerance or less from val, in storage order
+		//(Entries which are not stored are not reported, even if val is within tolerance of zero)
+		std::list<MatrixEntry> find(T const & val, T const & tolerance = T(0)) const
+		{
+			std::list<MatrixEntry> list;
+			for (unsigned int major = 0; major + 1 < mOffsets.size(); ++major)
+			{
+				for (std::size_t k = mOffsets[major]; k < mOffsets[major + 1]; ++k)
+				{
+					if (std::abs(mValues[k] - val) <= tolerance)
+					{
+						list.push_back(this->getPosition(major, mIndices[k]));
+					}
+				}
+			}
+			return list;
+		}
+
+
+		//Returns the same matrix in the given layout
+		SparseMatrix<T> toLayout(SparseLayout layout) const
+		{
+			if (layout == mLayout)
+			{
+				return *this;
+			}
+
+			//The CSC arrays of a matrix are the CSR arrays of its transpose: redistribute the entries by minor index.
+			//Walking the majors in order keeps the new minor indices sorted
+			std::size_t const otherMajorCount = SparseMatrix<T>::getMajorCount(mSize, layout);
+			std::vector<std::size_t> offsets(otherMajorCount + 1, 0);
+			for (unsigned int index : mIndices)
+			{
+				++offsets[index + 1];
+			}
+			std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+			std::vector<unsigned int> indices(mIndices.size());
+			std::vector<T> values(mValues.size());
+			std::vector<std::size_t> next(offsets.begin(), offsets.end() - 1);
+			for (unsigned int major = 0; major + 1 < mOffsets.size(); ++major)
+			{
+				for (std::size_t k = mOffsets[major]; k < mOffsets[major + 1]; ++k)
+				{
+					std::size_t const dst = next[mIndices[k]]++;
+					indices[dst] = major;
+					values[dst] = mValues[k];
+				}
+			}
+			return SparseMatrix<T>(mSize, layout, std::move(offsets), std::move(indices), std::move(values));
+		}
+
+
+		//Returns transposed matrix (in the same layout) without changing this
+		SparseMatrix<T> getTransposed() const
+		{
+			//The arrays of this in one layout are the arrays of the transpose in the other one
+			MatrixSize size(mSize);
+			size.flip();
+			SparseMatrix<T> transposed(size, this->getOtherLayout(), std::vector<std::size_t>(mOffsets), std::vector<unsigned int>(mIndices), std::vector<T>(mValues));
+			return transposed.toLayout(mLayout);
+		}
+
+
+		//Transposes this matrix
+		void transpose()
+		{
+			*this = this->getTransposed();
+		}
+
+
+		//Returns the matrix as dense matrix
+		Matrix<T> toDense() const
+		{
+			Matrix<T> dense(mSize, T(0));
+			for (unsigned int major = 0; major + 1 < mOffsets.size(); ++major)
+			{
+				for (std::size_t k = mOffsets[major]; k < mOffsets[major + 1]; ++k)
+				{
+					dense.at(this->getPosition(major, mIndices[k])) = mValues[k];
+				}
+			}
+			return dense;
+		}
+
+
+	private:
+		SparseLayout getOtherLayout() const
+		{
+			return (mLayout == SparseLayout::CSR) ? SparseLayout::CSC : SparseLayout::CSR;
+		}
+
+
+		//Number of compressed rows (CSR) or columns (CSC)
+		static unsigned int getMajorCount(MatrixSize const & size, SparseLayout layout)
+		{
+			return (layout == SparseLayout::CSR) ? size.y() : size.x();
+		}
+
+
+		unsigned int getMajor(MatrixEntry const & pos) const
+		{
+			return (mLayout == SparseLayout::CSR) ? pos.y() : pos.x();
+		}
+
+
+		unsigned int getMinor(MatrixEntry const & pos) const
+		{
+			return (mLayout == SparseLayout::CSR) ? pos.x() : pos.y();
+		}
+
+
+		MatrixEntry getPosition(unsigned int major, unsigned int minor) const
+		{
+			return (mLayout == SparseLayout::CSR) ? XY(minor, major) : XY(major, minor);
+		}
+
+
+		template <typename S> friend SparseMatrix<S> operator*(SparseMatrix<S> const & m1, SparseMatrix<S> const & m2);
+
+
+	}; //Class Template: SparseMatrix
+
+
+
+	//Prints the stored entries, one "(x, y) value" per line
+	template <typename T> std::ostream& operator<<(std::ostream& oStream, SparseMatrix<T> const & mat)
+	{
+		std::vector<std::size_t> const & offsets = mat.getOffsets();
+		for (unsigned int major = 0; major + 1 < offsets.size(); ++major)
+		{
+			for (std::size_t k = offsets[major]; k < offsets[major + 1]; ++k)
+			{
+				unsigned int const minor = mat.getIndices()[k];
+				MatrixEntry pos = (mat.getLayout() == SparseLayout::CSR) ? XY(minor, major) : XY(major, minor);
+				oStream << pos << " " << mat.getValues()[k] << '\n';
+			}
+		}
+		return oStream;
+	}
+
+
+	//Sparse matrix vector product (rows are split over the thread pool; CSC uses one partial result per chunk, summed in order)
+	template <typename T> Vector<T> operator*(SparseMatrix<T> const & mat, Vector<T> const & vec)
+	{
+		if (mat.getSize().x() != vec.getSize())
+		{
+			throw IncompatibleMatrixSizesException("operator*(SparseMatrix<T> const & mat, Vector<T> const & vec): mat's and vec's sizes are not compatible for matrix vector multiplication!", mat.getSize(), XY(1, vec.getSize()));
+		}
+		std::vector<std::size_t> const & offsets = mat.getOffsets();
+		unsigned int const * indices = mat.getIndices().data();
+		T const * values = mat.getValues().data();
+		T const * x = vec.data();
+		Vector<T> res(mat.getSize().y(), T(0));
+		T* y = res.data();
+
+		if (mat.getLayout() == SparseLayout::CSR)
+		{
+			Kernel::csrMultiply(mat.getSize().y(), mat.getNumberOfNonZeros(), offsets.data(), indices, values, x, y);
+			return res;
+		}
+
+		//CSC scatters columns into y: every chunk of columns gets its own partial result
+		std::size_t const columns = mat.getSize().x();
+		std::size_t const chunkCount = ((mat.getNumberOfNonZeros() < Kernel::SparseParallelThreshold) || (columns < 2)) ? 1 : std::min<std::size_t>(columns, ThreadPool::instance().getThreadCount());
+		std::size_t const chunkSize = (chunkCount == 0) ? 0 : (columns + chunkCount - 1) / chunkCount;
+		std::vector<std::vector<T>> partial(chunkCount, std::vector<T>(mat.getSize().y(), T(0)));
+		ThreadPool::instance().run(chunkCount, [&](std::size_t chunk)
+		{
+			T* part = partial[chunk].data();
+			for (std::size_t col = chunk * chunkSize; col < std::min(columns, (chunk + 1) * chunkSize); ++col)
+			{
+				for (std::size_t k = offsets[col]; k < offsets[col + 1]; ++k)
+				{
+					part[indices[k]] += values[k] * x[col];
+				}
+			}
+		});
+		for (auto const & part : partial)
+		{
+			for (unsigned int row = 0; row < mat.getSize().y(); ++row)
+			{
+				y[row] += part[row];
+			}
+		}
+		return res;
+	}
+
+
+	//Sparse sparse product (row by row with a dense accumulator, chunks of rows run on the thread pool); the result is CSR
+	template <typename T> SparseMatrix<T> operator*(SparseMatrix<T> const & m1, SparseMatrix<T> const & m2)
+	{
+		if (m1.getSize().n() != m2.getSize().m())
+		{
+			throw IncompatibleMatrixSizesException("operator*(SparseMatrix<T> const & m1, SparseMatrix<T> const & m2): m1 and m2 cannot be multiplied!", m1.getSize(), m2.getSize());
+		}
+		SparseMatrix<T> const a = m1.toLayout(SparseLayout::CSR);
+		SparseMatrix<T> const b = m2.toLayout(SparseLayout::CSR);
+		unsigned int const rows = a.getSize().m();
+		unsigned int const columns = b.getSize().n();
+
+		//Every chunk of rows collects its row lengths, indices and values; they are concatenated in order afterwards
+		struct Chunk
+		{
+			std::size_t begin;
+			std::vector<std::size_t> rowLengths;
+			std::vector<unsigned int> indices;
+			std::vector<T> values;
+		};
+		ThreadPool& pool = ThreadPool::instance();
+		std::size_t const work = a.getNumberOfNonZeros() + b.getNumberOfNonZeros();
+		std::size_t const chunkCount = ((work < Kernel::SparseParallelThreshold) || (rows < 2)) ? 1 : std::min<std::size_t>(rows, 4 * static_cast<std::size_t>(pool.getThreadCount()));
+		std::size_t const chunkSize = (rows + chunkCount - 1) / std::max<std::size_t>(chunkCount, 1);
+		std::vector<Chunk> chunks(chunkCount);
+		pool.run(chunkCount, [&](std::size_t c)
+		{
+			Chunk& chunk = chunks[c];
+			chunk.begin = std::min<std::size_t>(rows, c * chunkSize);
+			std::size_t const end = std::min<std::size_t>(rows, (c + 1) * chunkSize);
+			std::vector<T> accumulator(columns, T(0));
+			std::vector<std::size_t> lastRow(columns, static_cast<std::size_t>(-1));
+			std::vector<unsigned int> touched;
+			for (std::size_t row = chunk.begin; row < end; ++row)
+			{
+				touched.clear();
+				for (std::size_t ka = a.mOffsets[row]; ka < a.mOffsets[row + 1]; ++ka)
+				{
+					unsigned int const p = a.mIndices[ka];
+					T const av = a.mValues[ka];
+					for (std::size_t kb = b.mOffsets[p]; kb < b.mOffsets[p + 1]; ++kb)
+					{
+						unsigned int const col = b.mIndices[kb];
+						if (lastRow[col] != row)
+						{
+							lastRow[col] = row;
+							accumulator[col] = T(0);
+							touched.push_back(col);
+						}
+						accumulator[col] += av * b.mValues[kb];
+					}
+				}
+				std::sort(touched.begin(), touched.end());
+				for (unsigned int col : touched)
+				{
+					chunk.indices.push_back(col);
+					chunk.values.push_back(accumulator[col]);
+				}
+				chunk.rowLengths.push_back(touched.size());
+			}
+		});
+
+		std::vector<std::size_t> offsets(rows + 1, 0);
+		std::vector<unsigned int> indices;
+		std::vector<T> values;
+		for (Chunk const & chunk : chunks)
+		{
+			for (std::size_t i = 0; i < chunk.rowLengths.size(); ++i)
+			{
+				offsets[chunk.begin + i + 1] = offsets[chunk.begin + i] + chunk.rowLengths[i];
+			}
+			indices.insert(indices.end(), chunk.indices.begin(), chunk.indices.end());
+			values.insert(values.end(), chunk.values.begin(), chunk.values.end());
+		}
+		return SparseMatrix<T>(MN(rows, columns), SparseLayout::CSR, std::move(offsets), std::move(indices), std::move(values));
+	}
+
+
+	//Sparse dense product (rows of the result are split over the thread pool)
+	template <typename T> Matrix<T> operator*(SparseMatrix<T> const & m1, Matrix<T> const & m2)
+	{
+		if (m1.getSize().n() != m2.getSize().m())
+		{
+			throw IncompatibleMatrixSizesException("operator*(SparseMatrix<T> const & m1, Matrix<T> const & m2): m1 and m2 cannot be multiplied!", m1.getSize(), m2.getSize());
+		}
+		SparseMatrix<T> const a = m1.toLayout(SparseLayout::CSR);
+		std::vector<std::size_t> const & offsets = a.getOffsets();
+		std::vector<unsigned int> const & indices = a.getIndices();
+		std::vector<T> const & values = a.getValues();
+		unsigned int const columns = m2.getSize().n();
+		Matrix<T> res(MN(a.getSize().m(), columns), T(0));
+		Kernel::sparseParallelFor(a.getSize().m(), a.getNumberOfNonZeros() * columns, [&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t row = begin; row < end; ++row)
+			{
+				T* resRow = res.rowPtr(static_cast<unsigned int>(row));
+				for (std::size_t k = offsets[row]; k < offsets[row + 1]; ++k)
+				{
+					T const v = values[k];
+					T const * bRow = m2.rowPtr(indices[k]);
+					for (unsigned int col = 0; col < columns; ++col)
+					{
+						resRow[col] += v * bRow[col];
+					}
+				}
+			}
+		});
+		return res;
+	}
+
+
+	//Dense sparse product (rows of the result are split over the thread pool)
+	template <typename T> Matrix<T> operator*(Matrix<T> const & m1, SparseMatrix<T> const & m2)
+	{
+		if (m1.getSize().n() != m2.getSize().m())
+		{
+			throw IncompatibleMatrixSizesException("operator*(Matrix<T> const & m1, SparseMatrix<T> const & m2): m1 and m2 cannot be multiplied!", m1.getSize(), m2.getSize());
+		}
+		SparseMatrix<T> const b = m2.toLayout(SparseLayout::CSR);
+		std::vector<std::size_t> const & offsets = b.getOffsets();
+		std::vector<unsigned int> const & indices = b.getIndices();
+		std::vector<T> const & values = b.getValues();
+		unsigned int const inner = m1.getSize().n();
+		Matrix<T> res(MN(m1.getSize().m(), b.getSize().n()), T(0));
+		Kernel::sparseParallelFor(m1.getSize().m(), b.getNumberOfNonZeros() * m1.getSize().m(), [&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t row = begin; row < end; ++row)
+			{
+				T* resRow = res.rowPtr(static_cast<unsigned int>(row));
+				T const * aRow = m1.rowPtr(static_cast<unsigned int>(row));
+				for (unsigned int p = 0; p < inner; ++p)
+				{
+					T const av = aRow[p];
+					if (av == T(0))
+					{
+						continue;
+					}
+					for (std::size_t k = offsets[p]; k < offsets[p + 1]; ++k)
+					{
+						resRow[indices[k]] += av * values[k];
+					}
+				}
+			}
+		});
+		return res;
+	}
+
+
+
+} //Namespace: Mat
+
+#endif //SPARSE_MATRIX_HPP
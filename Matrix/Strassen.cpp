@@ -0,0 +1,47 @@
+#include "Strassen.hpp"
+
+#include <atomic>
+
+
+namespace Mat
+{
+
+	namespace
+	{
+
+		std::atomic<MultiplicationAlgorithm> sMultiplicationAlgorithm(MultiplicationAlgorithm::Automatic);
+		std::atomic<std::size_t> sStrassenCutoff(StrassenDefaultCutoff);
+
+	} //Anonymous namespace
+
+
+
+	/////////////////////////////
+	//Multiplication algorithm
+
+	MultiplicationAlgorithm getMultiplicationAlgorithm()
+	{
+		return sMultiplicationAlgorithm.load(std::memory_order_relaxed);
+	}
+
+
+	void setMultiplicationAlgorithm(MultiplicationAlgorithm algorithm)
+	{
+		sMultiplicationAlgorithm.store(algorithm, std::memory_order_relaxed);
+	}
+
+
+	std::size_t getStrassenCutoff()
+	{
+		return sStrassenCutoff.load(std::memory_order_relaxed);
+	}
+
+
+	void setStrassenCutoff(std::size_t cutoff)
+	{
+		sStrassenCutoff.store(std::max<std::size_t>(cutoff, 16), std::memory_order_relaxed);
+	}
+
+
+
+} //Namespace: Mat
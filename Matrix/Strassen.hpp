@@ -0,0 +1,255 @@
+#ifndef STRASSEN_HPP
+#define STRASSEN_HPP
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+#include "AlignedAllocator.hpp"
+#include "Gemm.hpp"
+#include "ThreadPool.hpp"
+
+
+
+namespace Mat
+{
+
+	//Algorithms operator* can use for matrix products
+	enum class MultiplicationAlgorithm
+	{
+		Automatic, //Strassen-Winograd for large integer products (where it is exact), the blocked kernel otherwise
+		Blocked, //Always the blocked kernel
+		StrassenWinograd //Strassen-Winograd for every product larger than the cutoff, also for floating point types
+	};
+
+
+	//Automatic selects Strassen-Winograd for integer products whose dimensions are all at least this large
+	const std::size_t StrassenAutomaticThreshold = 4096;
+
+	//Default of the Strassen cutoff: products with a dimension of at most this size go to the blocked kernel
+	const std::size_t StrassenDefaultCutoff = 512;
+
+
+	//Returns the algorithm operator* uses (Automatic unless changed)
+	MultiplicationAlgorithm getMultiplicationAlgorithm();
+
+	//Sets the algorithm operator* uses (for all threads)
+	void setMultiplicationAlgorithm(MultiplicationAlgorithm algorithm);
+
+	//Returns the dimension below which the Strassen-Winograd recursion falls back to the blocked kernel
+	std::size_t getStrassenCutoff();
+
+	//Sets the Strassen cutoff (values below 16 are raised to 16)
+	void setStrassenCutoff(std::size_t cutoff);
+
+
+
+	namespace Kernel
+	{
+
+		//Block additions of at least this many entries are split by rows over the thread pool
+		const std::size_t StrassenParallelAddThreshold = std::size_t(1) << 16;
+
+
+		//C = op(A, B) entrywise for m x n blocks with row pitches lda, ldb and ldc, split by rows over the thread pool if the blocks are large
+		//C may be A or B, since every entry is only combined with itself
+		template <typename T, typename Op> void combineBlocks(std::size_t m, std::size_t n, T const * A, std::size_t lda, T const * B, std::size_t ldb, T* C, std::size_t ldc, Op const & op)
+		{
+			auto rows = [&](std::size_t begin, std::size_t end)
+			{
+				for (std::size_t i = begin; i < end; ++i)
+				{
+					T const * a = A + i * lda;
+					T const * b = B + i * ldb;
+					T* c = C + i * ldc;
+					for (std::size_t j = 0; j < n; ++j)
+					{
+						c[j] = op(a[j], b[j]);
+					}
+				}
+			};
+			ThreadPool& pool = ThreadPool::instance();
+			if ((m * n < StrassenParallelAddThreshold) || (pool.getThreadCount() == 1) || (n == 0))
+			{
+				rows(0, m);
+				return;
+			}
+			std::size_t const grain = std::max<std::size_t>(1, (m + 4 * pool.getThreadCount() - 1) / (4 * pool.getThreadCount()));
+			pool.parallelFor(0, m, grain, rows);
+		}
+
+
+		//C = A + B for m x n blocks with row pitches lda, ldb and ldc
+		template <typename T> void addBlocks(std::size_t m, std::size_t n, T const * A, std::size_t lda, T const * B, std::size_t ldb, T* C, std::size_t ldc)
+		{
+			combineBlocks(m, n, A, lda, B, ldb, C, ldc, [](T const & a, T const & b) { return a + b; });
+		}
+
+
+		//C = A - B for m x n blocks with row pitches lda, ldb and ldc
+		template <typename T> void subtractBlocks(std::size_t m, std::size_t n, T const * A, std::size_t lda, T const * B, std::size_t ldb, T* C, std::size_t ldc)
+		{
+			combineBlocks(m, n, A, lda, B, ldb, C, ldc, [](T const & a, T const & b) { return a - b; });
+		}
+
+
+		//Returns whether the recursion splits an m x k by k x n product once more
+		inline bool strassenSplits(std::size_t m, std::size_t n, std::size_t k, std::size_t cutoff)
+		{
+			return (m > cutoff) && (n > cutoff) && (k > cutoff);
+		}
+
+
+		//Returns the number of workspace entries strassenWinograd needs for an m x k by k x n product:
+		//one block for the sums of A, one for the sums of B (both reused for P1), plus the workspace of one half-size product
+		inline std::size_t getStrassenWorkspaceSize(std::size_t m, std::size_t n, std::size_t k, std::size_t cutoff)
+		{
+			std::size_t size = 0;
+			while (strassenSplits(m, n, k, cutoff))
+			{
+				m /= 2;
+				n /= 2;
+				k /= 2;
+				size += m * std::max(k, n) + k * n;
+			}
+			return size;
+		}
+
+
+		//Adds the contribution of the odd last row, column and inner index to C, after the even part
+		//C[0:m2, 0:n2] = A[0:m2, 0:k2] * B[0:k2, 0:n2] has been computed (dynamic peeling)
+		template <typename T> void strassenPeel(std::size_t m, std::size_t n, std::size_t k, T const * A, std::size_t lda, T const * B, std::size_t ldb, T* C, std::size_t ldc)
+		{
+			std::size_t const m2 = m & ~std::size_t(1);
+			std::size_t const n2 = n & ~std::size_t(1);
+			std::size_t const k2 = k & ~std::size_t(1);
+			if (k2 != k)
+			{
+				gemm<T>(m2, n2, 1, T(1), A + k2, lda, 1, B + k2 * ldb, ldb, 1, T(1), C, ldc);
+			}
+			if (n2 != n)
+			{
+				gemm<T>(m2, 1, k, T(1), A, lda, 1, B + n2, ldb, 1, T(0), C + n2, ldc);
+			}
+			if (m2 != m)
+			{
+				gemm<T>(1, n, k, T(1), A + m2 * lda, lda, 1, B, ldb, 1, T(0), C + m2 * ldc, ldc);
+			}
+		}
+
+
+		//Computes C = A * B (A: m x k, B: k x n, all row-major with row pitches lda, ldb and ldc) with the Strassen-Winograd
+		//recursion (7 half-size products and 15 block additions per level), down to cutoff, where the blocked kernel takes over.
+		//The products of one level run one after the other in the schedule of Boyer, Dumas, Pernet and Zhou, which only needs
+		//the quadrants of C and the getStrassenWorkspaceSize(m, n, k, cutoff) entries at workspace as scratch space.
+		//The blocked products at the leaves and the block additions run on the whole thread pool, so every level uses all threads
+		template <typename T> void strassenWinograd(std::size_t m, std::size_t n, std::size_t k, T const * A, std::size_t lda, T const * B, std::size_t ldb,
+			T* C, std::size_t ldc, std::size_t cutoff, T* workspace)
+		{
+			if (!strassenSplits(m, n, k, cutoff))
+			{
+				gemm<T>(m, n, k, T(1), A, lda, 1, B, ldb, 1, T(0), C, ldc);
+				return;
+			}
+
+			std::size_t const mh = m / 2;
+			std::size_t const nh = n / 2;
+			std::size_t const kh = k / 2;
+			T const * A11 = A;
+			T const * A12 = A + kh;
+			T const * A21 = A + mh * lda;
+			T const * A22 = A21 + kh;
+			T const * B11 = B;
+			T const * B12 = B + nh;
+			T const * B21 = B + kh * ldb;
+			T const * B22 = B21 + nh;
+			T* C11 = C;
+			T* C12 = C + nh;
+			T* C21 = C + mh * ldc;
+			T* C22 = C21 + nh;
+
+			//X holds the sums of A (mh x kh) and later P1 (mh x nh), Y the sums of B (kh x nh)
+			T* X = workspace;
+			T* Y = X + mh * std::max(kh, nh);
+			T* next = Y + kh * nh;
+			std::size_t const ldx = kh;
+			std::size_t const ldp = nh;
+			std::size_t const ldy = nh;
+
+			subtractBlocks(mh, kh, A11, lda, A21, lda, X, ldx); //S3 = A11 - A21
+			subtractBlocks(kh, nh, B22, ldb, B12, ldb, Y, ldy); //T3 = B22 - B12
+			strassenWinograd(mh, nh, kh, X, ldx, Y, ldy, C21, ldc, cutoff, next); //P7 = S3 * T3
+			addBlocks(mh, kh, A21, lda, A22, lda, X, ldx); //S1 = A21 + A22
+			subtractBlocks(kh, nh, B12, ldb, B11, ldb, Y, ldy); //T1 = B12 - B11
+			strassenWinograd(mh, nh, kh, X, ldx, Y, ldy, C22, ldc, cutoff, next); //P5 = S1 * T1
+			subtractBlocks(mh, kh, X, ldx, A11, lda, X, ldx); //S2 = S1 - A11
+			subtractBlocks(kh, nh, B22, ldb, Y, ldy, Y, ldy); //T2 = B22 - T1
+			strassenWinograd(mh, nh, kh, X, ldx, Y, ldy, C12, ldc, cutoff, next); //P6 = S2 * T2
+			subtractBlocks(mh, kh, A12, lda, X, ldx, X, ldx); //S4 = A12 - S2
+			strassenWinograd(mh, nh, kh, X, ldx, B22, ldb, C11, ldc, cutoff, next); //P3 = S4 * B22
+			strassenWinograd(mh, nh, kh, A11, lda, B11, ldb, X, ldp, cutoff, next); //P1 = A11 * B11
+			addBlocks(mh, nh, X, ldp, C12, ldc, C12, ldc); //U2 = P1 + P6
+			addBlocks(mh, nh, C12, ldc, C21, ldc, C21, ldc); //U3 = U2 + P7
+			addBlocks(mh, nh, C12, ldc, C22, ldc, C12, ldc); //U4 = U2 + P5
+			addBlocks(mh, nh, C21, ldc, C22, ldc, C22, ldc); //U7 = U3 + P5 (C22 is final)
+			addBlocks(mh, nh, C12, ldc, C11, ldc, C12, ldc); //U5 = U4 + P3 (C12 is final)
+			subtractBlocks(kh, nh, Y, ldy, B21, ldb, Y, ldy); //T4 = T2 - B21
+			strassenWinograd(mh, nh, kh, A22, lda, Y, ldy, C11, ldc, cutoff, next); //P4 = A22 * T4
+			subtractBlocks(mh, nh, C21, ldc, C11, ldc, C21, ldc); //U6 = U3 - P4 (C21 is final)
+			strassenWinograd(mh, nh, kh, A12, lda, B21, ldb, C11, ldc, cutoff, next); //P2 = A12 * B21
+			addBlocks(mh, nh, X, ldp, C11, ldc, C11, ldc); //U1 = P1 + P2 (C11 is final)
+
+			strassenPeel(m, n, k, A, lda, B, ldb, C, ldc);
+		}
+
+
+		//Returns whether an m x k by k x n product of T uses Strassen-Winograd with the current settings
+		template <typename T> bool useStrassen(std::size_t m, std::size_t n, std::size_t k)
+		{
+			switch (getMultiplicationAlgorithm())
+			{
+			case MultiplicationAlgorithm::StrassenWinograd:
+				return strassenSplits(m, n, k, getStrassenCutoff());
+			case MultiplicationAlgorithm::Automatic:
+				return std::is_integral<T>::value && (std::min(m, std::min(n, k)) >= StrassenAutomaticThreshold) && strassenSplits(m, n, k, getStrassenCutoff());
+			default:
+				return false;
+			}
+		}
+
+
+		//Computes C = A * B (row-major, row pitches lda, ldb and ldc) with Strassen-Winograd down to cutoff (raised to at least 16)
+		//Products that do not split even once go straight to the blocked kernel
+		template <typename T> void strassenMultiply(std::size_t m, std::size_t n, std::size_t k, T const * A, std::size_t lda, T const * B, std::size_t ldb, T* C, std::size_t ldc, std::size_t cutoff)
+		{
+			cutoff = std::max<std::size_t>(cutoff, 16);
+			if (!strassenSplits(m, n, k, cutoff))
+			{
+				gemm<T>(m, n, k, T(1), A, lda, 1, B, ldb, 1, T(0), C, ldc);
+				return;
+			}
+			std::vector<T, AlignedAllocator<T>> workspace(getStrassenWorkspaceSize(m, n, k, cutoff));
+			strassenWinograd(m, n, k, A, lda, B, ldb, C, ldc, cutoff, workspace.data());
+		}
+
+
+		//Computes C = A * B (row-major, row pitches lda, ldb and ldc), with Strassen-Winograd if the settings select it
+		//for this product and the blocked kernel otherwise
+		template <typename T> void multiply(std::size_t m, std::size_t n, std::size_t k, T const * A, std::size_t lda, T const * B, std::size_t ldb, T* C, std::size_t ldc)
+		{
+			if (!useStrassen<T>(m, n, k))
+			{
+				gemm<T>(m, n, k, T(1), A, lda, 1, B, ldb, 1, T(0), C, ldc);
+				return;
+			}
+			strassenMultiply(m, n, k, A, lda, B, ldb, C, ldc, getStrassenCutoff());
+		}
+
+	} //Namespace: Kernel
+
+
+
+} //Namespace: Mat
+
+#endif //STRASSEN_HPP
@@ -0,0 +1,171 @@
+#ifndef STRIDEDITERATOR_HPP
+#define STRIDEDITERATOR_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+
+
+namespace Mat
+{
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template StridedIterator, a random access iterator over elements stride apart (columns, strided views)
+	//StridedIterator<T const> only reads; mutable iterators convert implicitly to constant ones
+	template <typename T> class StridedIterator
+	{
+	public:
+		typedef std::random_access_iterator_tag iterator_category;
+		typedef typename std::remove_const<T>::type value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef T* pointer;
+		typedef T& reference;
+
+	private:
+		T* mPtr;
+		std::ptrdiff_t mStride;
+
+	public:
+		StridedIterator()
+			: mPtr(nullptr), mStride(1)
+		{}
+
+
+		StridedIterator(T* ptr, std::ptrdiff_t stride)
+			: mPtr(ptr), mStride(stride)
+		{}
+
+
+		template <typename S, typename = typename std::enable_if<std::is_same<S const, T>::value && !std::is_same<S, T>::value>::type>
+		StridedIterator(StridedIterator<S> const & other)
+			: mPtr(other.ptr()), mStride(other.getStride())
+		{}
+
+
+		//Returns the element the iterator points to (as pointer)
+		T* ptr() const
+		{
+			return mPtr;
+		}
+
+
+		//Returns the distance between two consecutive elements
+		std::ptrdiff_t getStride() const
+		{
+			return mStride;
+		}
+
+
+	public:
+		T& operator*() const
+		{
+			return *mPtr;
+		}
+
+		T* operator->() const
+		{
+			return mPtr;
+		}
+
+		T& operator[](difference_type n) const
+		{
+			return mPtr[n * mStride];
+		}
+
+		StridedIterator& operator++()
+		{
+			mPtr += mStride;
+			return *this;
+		}
+
+		StridedIterator operator++(int)
+		{
+			StridedIterator old(*this);
+			mPtr += mStride;
+			return old;
+		}
+
+		StridedIterator& operator--()
+		{
+			mPtr -= mStride;
+			return *this;
+		}
+
+		StridedIterator operator--(int)
+		{
+			StridedIterator old(*this);
+			mPtr -= mStride;
+			return old;
+		}
+
+		StridedIterator& operator+=(difference_type n)
+		{
+			mPtr += n * mStride;
+			return *this;
+		}
+
+		StridedIterator& operator-=(difference_type n)
+		{
+			mPtr -= n * mStride;
+			return *this;
+		}
+
+		friend StridedIterator operator+(StridedIterator it, difference_type n)
+		{
+			return it += n;
+		}
+
+		friend StridedIterator operator+(difference_type n, StridedIterator it)
+		{
+			return it += n;
+		}
+
+		friend StridedIterator operator-(StridedIterator it, difference_type n)
+		{
+			return it -= n;
+		}
+
+		//Both iterators have to run over the same elements (same stride)
+		friend difference_type operator-(StridedIterator const & a, StridedIterator const & b)
+		{
+			return (a.mPtr - b.mPtr) / a.mStride;
+		}
+
+		friend bool operator==(StridedIterator const & a, StridedIterator const & b)
+		{
+			return a.mPtr == b.mPtr;
+		}
+
+		friend bool operator!=(StridedIterator const & a, StridedIterator const & b)
+		{
+			return a.mPtr != b.mPtr;
+		}
+
+		friend bool operator<(StridedIterator const & a, StridedIterator const & b)
+		{
+			return (a - b) < 0;
+		}
+
+		friend bool operator>(StridedIterator const & a, StridedIterator const & b)
+		{
+			return b < a;
+		}
+
+		friend bool operator<=(StridedIterator const & a, StridedIterator const & b)
+		{
+			return !(b < a);
+		}
+
+		friend bool operator>=(StridedIterator const & a, StridedIterator const & b)
+		{
+			return !(a < b);
+		}
+
+	}; //Class Template: StridedIterator
+
+
+
+} //Namespace: Mat
+
+#endif //STRIDEDITERATOR_HPP
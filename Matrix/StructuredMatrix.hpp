@@ -0,0 +1,943 @@
+#ifndef STRUCTURED_MATRIX_HPP
+#define STRUCTURED_MATRIX_HPP
+
+#include <cstddef>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+#include "Matrix.hpp"
+#include "Simd.hpp"
+#include "ThreadPool.hpp"
+
+
+
+namespace Mat
+{
+
+	//Which triangle of a TriangularMatrix is stored (the other one is zero)
+	enum class Triangle
+	{
+		Lower,
+		Upper
+	};
+
+
+	namespace Kernel
+	{
+
+		//Products of structured matrices with at least this many multiply-adds are split over the thread pool (by rows)
+		const std::size_t StructuredParallelThreshold = 1 << 15;
+
+
+		//Runs body(begin, end) over the rows [0, rows) in chunks on the thread pool if work is large enough, else serially
+		template <typename Body> void structuredRows(std::size_t rows, std::size_t work, Body const & body)
+		{
+			ThreadPool& pool = ThreadPool::instance();
+			if ((work < StructuredParallelThreshold) || (pool.getThreadCount() == 1) || (rows < 2))
+			{
+				body(0, rows);
+				return;
+			}
+			std::size_t grainSize = std::max<std::size_t>(1, rows / (4 * static_cast<std::size_t>(pool.getThreadCount())));
+			pool.parallelFor(0, rows, grainSize, body);
+		}
+
+
+		//Offset of row i in a packed lower triangle (row i holds columns 0 .. i)
+		inline std::size_t packedLowerRow(std::size_t i)
+		{
+			return i * (i + 1) / 2;
+		}
+
+
+		//Offset of row i in a packed n x n upper triangle (row i holds columns i .. n - 1)
+		inline std::size_t packedUpperRow(std::size_t n, std::size_t i)
+		{
+			return i * n - (i * (i - 1)) / 2;
+		}
+
+
+		//Factorizes the packed lower triangle L (n rows, row-major) of a symmetric matrix in place into its Cholesky factor
+		//Returns false (leaving L partly factorized) if the matrix is not positive definite
+		template <typename T> bool choleskyPacked(std::size_t n, T* L)
+		{
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				T* rowI = L + packedLowerRow(i);
+				for (std::size_t j = 0; j < i; ++j)
+				{
+					T const * rowJ = L + packedLowerRow(j);
+					rowI[j] = (rowI[j] - Simd::dot(j, rowI, rowJ)) / rowJ[j];
+				}
+				T const diagonal = rowI[i] - Simd::dot(i, rowI, rowI);
+				if (!(diagonal > T(0)))
+				{
+					return false;
+				}
+				rowI[i] = std::sqrt(diagonal);
+			}
+			return true;
+		}
+
+
+		//Solves L * L^T * x = b in place for the Cholesky factor of choleskyPacked
+		template <typename T> void choleskySolvePacked(std::size_t n, T const * L, T* x)
+		{
+			for (std::size_t i = 0; i < n; ++i)
+			{
+				T const * row = L + packedLowerRow(i);
+				x[i] = (x[i] - Simd::dot(i, row, x)) / row[i];
+			}
+			//L^T is the upper triangle: column i of it is row i of L, so subtract x[i] times that row from the earlier components
+			for (std::size_t i = n; i-- > 0;)
+			{
+				T const * row = L + packedLowerRow(i);
+				x[i] /= row[i];
+				Simd::axpy(i, -x[i], row, x);
+			}
+		}
+
+
+		//Factorizes the n x n band matrix a with kl sub- and ku superdiagonals in place into P * A = L * U with partial pivoting.
+		//a has rows of width 2 * kl + ku + 1, entry (i, j) at i * width + (j - i + kl): the extra kl superdiagonals take the fill-in
+		//of U. The multipliers of step k stay in column k of their rows (rows are only swapped right of column k), and row k was
+		//swapped with row pivots[k] before step k. Returns false if a pivot was exactly zero (the factorization is completed anyway)
+		template <typename T> bool bandFactorize(std::size_t n, std::size_t kl, std::size_t ku, T* a, unsigned int* pivots)
+		{
+			std::size_t const width = 2 * kl + ku + 1;
+			auto entry = [&](std::size_t i, std::size_t j) -> T& { return a[i * width + (j + kl - i)]; };
+			bool regular = true;
+			for (std::size_t k = 0; k < n; ++k)
+			{
+				std::size_t const last = std::min(n - 1, k + kl);
+				std::size_t const lastColumn = std::min(n - 1, k + kl + ku);
+				std::size_t p = k;
+				for (std::size_t i = k + 1; i <= last; ++i)
+				{
+					if (std::abs(entry(i, k)) > std::abs(entry(p, k)))
+					{
+						p = i;
+					}
+				}
+				pivots[k] = static_cast<unsigned int>(p);
+				if (p != k)
+				{
+					std::swap_ranges(&entry(k, k), &entry(k, k) + (lastColumn - k + 1), &entry(p, k));
+				}
+
+				T const pivot = entry(k, k);
+				if (pivot == T(0))
+				{
+					regular = false;
+					continue;
+				}
+				for (std::size_t i = k + 1; i <= last; ++i)
+				{
+					T const factor = entry(i, k) / pivot;
+					entry(i, k) = factor;
+					Simd::axpy(lastColumn - k, -factor, &entry(k, k + 1), &entry(i, k + 1));
+				}
+			}
+			return regular;
+		}
+
+
+		//Solves A * x = b in place with the factors and pivots of bandFactorize
+		template <typename T> void bandSolve(std::size_t n, std::size_t kl, std::size_t ku, T const * a, unsigned int const * pivots, T* x)
+		{
+			std::size_t const width = 2 * kl + ku + 1;
+			for (std::size_t k = 0; k < n; ++k)
+			{
+				std::swap(x[k], x[pivots[k]]);
+				std::size_t const last = std::min(n - 1, k + kl);
+				for (std::size_t i = k + 1; i <= last; ++i)
+				{
+					x[i] -= a[i * width + (k + kl - i)] * x[k];
+				}
+			}
+			for (std::size_t i = n; i-- > 0;)
+			{
+				T const * row = a + i * width + kl;
+				std::size_t const count = std::min(n - 1, i + kl + ku) - i;
+				x[i] = (x[i] - Simd::dot(count, row + 1, x + i + 1)) / row[0];
+			}
+		}
+
+
+	} //Namespace: Kernel
+
+
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template SymmetricMatrix, which stores a symmetric n x n matrix packed: only the lower triangle, row by row
+	//(n * (n + 1) / 2 entries). Entry (row, col) and (col, row) are the same stored value
+	template <typename T> class SymmetricMatrix
+	{
+	public:
+		typedef T ValueType;
+
+	private:
+		unsigned int mN;
+		std::vector<T> mValues;
+
+	public:
+		//Constructor that constructs an n x n matrix with all entries value
+		explicit SymmetricMatrix(unsigned int n = 0, T const & value = T())
+			: mN(n), mValues(Kernel::packedLowerRow(n), value)
+		{}
+
+
+		//Constructor that takes the lower triangle of a square dense matrix (the upper triangle is not read)
+		explicit SymmetricMatrix(Matrix<T> const & dense)
+			: SymmetricMatrix(dense.getSize().x())
+		{
+			if (dense.getSize().x() != dense.getSize().y())
+			{
+				throw IncompatibleMatrixSizesException("SymmetricMatrix<T>::SymmetricMatrix(Matrix<T> const & dense): dense is not square!", dense.getSize(), dense.getSize());
+			}
+			for (unsigned int row = 0; row < mN; ++row)
+			{
+				std::copy(dense.rowPtr(row), dense.rowPtr(row) + row + 1, this->rowPtr(row));
+			}
+		}
+
+
+		//Destructor and all other constructors stay default!
+
+
+	public:
+		//Returns the size of the matrix
+		MatrixSize getSize() const
+		{
+			return XY(mN, mN);
+		}
+
+
+		//Returns the number of stored entries
+		std::size_t getNumberOfStoredEntries() const
+		{
+			return mValues.size();
+		}
+
+
+		//Returns the packed lower triangle
+		T const * data() const
+		{
+			return mValues.data();
+		}
+
+
+		//Returns the stored entry (row, col), which is also entry (col, row)
+		T& operator()(unsigned int row, unsigned int column)
+		{
+			return mValues[this->getIndex(row, column, "SymmetricMatrix<T>::operator()(unsigned int row, unsigned int column): entry is out of range!")];
+		}
+
+
+		//Returns the stored entry (row, col), which is also entry (col, row)
+		T const & operator()(unsigned int row, unsigned int column) const
+		{
+			return mValues[this->getIndex(row, column, "SymmetricMatrix<T>::operator()(unsigned int row, unsigned int column) const: entry is out of range!")];
+		}
+
+
+		//Returns a pointer to the stored part of row y (columns 0 .. y, no bounds check)
+		T* rowPtr(unsigned int y)
+		{
+			return mValues.data() + Kernel::packedLowerRow(y);
+		}
+
+
+		//Returns a constant pointer to the stored part of row y (columns 0 .. y, no bounds check)
+		T const * rowPtr(unsigned int y) const
+		{
+			return mValues.data() + Kernel::packedLowerRow(y);
+		}
+
+
+		//Returns the matrix as dense matrix
+		Matrix<T> toDense() const
+		{
+			Matrix<T> dense(this->getSize());
+			for (unsigned int row = 0; row < mN; ++row)
+			{
+				T const * packed = this->rowPtr(row);
+				for (unsigned int col = 0; col <= row; ++col)
+				{
+					dense.rowPtr(row)[col] = packed[col];
+					dense.rowPtr(col)[row] = packed[col];
+				}
+			}
+			return dense;
+		}
+
+
+		//Calculates the determinant, from the packed Cholesky factor if the matrix is positive definite (else via the dense LU)
+		double det() const
+		{
+			std::vector<double> factor(mValues.begin(), mValues.end());
+			if (!Kernel::choleskyPacked<double>(mN, factor.data()))
+			{
+				return this->toDense().det();
+			}
+			double det = 1.0;
+			for (unsigned int i = 0; i < mN; ++i)
+			{
+				double const diagonal = factor[Kernel::packedLowerRow(i) + i];
+				det *= diagonal * diagonal;
+			}
+			return det;
+		}
+
+
+		//Solves A * x = b, with the packed Cholesky factorization if the matrix is positive definite (else via the dense LU)
+		Vector<T> solve(Vector<T> const & b) const
+		{
+			static_assert(std::is_floating_point<T>::value, "SymmetricMatrix<T>::solve: only defined for floating point types!");
+			if (b.getSize() != mN)
+			{
+				throw IncompatibleMatrixSizesException("SymmetricMatrix<T>::solve(Vector<T> const & b) const: b's size does not match the matrix!", this->getSize(), XY(1, b.getSize()));
+			}
+			std::vector<T> factor(mValues);
+			if (!Kernel::choleskyPacked<T>(mN, factor.data()))
+			{
+				return LU<T>(this->toDense()).solve(b);
+			}
+			Vector<T> x(b);
+			Kernel::choleskySolvePacked<T>(mN, factor.data(), x.data());
+			return x;
+		}
+
+
+	private:
+		std::size_t getIndex(unsigned int row, unsigned int column, char const * message) const
+		{
+			if ((row >= mN) || (column >= mN))
+			{
+				throw InvalidIndicesException(message, MN(row, column));
+			}
+			return (row >= column) ? Kernel::packedLowerRow(row) + column : Kernel::packedLowerRow(column) + row;
+		}
+
+
+	}; //Class Template: SymmetricMatrix
+
+
+
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template TriangularMatrix, which stores a lower or upper triangular n x n matrix packed, row by row
+	//(n * (n + 1) / 2 entries); the entries of the other triangle are zero and cannot be changed
+	template <typename T> class TriangularMatrix
+	{
+	public:
+		typedef T ValueType;
+
+	private:
+		unsigned int mN;
+		Triangle mTriangle;
+		std::vector<T> mValues;
+
+	public:
+		//Constructor that constructs an n x n triangular matrix with all entries of the triangle value
+		explicit TriangularMatrix(unsigned int n = 0, Triangle triangle = Triangle::Lower, T const & value = T())
+			: mN(n), mTriangle(triangle), mValues(Kernel::packedLowerRow(n), value)
+		{}
+
+
+		//Constructor that takes the given triangle of a square dense matrix (the rest is not read)
+		TriangularMatrix(Matrix<T> const & dense, Triangle triangle)
+			: TriangularMatrix(dense.getSize().x(), triangle)
+		{
+			if (dense.getSize().x() != dense.getSize().y())
+			{
+				throw IncompatibleMatrixSizesException("TriangularMatrix<T>::TriangularMatrix(Matrix<T> const & dense, Triangle triangle): dense is not square!", dense.getSize(), dense.getSize());
+			}
+			for (unsigned int row = 0; row < mN; ++row)
+			{
+				std::copy(dense.rowPtr(row) + this->getFirstColumn(row), dense.rowPtr(row) + this->getEndColumn(row), this->rowPtr(row));
+			}
+		}
+
+
+		//Destructor and all other constructors stay default!
+
+
+	public:
+		//Returns the size of the matrix
+		MatrixSize getSize() const
+		{
+			return XY(mN, mN);
+		}
+
+
+		//Returns which triangle is stored
+		Triangle getTriangle() const
+		{
+			return mTriangle;
+		}
+
+
+		//Returns the number of stored entries
+		std::size_t getNumberOfStoredEntries() const
+		{
+			return mValues.size();
+		}
+
+
+		//Returns the packed triangle
+		T const * data() const
+		{
+			return mValues.data();
+		}
+
+
+		//Returns whether entry (row, col) lies in the stored triangle
+		bool isStored(unsigned int row, unsigned int column) const
+		{
+			return (row < mN) && (column < mN) && ((mTriangle == Triangle::Lower) ? (column <= row) : (column >= row));
+		}
+
+
+		//Returns the entry (row, col) of the stored triangle
+		T& operator()(unsigned int row, unsigned int column)
+		{
+			if (!this->isStored(row, column))
+			{
+				throw InvalidIndicesException("TriangularMatrix<T>::operator()(unsigned int row, unsigned int column): entry is not in the stored triangle!", MN(row, column));
+			}
+			return this->rowPtr(row)[column - this->getFirstColumn(row)];
+		}
+
+
+		//Returns the entry (row, col), zero outside the stored triangle
+		T operator()(unsigned int row, unsigned int column) const
+		{
+			if ((row >= mN) || (column >= mN))
+			{
+				throw InvalidIndicesException("TriangularMatrix<T>::operator()(unsigned int row, unsigned int column) const: entry is out of range!", MN(row, column));
+			}
+			return this->isStored(row, column) ? this->rowPtr(row)[column - this->getFirstColumn(row)] : T(0);
+		}
+
+
+		//Returns the first column stored in row y
+		unsigned int getFirstColumn(unsigned int y) const
+		{
+			return (mTriangle == Triangle::Lower) ? 0 : y;
+		}
+
+
+		//Returns the column behind the last one stored in row y
+		unsigned int getEndColumn(unsigned int y) const
+		{
+			return (mTriangle == Triangle::Lower) ? y + 1 : mN;
+		}
+
+
+		//Returns a pointer to the stored part of row y, which starts at column getFirstColumn(y) (no bounds check)
+		T* rowPtr(unsigned int y)
+		{
+			return mValues.data() + this->getRowOffset(y);
+		}
+
+
+		//Returns a constant pointer to the stored part of row y, which starts at column getFirstColumn(y) (no bounds check)
+		T const * rowPtr(unsigned int y) const
+		{
+			return mValues.data() + this->getRowOffset(y);
+		}
+
+
+		//Returns the matrix as dense matrix
+		Matrix<T> toDense() const
+		{
+			Matrix<T> dense(this->getSize(), T(0));
+			for (unsigned int row = 0; row < mN; ++row)
+			{
+				std::copy(this->rowPtr(row), this->rowPtr(row) + (this->getEndColumn(row) - this->getFirstColumn(row)), dense.rowPtr(row) + this->getFirstColumn(row));
+			}
+			return dense;
+		}
+
+
+		//Returns the transposed matrix (the other triangle, with the same entries)
+		TriangularMatrix<T> getTransposed() const
+		{
+			TriangularMatrix<T> transposed(mN, (mTriangle == Triangle::Lower) ? Triangle::Upper : Triangle::Lower);
+			for (unsigned int row = 0; row < mN; ++row)
+			{
+				T const * packed = this->rowPtr(row);
+				for (unsigned int col = this->getFirstColumn(row); col < this->getEndColumn(row); ++col)
+				{
+					transposed.rowPtr(col)[row - transposed.getFirstColumn(col)] = packed[col - this->getFirstColumn(row)];
+				}
+			}
+			return transposed;
+		}
+
+
+		//Calculates the determinant as the product of the diagonal
+		T det() const
+		{
+			T det = T(1);
+			for (unsigned int i = 0; i < mN; ++i)
+			{
+				det *= this->rowPtr(i)[i - this->getFirstColumn(i)];
+			}
+			return det;
+		}
+
+
+		//Solves A * x = b by forward (lower) or backward (upper) substitution
+		Vector<T> solve(Vector<T> const & b) const
+		{
+			static_assert(std::is_floating_point<T>::value, "TriangularMatrix<T>::solve: only defined for floating point types!");
+			if (b.getSize() != mN)
+			{
+				throw IncompatibleMatrixSizesException("TriangularMatrix<T>::solve(Vector<T> const & b) const: b's size does not match the matrix!", this->getSize(), XY(1, b.getSize()));
+			}
+			this->throwIfSingular("TriangularMatrix<T>::solve(Vector<T> const & b) const: matrix is singular!");
+			Vector<T> x(b);
+			T* out = x.data();
+			if (mTriangle == Triangle::Lower)
+			{
+				for (unsigned int i = 0; i < mN; ++i)
+				{
+					T const * row = this->rowPtr(i);
+					out[i] = (out[i] - Simd::dot(i, row, out)) / row[i];
+				}
+				return x;
+			}
+			for (unsigned int i = mN; i-- > 0;)
+			{
+				T const * row = this->rowPtr(i);
+				out[i] = (out[i] - Simd::dot(mN - i - 1, row + 1, out + i + 1)) / row[0];
+			}
+			return x;
+		}
+
+
+		//Solves A * X = B for all columns of B at once (row operations on whole rows of X)
+		Matrix<T> solve(Matrix<T> const & B) const
+		{
+			static_assert(std::is_floating_point<T>::value, "TriangularMatrix<T>::solve: only defined for floating point types!");
+			if (B.getSize().m() != mN)
+			{
+				throw IncompatibleMatrixSizesException("TriangularMatrix<T>::solve(Matrix<T> const & B) const: B's size does not match the matrix!", this->getSize(), B.getSize());
+			}
+			this->throwIfSingular("TriangularMatrix<T>::solve(Matrix<T> const & B) const: matrix is singular!");
+			Matrix<T> X(B);
+			std::size_t const columns = X.getSize().n();
+			for (unsigned int step = 0; step < mN; ++step)
+			{
+				unsigned int const i = (mTriangle == Triangle::Lower) ? step : mN - 1 - step;
+				T const * row = this->rowPtr(i);
+				unsigned int const first = this->getFirstColumn(i);
+				T* xRow = X.rowPtr(i);
+				for (unsigned int j = first; j < this->getEndColumn(i); ++j)
+				{
+					if (j != i)
+					{
+						Simd::axpy(columns, -row[j - first], X.rowPtr(j), xRow);
+					}
+				}
+				Simd::scale(columns, xRow, T(1) / row[i - first], xRow);
+			}
+			return X;
+		}
+
+
+	private:
+		std::size_t getRowOffset(unsigned int y) const
+		{
+			return (mTriangle == Triangle::Lower) ? Kernel::packedLowerRow(y) : Kernel::packedUpperRow(mN, y);
+		}
+
+
+		void throwIfSingular(char const * message) const
+		{
+			for (unsigned int i = 0; i < mN; ++i)
+			{
+				if (this->rowPtr(i)[i - this->getFirstColumn(i)] == T(0))
+				{
+					throw SingularMatrixException(message);
+				}
+			}
+		}
+
+
+	}; //Class Template: TriangularMatrix
+
+
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template BandMatrix, which stores an n x n matrix with kl subdiagonals and ku superdiagonals (all other entries zero)
+	//row by row: row i holds columns i - kl .. i + ku at i * (kl + ku + 1) + (col - i + kl); slots outside the matrix stay zero
+	template <typename T> class BandMatrix
+	{
+	public:
+		typedef T ValueType;
+
+	private:
+		unsigned int mN;
+		unsigned int mLower;
+		unsigned int mUpper;
+		std::vector<T> mValues;
+
+	public:
+		//Constructor that constructs an n x n band matrix with all entries zero
+		explicit BandMatrix(unsigned int n = 0, unsigned int lower = 0, unsigned int upper = 0)
+			: mN(n), mLower(lower), mUpper(upper), mValues(static_cast<std::size_t>(n) * (lower + upper + 1), T(0))
+		{}
+
+
+		//Constructor that takes the band of a square dense matrix (entries outside of it are not read)
+		BandMatrix(Matrix<T> const & dense, unsigned int lower, unsigned int upper)
+			: BandMatrix(dense.getSize().x(), lower, upper)
+		{
+			if (dense.getSize().x() != dense.getSize().y())
+			{
+				throw IncompatibleMatrixSizesException("BandMatrix<T>::BandMatrix(Matrix<T> const & dense, unsigned int lower, unsigned int upper): dense is not square!", dense.getSize(), dense.getSize());
+			}
+			for (unsigned int row = 0; row < mN; ++row)
+			{
+				unsigned int const first = this->getFirstColumn(row);
+				std::copy(dense.rowPtr(row) + first, dense.rowPtr(row) + this->getEndColumn(row), this->rowPtr(row) + (first + mLower - row));
+			}
+		}
+
+
+		//Destructor and all other constructors stay default!
+
+
+	public:
+		//Returns the size of the matrix
+		MatrixSize getSize() const
+		{
+			return XY(mN, mN);
+		}
+
+
+		//Returns the number of subdiagonals
+		unsigned int getLowerBandwidth() const
+		{
+			return mLower;
+		}
+
+
+		//Returns the number of superdiagonals
+		unsigned int getUpperBandwidth() const
+		{
+			return mUpper;
+		}
+
+
+		//Returns the number of stored entries (including the unused slots of the first and last rows)
+		std::size_t getNumberOfStoredEntries() const
+		{
+			return mValues.size();
+		}
+
+
+		//Returns the band storage
+		T const * data() const
+		{
+			return mValues.data();
+		}
+
+
+		//Returns whether entry (row, col) lies in the band
+		bool isStored(unsigned int row, unsigned int column) const
+		{
+			return (row < mN) && (column < mN) && (column + mLower >= row) && (column <= row + mUpper);
+		}
+
+
+		//Returns the entry (row, col) of the band
+		T& operator()(unsigned int row, unsigned int column)
+		{
+			if (!this->isStored(row, column))
+			{
+				throw InvalidIndicesException("BandMatrix<T>::operator()(unsigned int row, unsigned int column): entry is not in the band!", MN(row, column));
+			}
+			return this->rowPtr(row)[column + mLower - row];
+		}
+
+
+		//Returns the entry (row, col), zero outside the band
+		T operator()(unsigned int row, unsigned int column) const
+		{
+			if ((row >= mN) || (column >= mN))
+			{
+				throw InvalidIndicesException("BandMatrix<T>::operator()(unsigned int row, unsigned int column) const: entry is out of range!", MN(row, column));
+			}
+			return this->isStored(row, column) ? this->rowPtr(row)[column + mLower - row] : T(0);
+		}
+
+
+		//Returns the first column of the band in row y
+		unsigned int getFirstColumn(unsigned int y) const
+		{
+			return (y > mLower) ? y - mLower : 0;
+		}
+
+
+		//Returns the column behind the last one of the band in row y
+		unsigned int getEndColumn(unsigned int y) const
+		{
+			return std::min(mN, y + mUpper + 1);
+		}
+
+
+		//Returns a pointer to the band storage of row y, which starts at column y - kl (no bounds check)
+		T* rowPtr(unsigned int y)
+		{
+			return mValues.data() + static_cast<std::size_t>(y) * (mLower + mUpper + 1);
+		}
+
+
+		//Returns a constant pointer to the band storage of row y, which starts at column y - kl (no bounds check)
+		T const * rowPtr(unsigned int y) const
+		{
+			return mValues.data() + static_cast<std::size_t>(y) * (mLower + mUpper + 1);
+		}
+
+
+		//Returns the matrix as dense matrix
+		Matrix<T> toDense() const
+		{
+			Matrix<T> dense(this->getSize(), T(0));
+			for (unsigned int row = 0; row < mN; ++row)
+			{
+				unsigned int const first = this->getFirstColumn(row);
+				T const * band = this->rowPtr(row) + (first + mLower - row);
+				std::copy(band, band + (this->getEndColumn(row) - first), dense.rowPtr(row) + first);
+			}
+			return dense;
+		}
+
+
+		//Calculates the determinant by the band LU factorization with partial pivoting (computed in double)
+		double det() const
+		{
+			std::vector<double> factors;
+			std::vector<unsigned int> pivots;
+			if (!this->factorize(factors, pivots))
+			{
+				return 0.0;
+			}
+			std::size_t const width = 2 * mLower + mUpper + 1;
+			double det = 1.0;
+			for (unsigned int i = 0; i < mN; ++i)
+			{
+				det *= (pivots[i] != i) ? -factors[i * width + mLower] : factors[i * width + mLower];
+			}
+			return det;
+		}
+
+
+		//Solves A * x = b by the band LU factorization with partial pivoting (O(n * kl * (kl + ku)) instead of O(n^3))
+		Vector<T> solve(Vector<T> const & b) const
+		{
+			static_assert(std::is_floating_point<T>::value, "BandMatrix<T>::solve: only defined for floating point types!");
+			if (b.getSize() != mN)
+			{
+				throw IncompatibleMatrixSizesException("BandMatrix<T>::solve(Vector<T> const & b) const: b's size does not match the matrix!", this->getSize(), XY(1, b.getSize()));
+			}
+			std::vector<T> factors;
+			std::vector<unsigned int> pivots;
+			if (!this->factorize(factors, pivots))
+			{
+				throw SingularMatrixException("BandMatrix<T>::solve(Vector<T> const & b) const: matrix is singular!");
+			}
+			Vector<T> x(b);
+			Kernel::bandSolve<T>(mN, mLower, mUpper, factors.data(), pivots.data(), x.data());
+			return x;
+		}
+
+
+	private:
+		//Copies the band into the wider storage of Kernel::bandFactorize (converted to W) and factorizes it
+		template <typename W> bool factorize(std::vector<W> & factors, std::vector<unsigned int> & pivots) const
+		{
+			std::size_t const width = 2 * mLower + mUpper + 1;
+			factors.assign(mN * width, W(0));
+			pivots.resize(mN);
+			for (unsigned int row = 0; row < mN; ++row)
+			{
+				T const * band = this->rowPtr(row);
+				std::copy(band, band + (mLower + mUpper + 1), factors.begin() + row * width);
+			}
+			return Kernel::bandFactorize<W>(mN, mLower, mUpper, factors.data(), pivots.data());
+		}
+
+
+	}; //Class Template: BandMatrix
+
+
+
+	//Symmetric matrix vector product: every stored entry is read once and used for both of its positions
+	template <typename T> Vector<T> operator*(SymmetricMatrix<T> const & mat, Vector<T> const & vec)
+	{
+		unsigned int const n = mat.getSize().x();
+		if (n != vec.getSize())
+		{
+			throw IncompatibleMatrixSizesException("operator*(SymmetricMatrix<T> const & mat, Vector<T> const & vec): mat's and vec's sizes are not compatible for matrix vector multiplication!", mat.getSize(), XY(1, vec.getSize()));
+		}
+		MATRIX_PROFILE("operator*(SymmetricMatrix, Vector)", 2.0 * n * n, n, n, n, 1u);
+		Vector<T> res(n, T(0));
+		T const * x = vec.data();
+		T* y = res.data();
+		for (unsigned int i = 0; i < n; ++i)
+		{
+			T const * row = mat.rowPtr(i);
+			y[i] += Simd::dot(i + 1, row, x);
+			Simd::axpy(i, x[i], row, y);
+		}
+		return res;
+	}
+
+
+	//Symmetric dense product (rows of the result are split over the thread pool)
+	template <typename T> Matrix<T> operator*(SymmetricMatrix<T> const & m1, Matrix<T> const & m2)
+	{
+		unsigned int const n = m1.getSize().x();
+		if (n != m2.getSize().m())
+		{
+			throw IncompatibleMatrixSizesException("operator*(SymmetricMatrix<T> const & m1, Matrix<T> const & m2): m1 and m2 cannot be multiplied!", m1.getSize(), m2.getSize());
+		}
+		std::size_t const columns = m2.getSize().n();
+		MATRIX_PROFILE("operator*(SymmetricMatrix, Matrix)", 2.0 * n * n * columns, n, n, m2.getSize().x(), m2.getSize().y());
+		Matrix<T> res(MN(n, m2.getSize().n()), T(0));
+		Kernel::structuredRows(n, static_cast<std::size_t>(n) * n * columns, [&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				T* resRow = res.rowPtr(static_cast<unsigned int>(i));
+				T const * row = m1.rowPtr(static_cast<unsigned int>(i));
+				for (std::size_t j = 0; j < n; ++j)
+				{
+					T const a = (j <= i) ? row[j] : m1.rowPtr(static_cast<unsigned int>(j))[i];
+					Simd::axpy(columns, a, m2.rowPtr(static_cast<unsigned int>(j)), resRow);
+				}
+			}
+		});
+		return res;
+	}
+
+
+	//Triangular matrix vector product (rows are split over the thread pool)
+	template <typename T> Vector<T> operator*(TriangularMatrix<T> const & mat, Vector<T> const & vec)
+	{
+		unsigned int const n = mat.getSize().x();
+		if (n != vec.getSize())
+		{
+			throw IncompatibleMatrixSizesException("operator*(TriangularMatrix<T> const & mat, Vector<T> const & vec): mat's and vec's sizes are not compatible for matrix vector multiplication!", mat.getSize(), XY(1, vec.getSize()));
+		}
+		MATRIX_PROFILE("operator*(TriangularMatrix, Vector)", static_cast<double>(n) * (n + 1), n, n, n, 1u);
+		Vector<T> res(n);
+		T const * x = vec.data();
+		T* y = res.data();
+		Kernel::structuredRows(n, mat.getNumberOfStoredEntries(), [&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				unsigned int const row = static_cast<unsigned int>(i);
+				unsigned int const first = mat.getFirstColumn(row);
+				y[i] = Simd::dot(mat.getEndColumn(row) - first, mat.rowPtr(row), x + first);
+			}
+		});
+		return res;
+	}
+
+
+	//Triangular dense product (rows of the result are split over the thread pool)
+	template <typename T> Matrix<T> operator*(TriangularMatrix<T> const & m1, Matrix<T> const & m2)
+	{
+		unsigned int const n = m1.getSize().x();
+		if (n != m2.getSize().m())
+		{
+			throw IncompatibleMatrixSizesException("operator*(TriangularMatrix<T> const & m1, Matrix<T> const & m2): m1 and m2 cannot be multiplied!", m1.getSize(), m2.getSize());
+		}
+		std::size_t const columns = m2.getSize().n();
+		MATRIX_PROFILE("operator*(TriangularMatrix, Matrix)", static_cast<double>(n) * (n + 1) * columns, n, n, m2.getSize().x(), m2.getSize().y());
+		Matrix<T> res(MN(n, m2.getSize().n()), T(0));
+		Kernel::structuredRows(n, m1.getNumberOfStoredEntries() * columns, [&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				unsigned int const row = static_cast<unsigned int>(i);
+				T* resRow = res.rowPtr(row);
+				T const * packed = m1.rowPtr(row);
+				unsigned int const first = m1.getFirstColumn(row);
+				for (unsigned int j = first; j < m1.getEndColumn(row); ++j)
+				{
+					Simd::axpy(columns, packed[j - first], m2.rowPtr(j), resRow);
+				}
+			}
+		});
+		return res;
+	}
+
+
+	//Band matrix vector product (rows are split over the thread pool)
+	template <typename T> Vector<T> operator*(BandMatrix<T> const & mat, Vector<T> const & vec)
+	{
+		unsigned int const n = mat.getSize().x();
+		if (n != vec.getSize())
+		{
+			throw IncompatibleMatrixSizesException("operator*(BandMatrix<T> const & mat, Vector<T> const & vec): mat's and vec's sizes are not compatible for matrix vector multiplication!", mat.getSize(), XY(1, vec.getSize()));
+		}
+		MATRIX_PROFILE("operator*(BandMatrix, Vector)", 2.0 * mat.getNumberOfStoredEntries(), n, n, n, 1u);
+		Vector<T> res(n);
+		T const * x = vec.data();
+		T* y = res.data();
+		unsigned int const lower = mat.getLowerBandwidth();
+		Kernel::structuredRows(n, mat.getNumberOfStoredEntries(), [&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				unsigned int const row = static_cast<unsigned int>(i);
+				unsigned int const first = mat.getFirstColumn(row);
+				y[i] = Simd::dot(mat.getEndColumn(row) - first, mat.rowPtr(row) + (first + lower - row), x + first);
+			}
+		});
+		return res;
+	}
+
+
+	//Band dense product (rows of the result are split over the thread pool)
+	template <typename T> Matrix<T> operator*(BandMatrix<T> const & m1, Matrix<T> const & m2)
+	{
+		unsigned int const n = m1.getSize().x();
+		if (n != m2.getSize().m())
+		{
+			throw IncompatibleMatrixSizesException("operator*(BandMatrix<T> const & m1, Matrix<T> const & m2): m1 and m2 cannot be multiplied!", m1.getSize(), m2.getSize());
+		}
+		std::size_t const columns = m2.getSize().n();
+		MATRIX_PROFILE("operator*(BandMatrix, Matrix)", 2.0 * m1.getNumberOfStoredEntries() * columns, n, n, m2.getSize().x(), m2.getSize().y());
+		Matrix<T> res(MN(n, m2.getSize().n()), T(0));
+		unsigned int const lower = m1.getLowerBandwidth();
+		Kernel::structuredRows(n, m1.getNumberOfStoredEntries() * columns, [&](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				unsigned int const row = static_cast<unsigned int>(i);
+				T* resRow = res.rowPtr(row);
+				T const * band = m1.rowPtr(row);
+				for (unsigned int j = m1.getFirstColumn(row); j < m1.getEndColumn(row); ++j)
+				{
+					Simd::axpy(columns, band[j + lower - row], m2.rowPtr(j), resRow);
+				}
+			}
+		});
+		return res;
+	}
+
+
+
+} //Namespace: Mat
+
+#endif //STRUCTURED_MATRIX_HPP
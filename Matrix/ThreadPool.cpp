@@ -0,0 +1,263 @@
+#include "ThreadPool.hpp"
+
+#include <atomic>
+#include <exception>
+#include <cstdlib>
+
+
+namespace Mat
+{
+
+	namespace
+	{
+		//True while the current thread executes a pool task (nested jobs then run serially)
+		thread_local bool sInsideTask = false;
+
+
+		unsigned int getDefaultThreadCount()
+		{
+			char const * env = std::getenv(ThreadCountEnvironmentVariable);
+			if (env != nullptr)
+			{
+				long value = std::strtol(env, nullptr, 10);
+				if (value > 0)
+				{
+					return static_cast<unsigned int>(value);
+				}
+			}
+			return std::max(1u, std::thread::hardware_concurrency());
+		}
+	}
+
+
+
+	//////////////////////////////
+	//Struct ThreadPool::Job
+
+	struct ThreadPool::Job
+	{
+		TaskReference const * task;
+		std::size_t taskCount;
+		std::atomic<std::size_t> nextTask;
+		std::size_t finishedTasks;
+		unsigned int activeWorkers; //Workers that took the job and have not left executeTasks yet (guarded by mutex)
+		std::exception_ptr exception;
+		std::mutex* mutex;
+		std::condition_variable* doneCondition;
+	};
+
+
+
+	//////////////////
+	//Class ThreadPool
+
+	ThreadPool::ThreadPool()
+		: mWorkers(), mThreadCount(1), mJobState(new Job()), mJob(nullptr), mGeneration(0), mStop(false)
+	{
+		this->startWorkers(getDefaultThreadCount());
+	}
+
+
+	ThreadPool::~ThreadPool()
+	{
+		this->stopWorkers();
+	}
+
+
+	ThreadPool& ThreadPool::instance()
+	{
+		static ThreadPool pool;
+		return pool;
+	}
+
+
+	unsigned int ThreadPool::getThreadCount() const
+	{
+		return mThreadCount;
+	}
+
+
+	void ThreadPool::setThreadCount(unsigned int threadCount)
+	{
+		if (threadCount == 0)
+		{
+			threadCount = std::max(1u, std::thread::hardware_concurrency());
+		}
+		std::lock_guard<std::mutex> runLock(mRunMutex);
+		if (threadCount == mThreadCount)
+		{
+			return;
+		}
+		this->stopWorkers();
+		this->startWorkers(threadCount);
+	}
+
+
+	void ThreadPool::runTasks(std::size_t taskCount, TaskReference const & task)
+	{
+		if (taskCount == 0)
+		{
+			return;
+		}
+
+		//Serial execution in the calling thread
+		if ((taskCount == 1) || (mThreadCount == 1) || sInsideTask)
+		{
+			for (std::size_t t = 0; t < taskCount; ++t)
+			{
+				task(t);
+			}
+			return;
+		}
+
+		std::lock_guard<std::mutex> runLock(mRunMutex);
+		Job& job = *mJobState;
+		job.task = &task;
+		job.taskCount = taskCount;
+		job.nextTask = 0;
+		job.finishedTasks = 0;
+		job.activeWorkers = 0;
+		job.exception = nullptr;
+		job.mutex = &mMutex;
+		job.doneCondition = &mDoneCondition;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mJob = &job;
+			++mGeneration;
+		}
+		mWakeCondition.notify_all();
+
+		executeTasks(job);
+
+		//The job state is reused by the next run, so wait until no worker refers to it anymore
+		std::unique_lock<std::mutex> lock(mMutex);
+		mDoneCondition.wait(lock, [&job]() {return job.finishedTasks == job.taskCount; });
+		mJob = nullptr;
+		mDoneCondition.wait(lock, [&job]() {return job.activeWorkers == 0; });
+		std::exception_ptr exception = job.exception;
+		job.exception = nullptr;
+		lock.unlock();
+		if (exception)
+		{
+			std::rethrow_exception(exception);
+		}
+	}
+
+
+	void ThreadPool::startWorkers(unsigned int threadCount)
+	{
+		mStop = false;
+		mThreadCount = threadCount;
+		for (unsigned int i = 1; i < threadCount; ++i)
+		{
+			mWorkers.emplace_back(&ThreadPool::workerLoop, this);
+		}
+	}
+
+
+	void ThreadPool::stopWorkers()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mStop = true;
+		}
+		mWakeCondition.notify_all();
+		for (auto & worker : mWorkers)
+		{
+			worker.join();
+		}
+		mWorkers.clear();
+		mThreadCount = 1;
+	}
+
+
+	void ThreadPool::workerLoop()
+	{
+		unsigned long long seenGeneration = 0;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			seenGeneration = mGeneration;
+		}
+		while (true)
+		{
+			Job* job = nullptr;
+			{
+				std::unique_lock<std::mutex> lock(mMutex);
+				mWakeCondition.wait(lock, [this, seenGeneration]() {return mStop || (mGeneration != seenGeneration); });
+				if (mStop)
+				{
+					return;
+				}
+				seenGeneration = mGeneration;
+				job = mJob;
+				if (job)
+				{
+					++job->activeWorkers;
+				}
+			}
+			if (job)
+			{
+				executeTasks(*job);
+				std::lock_guard<std::mutex> lock(mMutex);
+				if (--job->activeWorkers == 0)
+				{
+					mDoneCondition.notify_all();
+				}
+			}
+		}
+	}
+
+
+	void ThreadPool::executeTasks(Job & job)
+	{
+		bool const wasInsideTask = sInsideTask;
+		sInsideTask = true;
+		while (true)
+		{
+			std::size_t t = job.nextTask.fetch_add(1);
+			if (t >= job.taskCount)
+			{
+				break;
+			}
+			std::exception_ptr exception;
+			try
+			{
+				(*job.task)(t);
+			}
+			catch (...)
+			{
+				exception = std::current_exception();
+			}
+			std::lock_guard<std::mutex> lock(*job.mutex);
+			if (exception && !job.exception)
+			{
+				job.exception = exception;
+			}
+			if (++job.finishedTasks == job.taskCount)
+			{
+				job.doneCondition->notify_all();
+			}
+		}
+		sInsideTask = wasInsideTask;
+	}
+
+
+
+	////////////////////////
+	//Free thread functions
+
+	unsigned int getThreadCount()
+	{
+		return ThreadPool::instance().getThreadCount();
+	}
+
+
+	void setThreadCount(unsigned int threadCount)
+	{
+		ThreadPool::instance().setThreadCount(threadCount);
+	}
+
+
+
+} //Namespace: Mat
+
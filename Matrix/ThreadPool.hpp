@@ -0,0 +1,133 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <cstddef>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+
+
+
+namespace Mat
+{
+
+	//Name of the environment variable that sets the initial number of threads of the library thread pool
+	const char* const ThreadCountEnvironmentVariable = "MATRIX_NUM_THREADS";
+
+
+	//////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class ThreadPool, the library-owned pool that is created once and reused by all parallel operations
+	//The calling thread always takes part in the work, so a pool with n threads owns n - 1 workers.
+	//Tasks are identified by their index only; as long as every task writes its own part of the output,
+	//results do not depend on which thread ran which task.
+	class ThreadPool
+	{
+	public:
+		//////////////////////////////////////////////////////////////////////////////////////////////////
+		//Class TaskReference, a non-owning reference to a callable task(std::size_t) that outlives the run
+		//(unlike std::function, it never allocates)
+		class TaskReference
+		{
+		private:
+			void const * mTask;
+			void (*mCall)(void const * task, std::size_t index);
+
+		public:
+			template <typename Task> explicit TaskReference(Task const & task)
+				: mTask(&task), mCall(&TaskReference::call<Task>)
+			{}
+
+			void operator()(std::size_t index) const
+			{
+				mCall(mTask, index);
+			}
+
+		private:
+			template <typename Task> static void call(void const * task, std::size_t index)
+			{
+				(*static_cast<Task const *>(task))(index);
+			}
+		};
+
+	private:
+		struct Job;
+
+	private:
+		std::vector<std::thread> mWorkers;
+		unsigned int mThreadCount;
+		std::mutex mRunMutex;
+		std::mutex mMutex;
+		std::condition_variable mWakeCondition;
+		std::condition_variable mDoneCondition;
+		std::unique_ptr<Job> mJobState; //Reused by every run, so running a job does not allocate
+		Job* mJob; //mJobState while a job runs, else nullptr
+		unsigned long long mGeneration;
+		bool mStop;
+
+	private:
+		ThreadPool();
+
+	public:
+		~ThreadPool();
+		ThreadPool(ThreadPool const &) = delete;
+		ThreadPool& operator=(ThreadPool const &) = delete;
+
+	public:
+		//Returns the pool (created on first use, with the thread count taken from MATRIX_NUM_THREADS or the hardware)
+		static ThreadPool& instance();
+
+		//Returns the number of threads (including the calling thread) that work on a job
+		unsigned int getThreadCount() const;
+
+		//Sets the number of threads (0 selects the hardware concurrency)
+		void setThreadCount(unsigned int threadCount);
+
+		//Runs task(0), ..., task(taskCount - 1) on the pool and returns when all of them are done
+		//Runs serially if the pool has one thread or if called from inside a task; the first exception thrown by a task is rethrown.
+		//task is only referenced, and running it does not allocate
+		template <typename Task> void run(std::size_t taskCount, Task const & task)
+		{
+			this->runTasks(taskCount, TaskReference(task));
+		}
+
+		//Splits [begin, end) into chunks of at most grainSize indices and calls body(chunkBegin, chunkEnd) for each of them
+		template <typename Body> void parallelFor(std::size_t begin, std::size_t end, std::size_t grainSize, Body const & body)
+		{
+			if (end <= begin)
+			{
+				return;
+			}
+			grainSize = std::max<std::size_t>(grainSize, 1);
+			std::size_t chunkCount = (end - begin + grainSize - 1) / grainSize;
+			this->run(chunkCount, [&](std::size_t chunk)
+			{
+				std::size_t chunkBegin = begin + chunk * grainSize;
+				body(chunkBegin, std::min(end, chunkBegin + grainSize));
+			});
+		}
+
+	private:
+		void runTasks(std::size_t taskCount, TaskReference const & task);
+		void startWorkers(unsigned int threadCount);
+		void stopWorkers();
+		void workerLoop();
+		static void executeTasks(Job & job);
+
+	}; //Class: ThreadPool
+
+
+	//Returns the number of threads of the library thread pool
+	unsigned int getThreadCount();
+
+	//Sets the number of threads of the library thread pool (0 selects the hardware concurrency)
+	void setThreadCount(unsigned int threadCount);
+
+
+
+} //Namespace: Mat
+
+#endif //THREADPOOL_HPP
+
@@ -0,0 +1,149 @@
+#ifndef TRANSPOSE_HPP
+#define TRANSPOSE_HPP
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+
+
+namespace Mat
+{
+	namespace Kernel
+	{
+
+		//The recursive kernels below stop splitting once both sides of a block are at most this long
+		//(two such blocks of doubles fit into L1 together)
+		const std::size_t TransposeBlockSize = 32;
+
+
+		//Writes the transpose of the m x n block A (row pitch lda) into the n x m block B (row pitch ldb)
+		//Cache-oblivious: the longer side is halved until the block fits into the cache, whatever its size is
+		template <typename T> void transpose(std::size_t m, std::size_t n, T const * A, std::size_t lda, T* B, std::size_t ldb)
+		{
+			if ((m <= TransposeBlockSize) && (n <= TransposeBlockSize))
+			{
+				for (std::size_t i = 0; i < m; ++i)
+				{
+					T const * aRow = A + i * lda;
+					for (std::size_t j = 0; j < n; ++j)
+					{
+						B[j * ldb + i] = aRow[j];
+					}
+				}
+				return;
+			}
+
+			if (m >= n)
+			{
+				std::size_t const h = m / 2;
+				transpose(h, n, A, lda, B, ldb);
+				transpose(m - h, n, A + h * lda, lda, B + h, ldb);
+			}
+			else
+			{
+				std::size_t const h = n / 2;
+				transpose(m, h, A, lda, B, ldb);
+				transpose(m, n - h, A + h, lda, B + h * ldb, ldb);
+			}
+		}
+
+
+		//Swaps the m x n block A with the transpose of the n x m block B (both with row pitch ld): A(i, j) <-> B(j, i)
+		template <typename T> void transposeSwap(std::size_t m, std::size_t n, T* A, T* B, std::size_t ld)
+		{
+			if ((m <= TransposeBlockSize) && (n <= TransposeBlockSize))
+			{
+				for (std::size_t i = 0; i < m; ++i)
+				{
+					T* aRow = A + i * ld;
+					for (std::size_t j = 0; j < n; ++j)
+					{
+						std::swap(aRow[j], B[j * ld + i]);
+					}
+				}
+				return;
+			}
+
+			if (m >= n)
+			{
+				std::size_t const h = m / 2;
+				transposeSwap(h, n, A, B, ld);
+				transposeSwap(m - h, n, A + h * ld, B + h, ld);
+			}
+			else
+			{
+				std::size_t const h = n / 2;
+				transposeSwap(m, h, A, B, ld);
+				transposeSwap(m, n - h, A + h, B + h * ld, ld);
+			}
+		}
+
+
+		//Transposes the n x n block A (row pitch ld) in place
+		//The diagonal blocks are transposed recursively, the two off-diagonal blocks are swapped with each other
+		template <typename T> void transposeSquareInPlace(std::size_t n, T* A, std::size_t ld)
+		{
+			if (n <= TransposeBlockSize)
+			{
+				for (std::size_t i = 0; i < n; ++i)
+				{
+					for (std::size_t j = i + 1; j < n; ++j)
+					{
+						std::swap(A[i * ld + j], A[j * ld + i]);
+					}
+				}
+				return;
+			}
+
+			std::size_t const h = n / 2;
+			transposeSquareInPlace(h, A, ld);
+			transposeSquareInPlace(n - h, A + h * ld + h, ld);
+			transposeSwap(h, n - h, A + h, A + h * ld, ld);
+		}
+
+
+		//Transposes the packed m x n matrix A (row pitch n) in place, so that it becomes the packed n x m matrix (row pitch m)
+		//The entry at index k = i * n + j belongs to index j * m + i; the permutation is applied cycle by cycle,
+		//which needs one bit per entry to mark visited indices instead of a second matrix
+		template <typename T> void transposeInPlace(std::size_t m, std::size_t n, T* A)
+		{
+			if (m == n)
+			{
+				transposeSquareInPlace(n, A, n);
+				return;
+			}
+
+			std::size_t const count = m * n;
+			if ((m < 2) || (n < 2))
+			{
+				return; //Row and column vectors have the same packed layout
+			}
+
+			//Indices 0 and count - 1 are fixed points of the permutation
+			std::vector<bool> visited(count, false);
+			for (std::size_t start = 1; start + 1 < count; ++start)
+			{
+				if (visited[start])
+				{
+					continue;
+				}
+				T carried = A[start];
+				std::size_t k = start;
+				do
+				{
+					std::size_t const next = (k % n) * m + k / n;
+					std::swap(carried, A[next]);
+					visited[next] = true;
+					k = next;
+				} while (k != start);
+			}
+		}
+
+
+	} //Namespace: Kernel
+
+} //Namespace: Mat
+
+#endif //TRANSPOSE_HPP
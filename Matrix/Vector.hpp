@@ -1,13 +1,24 @@
 #ifndef VECTOR_HPP
 #define VECTOR_HPP
 
+#include <cstdint>
 #include <iostream>
 #include <vector>
 #include <list>
 #include <cmath>
 #include <algorithm>
 #include <functional>
+#include <type_traits>
+#include <iterator>
+#include <utility>
 
+#include "AlignedAllocator.hpp"
+#include "Algorithm.hpp"
+#include "Blas1.hpp"
+#include "Expression.hpp"
+#include "Find.hpp"
+#include "Profiler.hpp"
+#include "Simd.hpp"
 
 
 namespace Mat
@@ -16,6 +27,9 @@ namespace Mat
 	typedef VectorIndex VectorSize;
 	typedef VectorIndex VectorEntry;
 
+	//Extent of dynamically sized vectors and matrices; every other extent fixes the size at compile time (see FixedVector.hpp and FixedMatrix.hpp)
+	const unsigned int Dynamic = static_cast<unsigned int>(-1);
+
 	////////////////////////////////////////////////////////////////////////////
 	//Struct InvalidIndicesException, which can be thrown if the index is invalid
 	struct InvalidIndexException
@@ -37,12 +51,168 @@ namespace Mat
 	};
 
 
-	////////////////////////
-	//Class Template: Vector
-	template <typename T> class Vector
+	template <typename T, unsigned int N = Dynamic> class Vector;
+	template <typename T> class VectorView;
+
+	//Vectors are referenced, not copied, by the expressions they take part in
+	template <typename T> struct ExpressionOperand<Vector<T>>
+	{
+		typedef Vector<T> const & Type;
+	};
+
+
+	////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template VectorExpression, CRTP base of Vector and of all lazily evaluated vector expressions
+	//Every E provides the typedef ValueType, VectorSize getSize() const, ValueType evaluateAt(VectorEntry) const and
+	//bool mayAlias(ValueType const * data, unsigned int stride, VectorSize size) const, which tells whether writing the
+	//components data[0], data[stride], ... while evaluating could change components the expression still has to read
+	template <typename E> class VectorExpression
+	{
+	public:
+		E const & self() const
+		{
+			return static_cast<E const &>(*this);
+		}
+	};
+
+
+	////////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template VectorBinaryExpression, which represents Op(left, right) for every component
+	template <typename L, typename R, typename Op> class VectorBinaryExpression : public VectorExpression<VectorBinaryExpression<L, R, Op>>
 	{
+	public:
+		typedef typename L::ValueType ValueType;
+		static_assert(std::is_same<ValueType, typename R::ValueType>::value, "VectorBinaryExpression: operands have different value types!");
+
 	private:
-		std::vector<T> mVec;
+		typename ExpressionOperand<L>::Type mLeft;
+		typename ExpressionOperand<R>::Type mRight;
+
+	public:
+		VectorBinaryExpression(L const & left, R const & right)
+			: mLeft(left), mRight(right)
+		{}
+
+		VectorSize getSize() const
+		{
+			return mLeft.getSize();
+		}
+
+		ValueType evaluateAt(VectorEntry const & entry) const
+		{
+			return Op::apply(mLeft.evaluateAt(entry), mRight.evaluateAt(entry));
+		}
+
+		bool mayAlias(ValueType const * data, unsigned int stride, VectorSize size) const
+		{
+			return mLeft.mayAlias(data, stride, size) || mRight.mayAlias(data, stride, size);
+		}
+
+		L const & left() const
+		{
+			return mLeft;
+		}
+
+		R const & right() const
+		{
+			return mRight;
+		}
+	};
+
+
+	//////////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template VectorScalarExpression, which represents Op(operand, scalar) for every component
+	template <typename E, typename Op> class VectorScalarExpression : public VectorExpression<VectorScalarExpression<E, Op>>
+	{
+	public:
+		typedef typename E::ValueType ValueType;
+
+	private:
+		typename ExpressionOperand<E>::Type mOperand;
+		ValueType mScalar;
+
+	public:
+		VectorScalarExpression(E const & operand, ValueType const & scalar)
+			: mOperand(operand), mScalar(scalar)
+		{}
+
+		VectorSize getSize() const
+		{
+			return mOperand.getSize();
+		}
+
+		ValueType evaluateAt(VectorEntry const & entry) const
+		{
+			return Op::apply(mOperand.evaluateAt(entry), mScalar);
+		}
+
+		bool mayAlias(ValueType const * data, unsigned int stride, VectorSize size) const
+		{
+			return mOperand.mayAlias(data, stride, size);
+		}
+
+		E const & operand() const
+		{
+			return mOperand;
+		}
+
+		ValueType const & scalar() const
+		{
+			return mScalar;
+		}
+	};
+
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	//Class Template VectorUnaryExpression, which represents Op(operand) for every component
+	template <typename E, typename Op> class VectorUnaryExpression : public VectorExpression<VectorUnaryExpression<E, Op>>
+	{
+	public:
+		typedef typename E::ValueType ValueType;
+
+	private:
+		typename ExpressionOperand<E>::Type mOperand;
+
+	public:
+		explicit VectorUnaryExpression(E const & operand)
+			: mOperand(operand)
+		{}
+
+		VectorSize getSize() const
+		{
+			return mOperand.getSize();
+		}
+
+		ValueType evaluateAt(VectorEntry const & entry) const
+		{
+			return Op::apply(mOperand.evaluateAt(entry));
+		}
+
+		bool mayAlias(ValueType const * data, unsigned int stride, VectorSize size) const
+		{
+			return mOperand.mayAlias(data, stride, size);
+		}
+
+		E const & operand() const
+		{
+			return mOperand;
+		}
+	};
+
+
+
+	//////////////////////////////////////////////////////////////
+	//Class Template: Vector (dynamically sized, heap allocated)
+	template <typename T> class Vector<T, Dynamic> : public VectorExpression<Vector<T>>
+	{
+	public:
+		typedef T ValueType;
+		typedef std::vector<T, AlignedAllocator<T>> Buffer;
+		typedef T* iterator;
+		typedef T const * const_iterator;
+
+	private:
+		Buffer mVec; //Aligned storage from the memory resource that was the default when the vector was constructed
 
 	public:
 		//Standard constructor that constructs a 0-dim vector
@@ -57,18 +227,59 @@ namespace Mat
 		{}
 
 
+		//Constructor that constructs vector of size size with value, allocated from resource instead of the default resource
+		Vector(VectorSize const & size, T const & value, MemoryResource* resource)
+			: mVec(size, value, AlignedAllocator<T>(resource))
+		{}
+
+
 		//Constructor that constructs a vector from std::vector
 		explicit Vector(std::vector<T> const & vec)
-			: mVec(vec)
+			: mVec(vec.begin(), vec.end())
 		{}
 
 
-		//Constructor that constructs a vector by moving from std::vector
+		//Constructor that constructs a vector by moving the components out of std::vector
 		explicit Vector(std::vector<T> && vec)
-			: mVec(std::move(vec))
+			: mVec(std::make_move_iterator(vec.begin()), std::make_move_iterator(vec.end()))
+		{}
+
+
+		//Constructor that copies a fixed-size vector
+		template <unsigned int N> explicit Vector(Vector<T, N> const & vec)
+			: mVec(vec.data(), vec.data() + N)
 		{}
 
 
+		//Constructor that evaluates a vector expression in a single fused loop
+		template <typename E, typename = typename std::enable_if<std::is_same<typename E::ValueType, T>::value>::type>
+		Vector(VectorExpression<E> const & expression)
+			: mVec()
+		{
+			//The buffer is allocated inside the span, so the span accounts for it
+			MATRIX_PROFILE("Vector::Vector(expression)", static_cast<double>(expression.self().getSize()), expression.self().getSize(), 1u);
+			mVec.resize(expression.self().getSize());
+			evaluateVectorExpression(mVec.data(), 1u, expression.self());
+		}
+
+
+		//Evaluates a vector expression into this vector in a single fused loop
+		//This itself may appear in the expression; expressions reading overlapping views of this are evaluated into a temporary first
+		template <typename E> typename std::enable_if<std::is_same<typename E::ValueType, T>::value, Vector<T>&>::type
+		operator=(VectorExpression<E> const & expression)
+		{
+			MATRIX_PROFILE("Vector::operator=(expression)", static_cast<double>(expression.self().getSize()), expression.self().getSize(), 1u);
+			if ((expression.self().getSize() != this->getSize()) || expression.self().mayAlias(mVec.data(), 1u, this->getSize()))
+			{
+				Vector<T> result(expression);
+				this->mVec.swap(result.mVec);
+				return *this;
+			}
+			evaluateVectorExpression(mVec.data(), 1u, expression.self());
+			return *this;
+		}
+
+
 	public:
 		//Gives access to components
 		T& at(VectorEntry const & entry)
@@ -77,7 +288,7 @@ namespace Mat
 			{
 				throw InvalidIndexException("Vector<T>::at(VectorEntry const & entry): entry is not a valid index!", entry);
 			}
-			return mVec.at(entry);
+			return mVec[entry];
 		}
 		
 
@@ -88,7 +299,65 @@ namespace Mat
 			{
 				throw InvalidIndexException("Vector<T>::at(VectorEntry const & entry) const: entry is not a valid index!", entry);
 			}
-			return mVec.at(entry);
+			return mVec[entry];
+		}
+
+
+		//Gives access to components, the bound is only checked in debug builds
+		T& operator[](VectorEntry const & entry)
+		{
+#ifdef MATRIX_DEBUG_CHECKS
+			if (entry >= mVec.size())
+			{
+				throw InvalidIndexException("Vector<T>::operator[](VectorEntry const & entry): entry is not a valid index!", entry);
+			}
+#endif
+			return mVec[entry];
+		}
+
+
+		//Gives constant access to components, the bound is only checked in debug builds
+		T const & operator[](VectorEntry const & entry) const
+		{
+#ifdef MATRIX_DEBUG_CHECKS
+			if (entry >= mVec.size())
+			{
+				throw InvalidIndexException("Vector<T>::operator[](VectorEntry const & entry) const: entry is not a valid index!", entry);
+			}
+#endif
+			return mVec[entry];
+		}
+
+
+		//Iterators over the contiguous components
+		iterator begin()
+		{
+			return mVec.data();
+		}
+
+		iterator end()
+		{
+			return mVec.data() + mVec.size();
+		}
+
+		const_iterator begin() const
+		{
+			return mVec.data();
+		}
+
+		const_iterator end() const
+		{
+			return mVec.data() + mVec.size();
+		}
+
+		const_iterator cbegin() const
+		{
+			return mVec.data();
+		}
+
+		const_iterator cend() const
+		{
+			return mVec.data() + mVec.size();
 		}
 
 
@@ -99,6 +368,76 @@ namespace Mat
 		}
 
 
+		//Returns the component at entry without bounds check (used by the expression evaluation)
+		T const & evaluateAt(VectorEntry const & entry) const
+		{
+			return mVec[entry];
+		}
+
+
+		//Gives direct access to the contiguous buffer
+		T* data()
+		{
+			return mVec.data();
+		}
+
+
+		//Gives direct constant access to the contiguous buffer
+		T const * data() const
+		{
+			return mVec.data();
+		}
+
+
+		//Returns the distance between two consecutive components in the buffer (always 1, views may differ)
+		unsigned int getStride() const
+		{
+			return 1u;
+		}
+
+
+		//Returns the memory resource the storage was allocated from
+		MemoryResource* getMemoryResource() const
+		{
+			return mVec.get_allocator().getResource();
+		}
+
+
+		//Returns whether writing to the strided components beginning at data could change this before it is read
+		bool mayAlias(T const * data, unsigned int stride, VectorSize size) const
+		{
+			return this->getView().mayAlias(data, stride, size);
+		}
+
+
+		//Returns a view of the whole vector (views stay valid until the vector is resized or destroyed)
+		VectorView<T> getView()
+		{
+			return VectorView<T>(mVec.data(), this->getSize());
+		}
+
+
+		//Returns a constant view of the whole vector
+		VectorView<T const> getView() const
+		{
+			return VectorView<T const>(mVec.data(), this->getSize());
+		}
+
+
+		//Returns a view of the components from origin on with size size (clipped like getSubvector), without copying
+		VectorView<T> getSubvectorView(VectorEntry const & origin, VectorSize const & size)
+		{
+			return this->getView().getSubvectorView(origin, size);
+		}
+
+
+		//Returns a constant view of the components from origin on with size size
+		VectorView<T const> getSubvectorView(VectorEntry const & origin, VectorSize const & size) const
+		{
+			return this->getView().getSubvectorView(origin, size);
+		}
+
+
 		//Constructor that constructs vector from vector of other type
 		template <typename S> explicit Vector(Vector<S> const & other)
 			: Vector(other.getSize())
@@ -125,16 +464,55 @@ namespace Mat
 		}
 
 
-		//Returns a subvector from origin on with size size (If subvector doesn't fit into this vector, the resulting size will be smaller than size)
-		Vector<T> getSubvector(VectorEntry const & origin, VectorSize const & size) const
+		//Returns all VectorEntries whose values differ from val less or equal than tolerance in one contiguous vector
+		//The comparison is vectorized and long vectors are scanned on the thread pool
+		std::vector<VectorEntry> findAll(T const & val, T const & tolerance = T(0)) const
 		{
-			VectorSize resultSize = std::min(size, this->getSize() - origin);
-			Vector<T> subVec(resultSize);
-			for (unsigned int i = 0; i < resultSize; ++i)
+			MATRIX_PROFILE("Vector::findAll", 2.0 * this->getSize(), this->getSize(), 1u);
+			return Kernel::findAll<VectorEntry>(mVec.size(), mVec.data(), val, tolerance, [](std::size_t i)
 			{
-				subVec.at(i) = this->at(origin + i);
+				return static_cast<VectorEntry>(i);
+			});
+		}
+
+
+		//Returns one bit per component: bit i % 64 of word i / 64 is set if component i differs from val less or equal than tolerance
+		std::vector<std::uint64_t> findMask(T const & val, T const & tolerance = T(0)) const
+		{
+			MATRIX_PROFILE("Vector::findMask", 2.0 * this->getSize(), this->getSize(), 1u);
+			std::vector<std::uint64_t> bits((mVec.size() + 63) / 64);
+			Kernel::findMask(mVec.size(), mVec.data(), val, tolerance, bits.data());
+			return bits;
+		}
+
+
+		//Returns the number of components which differ from val less or equal than tolerance (allocates nothing)
+		std::size_t count(T const & val, T const & tolerance = T(0)) const
+		{
+			MATRIX_PROFILE("Vector::count", 2.0 * this->getSize(), this->getSize(), 1u);
+			return Kernel::countMatches(mVec.size(), mVec.data(), val, tolerance);
+		}
+
+
+		//Looks for the first component which differs from val less or equal than tolerance and stores its index in entry
+		//Returns false (and leaves entry unchanged) if there is none. Allocates nothing and stops at the first match
+		bool findFirst(T const & val, VectorEntry & entry, T const & tolerance = T(0)) const
+		{
+			MATRIX_PROFILE("Vector::findFirst", 0.0, this->getSize(), 1u);
+			std::size_t const i = Kernel::findFirst(mVec.size(), mVec.data(), val, tolerance);
+			if (i == mVec.size())
+			{
+				return false;
 			}
-			return subVec;
+			entry = static_cast<VectorEntry>(i);
+			return true;
+		}
+
+
+		//Returns a subvector from origin on with size size (If subvector doesn't fit into this vector, the resulting size will be smaller than size)
+		Vector<T> getSubvector(VectorEntry const & origin, VectorSize const & size) const
+		{
+			return this->getSubvectorView(origin, size).toVector();
 		}
 
 
@@ -155,24 +533,127 @@ namespace Mat
 		}
 
 
-		//Does action for every entry in this vector
-		void doForEveryEntry(std::function<void(T& entry, VectorEntry const & entryPos)> action)
+		//Calls action(entry, entryPos) for every entry in this vector, in order if execution is Sequential
+		//action can be any callable (lambdas are inlined, no std::function is involved)
+		template <typename F> void doForEveryEntry(F action, Execution execution = Execution::Sequential)
 		{
-			for (unsigned int i = 0; i < this->getSize(); ++i)
+			MATRIX_PROFILE("Vector::doForEveryEntry", 0.0, this->getSize(), 1u);
+			T* const data = mVec.data();
+			Kernel::forRanges(mVec.size(), execution, [&](std::size_t begin, std::size_t end)
 			{
-				T& entry = this->at(i);
-				action(entry, i);
-			}
+				for (std::size_t i = begin; i < end; ++i)
+				{
+					action(data[i], static_cast<VectorEntry>(i));
+				}
+			});
+		}
+
+
+		//Calls f(entry) for every entry in this vector, in order if execution is Sequential
+		template <typename F> void forEach(F f, Execution execution = Execution::Sequential)
+		{
+			MATRIX_PROFILE("Vector::forEach", 0.0, this->getSize(), 1u);
+			Kernel::forEach(mVec.size(), mVec.data(), f, execution);
+		}
+
+
+		//Calls f(entry) for every entry in this vector, in order if execution is Sequential
+		template <typename F> void forEach(F f, Execution execution = Execution::Sequential) const
+		{
+			MATRIX_PROFILE("Vector::forEach", 0.0, this->getSize(), 1u);
+			Kernel::forEach(mVec.size(), mVec.data(), f, execution);
 		}
 
 
 	}; //Class Template: Vector
 
 
-	template <typename T> std::ostream& operator<<(std::ostream& oStream, Vector<T> const & vec)
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Struct Template IsStoredVector, which tells whether E keeps its components in memory (Vector and views),
+	//so that operations on it can be handed to the SIMD kernels via data() and getStride()
+	template <typename E> struct IsStoredVector : std::false_type {};
+	template <typename T> struct IsStoredVector<Vector<T>> : std::true_type {};
+
+
+	//Evaluates a vector expression into dst[0], dst[stride], ... with one fused loop over all components
+	template <typename T, typename E> void evaluateVectorExpression(T* dst, unsigned int stride, VectorExpression<E> const & expression)
+	{
+		E const & e = expression.self();
+		VectorSize const size = e.getSize();
+		for (VectorEntry i = 0; i < size; ++i)
+		{
+			dst[static_cast<std::size_t>(i) * stride] = e.evaluateAt(i);
+		}
+	}
+
+
+	//Plain operations between stored vectors go straight to the SIMD kernels if all components are contiguous
+	template <typename T, typename L, typename R> typename std::enable_if<IsStoredVector<L>::value && IsStoredVector<R>::value>::type
+	evaluateVectorExpression(T* dst, unsigned int stride, VectorBinaryExpression<L, R, Operation::Add> const & e)
 	{
+		if ((stride != 1) || (e.left().getStride() != 1) || (e.right().getStride() != 1))
+		{
+			evaluateVectorExpression(dst, stride, static_cast<VectorExpression<VectorBinaryExpression<L, R, Operation::Add>> const &>(e));
+			return;
+		}
+		Simd::add(e.getSize(), e.left().data(), e.right().data(), dst);
+	}
+
+
+	template <typename T, typename L, typename R> typename std::enable_if<IsStoredVector<L>::value && IsStoredVector<R>::value>::type
+	evaluateVectorExpression(T* dst, unsigned int stride, VectorBinaryExpression<L, R, Operation::Subtract> const & e)
+	{
+		if ((stride != 1) || (e.left().getStride() != 1) || (e.right().getStride() != 1))
+		{
+			evaluateVectorExpression(dst, stride, static_cast<VectorExpression<VectorBinaryExpression<L, R, Operation::Subtract>> const &>(e));
+			return;
+		}
+		Simd::subtract(e.getSize(), e.left().data(), e.right().data(), dst);
+	}
+
+
+	template <typename T, typename E> typename std::enable_if<IsStoredVector<E>::value>::type
+	evaluateVectorExpression(T* dst, unsigned int stride, VectorScalarExpression<E, Operation::Scale> const & e)
+	{
+		if ((stride != 1) || (e.operand().getStride() != 1))
+		{
+			evaluateVectorExpression(dst, stride, static_cast<VectorExpression<VectorScalarExpression<E, Operation::Scale>> const &>(e));
+			return;
+		}
+		Simd::scale(e.getSize(), e.operand().data(), e.scalar(), dst);
+	}
+
+
+	template <typename T, typename E> typename std::enable_if<IsStoredVector<E>::value>::type
+	evaluateVectorExpression(T* dst, unsigned int stride, VectorScalarExpression<E, Operation::Divide> const & e)
+	{
+		if ((stride != 1) || (e.operand().getStride() != 1))
+		{
+			evaluateVectorExpression(dst, stride, static_cast<VectorExpression<VectorScalarExpression<E, Operation::Divide>> const &>(e));
+			return;
+		}
+		Simd::divide(e.getSize(), e.operand().data(), e.scalar(), dst);
+	}
+
+
+	template <typename T, typename E> typename std::enable_if<IsStoredVector<E>::value>::type
+	evaluateVectorExpression(T* dst, unsigned int stride, VectorUnaryExpression<E, Operation::Negate> const & e)
+	{
+		if ((stride != 1) || (e.operand().getStride() != 1))
+		{
+			evaluateVectorExpression(dst, stride, static_cast<VectorExpression<VectorUnaryExpression<E, Operation::Negate>> const &>(e));
+			return;
+		}
+		Simd::negate(e.getSize(), e.operand().data(), dst);
+	}
+
+
+
+	template <typename E> std::ostream& operator<<(std::ostream& oStream, VectorExpression<E> const & vec)
+	{
+		E const & e = vec.self();
 		bool first = true;
-		for (unsigned int i = 0; i < vec.getSize(); ++i)
+		for (unsigned int i = 0; i < e.getSize(); ++i)
 		{
 			if (first)
 			{
@@ -182,13 +663,16 @@ namespace Mat
 			{
 				oStream << " ";
 			}
-			oStream << vec.at(i);
+			oStream << e.evaluateAt(i);
 		}
 		return oStream;
 	}
 
 
 
+	//All arithmetic operators below build lazy expressions, which are evaluated in one fused loop
+	//when assigned to a Vector. Sizes are checked once, when the expression is built.
+
 
 	//Returns this vector
 	template <typename T> Vector<T> operator+(Vector<T> const & vec)
@@ -198,70 +682,52 @@ namespace Mat
 
 
 	//Returns the negation of this vector
-	template <typename T> Vector<T> operator-(Vector<T> const & vec)
+	template <typename E> VectorUnaryExpression<E, Operation::Negate> operator-(VectorExpression<E> const & vec)
 	{
-		Vector<T> res(vec);
-		res.doForEveryEntry([](T& entry, VectorEntry const & pos) {entry = -entry; });
-		return res;
+		return VectorUnaryExpression<E, Operation::Negate>(vec.self());
 	}
 
 
 	//Componentwise addition
-	template <typename T> Vector<T> operator+(Vector<T> const & vec1, Vector<T> const & vec2)
+	template <typename E1, typename E2> VectorBinaryExpression<E1, E2, Operation::Add> operator+(VectorExpression<E1> const & vec1, VectorExpression<E2> const & vec2)
 	{
-		if (vec1.getSize() != vec2.getSize())
-		{
-			throw IncompatibleVectorSizesException("operator+(Vector<T> const & vec1, Vector<T> const & vec2: The vectors don't have the same size!", vec1.getSize(), vec2.getSize());
-		}
-		Vector<T> res(vec1);
-		for (unsigned int i = 0; i < vec1.getSize(); ++i)
+		if (vec1.self().getSize() != vec2.self().getSize())
 		{
-			res.at(i) += vec2.at(i);
+			throw IncompatibleVectorSizesException("operator+(Vector<T> const & vec1, Vector<T> const & vec2: The vectors don't have the same size!", vec1.self().getSize(), vec2.self().getSize());
 		}
-		return res;
+		return VectorBinaryExpression<E1, E2, Operation::Add>(vec1.self(), vec2.self());
 	}
 
 
 	//Componentwise subtraction
-	template <typename T> Vector<T> operator-(Vector<T> const & vec1, Vector<T> const & vec2)
+	template <typename E1, typename E2> VectorBinaryExpression<E1, E2, Operation::Subtract> operator-(VectorExpression<E1> const & vec1, VectorExpression<E2> const & vec2)
 	{
-		if (vec1.getSize() != vec2.getSize())
-		{
-			throw IncompatibleVectorSizesException("operator-(Vector<T> const & vec1, Vector<T> const & vec2: The vectors don't have the same size!", vec1.getSize(), vec2.getSize());
-		}
-		Vector<T> res(vec1);
-		for (unsigned int i = 0; i < vec1.getSize(); ++i)
+		if (vec1.self().getSize() != vec2.self().getSize())
 		{
-			res.at(i) -= vec2.at(i);
+			throw IncompatibleVectorSizesException("operator-(Vector<T> const & vec1, Vector<T> const & vec2: The vectors don't have the same size!", vec1.self().getSize(), vec2.self().getSize());
 		}
-		return res;
+		return VectorBinaryExpression<E1, E2, Operation::Subtract>(vec1.self(), vec2.self());
 	}
 
 
 	//Entrywise multiplication with scalar from right
-	template <typename T> Vector<T> operator*(Vector<T> const & vec, T const & scalar)
+	template <typename E> VectorScalarExpression<E, Operation::Scale> operator*(VectorExpression<E> const & vec, typename E::ValueType const & scalar)
 	{
-		Vector<T> res(vec);
-		res.doForEveryEntry([&scalar](T& entry, VectorEntry const & pos) {entry *= scalar; });
-		return res;
+		return VectorScalarExpression<E, Operation::Scale>(vec.self(), scalar);
 	}
 
 
 	//Entrywise multiplication with scalar from left
-	template <typename T> Vector<T> operator*(T const & scalar, Vector<T> const & vec)
+	template <typename E> VectorScalarExpression<E, Operation::Scale> operator*(typename E::ValueType const & scalar, VectorExpression<E> const & vec)
 	{
-		Vector<T> res(vec);
-		res.doForEveryEntry([&scalar](T& entry, VectorEntry const & pos) {entry *= scalar; });
-		return res;
+		return VectorScalarExpression<E, Operation::Scale>(vec.self(), scalar);
 	}
 
 
 	//Entrywise division by scalar
-	template <typename T> Vector<T> operator/(Vector<T> const & vec, T const & scalar)
+	template <typename E> VectorScalarExpression<E, Operation::Divide> operator/(VectorExpression<E> const & vec, typename E::ValueType const & scalar)
 	{
-		Vector<T> res(vec);
-		res.doForEveryEntry([&scalar](T& entry, VectorEntry const & pos) {entry /= scalar; });
-		return res;
+		return VectorScalarExpression<E, Operation::Divide>(vec.self(), scalar);
 	}
 
 
@@ -272,27 +738,114 @@ namespace Mat
 		{
 			throw IncompatibleVectorSizesException("operator*(Vector<T> const & vec1, Vector<T> const & vec2: The vectors don't have the same size!", vec1.getSize(), vec2.getSize());
 		}
-		T sum = T(0);
-		for (unsigned int i = 0; i < vec1.getSize(); ++i)
+		MATRIX_PROFILE("operator*(Vector, Vector)", 2.0 * vec1.getSize(), vec1.getSize(), 1u, vec2.getSize(), 1u);
+		return Kernel::dot<T>(vec1.getSize(), vec1.data(), vec2.data(), getSummationMode());
+	}
+
+
+	//Inner product of two vector expressions (fused, without temporaries)
+	template <typename E1, typename E2> typename E1::ValueType operator*(VectorExpression<E1> const & vec1, VectorExpression<E2> const & vec2)
+	{
+		E1 const & e1 = vec1.self();
+		E2 const & e2 = vec2.self();
+		if (e1.getSize() != e2.getSize())
+		{
+			throw IncompatibleVectorSizesException("operator*(Vector<T> const & vec1, Vector<T> const & vec2: The vectors don't have the same size!", e1.getSize(), e2.getSize());
+		}
+		MATRIX_PROFILE("operator*(VectorExpression, VectorExpression)", 2.0 * e1.getSize(), e1.getSize(), 1u, e2.getSize(), 1u);
+		typename E1::ValueType sum = typename E1::ValueType(0);
+		for (VectorEntry i = 0; i < e1.getSize(); ++i)
 		{
-			sum += vec1.at(i) * vec2.at(i);
+			sum += e1.evaluateAt(i) * e2.evaluateAt(i);
 		}
 		return sum;
 	}
 
 
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Level 1 BLAS (kernels in Blas1.hpp): SIMD over the contiguous components, long vectors on the thread pool.
+	//The reductions sum as mode says (see SummationMode) and give the same result for every thread count
+
+	//Returns the inner product of x and y
+	template <typename T> T dot(Vector<T> const & x, Vector<T> const & y, SummationMode mode = getSummationMode())
+	{
+		if (x.getSize() != y.getSize())
+		{
+			throw IncompatibleVectorSizesException("dot(Vector<T> const & x, Vector<T> const & y, SummationMode mode): The vectors don't have the same size!", x.getSize(), y.getSize());
+		}
+		MATRIX_PROFILE("dot", 2.0 * x.getSize(), x.getSize(), 1u, y.getSize(), 1u);
+		return Kernel::dot<T>(x.getSize(), x.data(), y.data(), mode);
+	}
+
+
+	//Computes y += alpha * x in the storage of y, without temporaries (x may be y itself)
+	template <typename T> void axpy(typename Vector<T>::ValueType const & alpha, Vector<T> const & x, Vector<T> & y)
+	{
+		if (x.getSize() != y.getSize())
+		{
+			throw IncompatibleVectorSizesException("axpy(alpha, Vector<T> const & x, Vector<T> & y): The vectors don't have the same size!", x.getSize(), y.getSize());
+		}
+		MATRIX_PROFILE("axpy", 2.0 * x.getSize(), x.getSize(), 1u, y.getSize(), 1u);
+		Kernel::axpy<T>(x.getSize(), alpha, x.data(), y.data());
+	}
+
+
+	//Computes x *= alpha in place
+	template <typename T> void scal(typename Vector<T>::ValueType const & alpha, Vector<T> & x)
+	{
+		MATRIX_PROFILE("scal", static_cast<double>(x.getSize()), x.getSize(), 1u);
+		Kernel::scal<T>(x.getSize(), alpha, x.data());
+	}
+
+
+	//Returns the Euclidean norm of x (floating point types only); intermediate results neither overflow nor underflow
+	template <typename T> T nrm2(Vector<T> const & x, SummationMode mode = getSummationMode())
+	{
+		MATRIX_PROFILE("nrm2", 2.0 * x.getSize(), x.getSize(), 1u);
+		return Kernel::nrm2<T>(x.getSize(), x.data(), mode);
+	}
+
+
+	//Returns the sum of the absolute values of the components of x
+	template <typename T> T asum(Vector<T> const & x, SummationMode mode = getSummationMode())
+	{
+		MATRIX_PROFILE("asum", static_cast<double>(x.getSize()), x.getSize(), 1u);
+		return Kernel::asum<T>(x.getSize(), x.data(), mode);
+	}
+
+
+	//Returns the first index of the component with the largest absolute value (NaN components are skipped; 0 for an empty vector)
+	template <typename T> VectorEntry iamax(Vector<T> const & x)
+	{
+		MATRIX_PROFILE("iamax", 0.0, x.getSize(), 1u);
+		return static_cast<VectorEntry>(Kernel::findExtremeAbs<T>(x.getSize(), x.data(), true));
+	}
+
+
+	//Returns the first index of the component with the smallest absolute value (NaN components are skipped; 0 for an empty vector)
+	template <typename T> VectorEntry iamin(Vector<T> const & x)
+	{
+		MATRIX_PROFILE("iamin", 0.0, x.getSize(), 1u);
+		return static_cast<VectorEntry>(Kernel::findExtremeAbs<T>(x.getSize(), x.data(), false));
+	}
+
+
+
+	//The compound operators update vec1 in its own storage, without allocating (unless vec2 partially overlaps vec1)
+
+
 	//Adds vec2 to vec1
-	template <typename T> Vector<T>& operator+=(Vector<T>& vec1, Vector<T> const & vec2)
+	template <typename T, typename E> Vector<T>& operator+=(Vector<T>& vec1, VectorExpression<E> const & vec2)
 	{
-		vec1 = vec1 + vec2;
+		vec1.getView() += vec2;
 		return vec1;
 	}
 
 
 	//Subtracts vec2 from vec1
-	template <typename T> Vector<T>& operator-=(Vector<T>& vec1, Vector<T> const & vec2)
+	template <typename T, typename E> Vector<T>& operator-=(Vector<T>& vec1, VectorExpression<E> const & vec2)
 	{
-		vec1 = vec1 - vec2;
+		vec1.getView() -= vec2;
 		return vec1;
 	}
 
@@ -300,7 +853,7 @@ namespace Mat
 	//Multiplies vec with scalar
 	template <typename T> Vector<T>& operator*=(Vector<T>& vec, T const & scalar)
 	{
-		vec = vec * scalar;
+		vec.getView() *= scalar;
 		return vec;
 	}
 
@@ -308,13 +861,150 @@ namespace Mat
 	//Divides vec by scalar
 	template <typename T> Vector<T>& operator/=(Vector<T>& vec, T const & scalar)
 	{
-		vec = vec / scalar;
+		vec.getView() /= scalar;
 		return vec;
 	}
 
 
 
+	//The overloads below take an expiring Vector operand and write the result into its storage instead of allocating
+
+
+	//Componentwise addition into the storage of vec1
+	template <typename T, typename E> Vector<T> operator+(Vector<T>&& vec1, VectorExpression<E> const & vec2)
+	{
+		vec1 += vec2;
+		return std::move(vec1);
+	}
+
+
+	//Componentwise addition into the storage of vec2
+	template <typename E, typename T> Vector<T> operator+(VectorExpression<E> const & vec1, Vector<T>&& vec2)
+	{
+		vec2 += vec1;
+		return std::move(vec2);
+	}
+
+
+	//Componentwise addition into the storage of vec1
+	template <typename T> Vector<T> operator+(Vector<T>&& vec1, Vector<T>&& vec2)
+	{
+		vec1 += vec2;
+		return std::move(vec1);
+	}
+
+
+	//Componentwise subtraction into the storage of vec1
+	template <typename T, typename E> Vector<T> operator-(Vector<T>&& vec1, VectorExpression<E> const & vec2)
+	{
+		vec1 -= vec2;
+		return std::move(vec1);
+	}
+
+
+	//Componentwise subtraction into the storage of vec2
+	template <typename E, typename T> Vector<T> operator-(VectorExpression<E> const & vec1, Vector<T>&& vec2)
+	{
+		if (vec1.self().getSize() != vec2.getSize())
+		{
+			throw IncompatibleVectorSizesException("operator-(Vector<T> const & vec1, Vector<T> const & vec2: The vectors don't have the same size!", vec1.self().getSize(), vec2.getSize());
+		}
+		vec2.getView() = vec1.self() - vec2;
+		return std::move(vec2);
+	}
+
+
+	//Componentwise subtraction into the storage of vec1
+	template <typename T> Vector<T> operator-(Vector<T>&& vec1, Vector<T>&& vec2)
+	{
+		vec1 -= vec2;
+		return std::move(vec1);
+	}
+
+
+	//Entrywise multiplication with scalar from right into the storage of vec
+	template <typename T> Vector<T> operator*(Vector<T>&& vec, typename Vector<T>::ValueType const & scalar)
+	{
+		vec *= scalar;
+		return std::move(vec);
+	}
+
+
+	//Entrywise multiplication with scalar from left into the storage of vec
+	template <typename T> Vector<T> operator*(typename Vector<T>::ValueType const & scalar, Vector<T>&& vec)
+	{
+		vec *= scalar;
+		return std::move(vec);
+	}
+
+
+	//Entrywise division by scalar into the storage of vec
+	template <typename T> Vector<T> operator/(Vector<T>&& vec, typename Vector<T>::ValueType const & scalar)
+	{
+		vec /= scalar;
+		return std::move(vec);
+	}
+
+
+	//Returns the negation of vec in its storage
+	template <typename T> Vector<T> operator-(Vector<T>&& vec)
+	{
+		vec.getView() = -vec;
+		return std::move(vec);
+	}
+
+
+	//Stores f(src[i]) in dst[i] for every entry (dst has to have the size of src, but may be src itself)
+	template <typename T, typename U, typename F> void transform(Vector<T> const & src, Vector<U> & dst, F f, Execution execution = Execution::Sequential)
+	{
+		if (src.getSize() != dst.getSize())
+		{
+			throw IncompatibleVectorSizesException("transform(Vector<T> const & src, Vector<U> & dst, F f, Execution execution): src and dst do not have the same size!", src.getSize(), dst.getSize());
+		}
+		MATRIX_PROFILE("transform(Vector, Vector)", 0.0, src.getSize(), 1u);
+		Kernel::transform(src.getSize(), src.data(), dst.data(), f, execution);
+	}
+
+
+	//Stores f(a[i], b[i]) in dst[i] for every entry (all three have to have the same size; dst may be a or b)
+	template <typename T1, typename T2, typename U, typename F> void transform(Vector<T1> const & a, Vector<T2> const & b, Vector<U> & dst, F f, Execution execution = Execution::Sequential)
+	{
+		if (a.getSize() != b.getSize())
+		{
+			throw IncompatibleVectorSizesException("transform(Vector<T1> const & a, Vector<T2> const & b, Vector<U> & dst, F f, Execution execution): a and b do not have the same size!", a.getSize(), b.getSize());
+		}
+		if (a.getSize() != dst.getSize())
+		{
+			throw IncompatibleVectorSizesException("transform(Vector<T1> const & a, Vector<T2> const & b, Vector<U> & dst, F f, Execution execution): a and dst do not have the same size!", a.getSize(), dst.getSize());
+		}
+		MATRIX_PROFILE("transform(Vector, Vector, Vector)", 0.0, a.getSize(), 1u);
+		Kernel::transform(a.getSize(), a.data(), b.data(), dst.data(), f, execution);
+	}
+
+
+	//Returns init folded with map(entry) for every entry of vec by op, as R result = op(result, map(entry))
+	//Entries are visited in order; see Kernel::mapReduce for how they are grouped (sequential and parallel results are identical)
+	template <typename T, typename R, typename Map, typename Op> R mapReduce(Vector<T> const & vec, R init, Map map, Op op, Execution execution = Execution::Sequential)
+	{
+		MATRIX_PROFILE("mapReduce(Vector)", 0.0, vec.getSize(), 1u);
+		return Kernel::mapReduce(vec.getSize(), vec.data(), init, map, op, execution);
+	}
+
+
+	//Returns init folded with every entry of vec by op (see mapReduce)
+	template <typename T, typename R, typename Op> R reduce(Vector<T> const & vec, R init, Op op, Execution execution = Execution::Sequential)
+	{
+		auto identity = [](T const & entry) -> T const & { return entry; };
+		return mapReduce(vec, init, identity, op, execution);
+	}
+
+
+
 } //Namespace: Mat
 
+
+#include "VectorView.hpp"
+#include "FixedVector.hpp"
+
 #endif //VECTOR_HPP
 
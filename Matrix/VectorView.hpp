@@ -0,0 +1,274 @@
+#ifndef VECTOR_VIEW_HPP
+#define VECTOR_VIEW_HPP
+
+#include <list>
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+
+#include "Expression.hpp"
+#include "StridedIterator.hpp"
+#include "Vector.hpp"
+
+
+
+namespace Mat
+{
+
+	//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//Class Template VectorView, which references size components at data[0], data[stride], ... without owning them
+	//VectorView<T const> only reads. Views are cheap to copy (copies reference the same components), but assigning
+	//to a view overwrites the referenced components, just like assigning to a Vector
+	template <typename T> class VectorView : public VectorExpression<VectorView<T>>
+	{
+	public:
+		typedef typename std::remove_const<T>::type ValueType;
+		typedef StridedIterator<T> iterator;
+		typedef StridedIterator<T const> const_iterator;
+
+	private:
+		T* mData;
+		VectorSize mSize;
+		unsigned int mStride; //Distance (in elements) between two consecutive components
+
+	public:
+		//Standard constructor constructs an empty view
+		VectorView()
+			: mData(nullptr), mSize(0u), mStride(1u)
+		{}
+
+
+		//Constructor that references size components beginning at data, stride elements apart
+		VectorView(T* data, VectorSize size, unsigned int stride = 1u)
+			: mData(data), mSize(size), mStride(stride)
+		{}
+
+
+		//Mutable views convert implicitly to constant views
+		template <typename S, typename = typename std::enable_if<std::is_same<S const, T>::value && !std::is_same<S, T>::value>::type>
+		VectorView(VectorView<S> const & other)
+			: mData(other.data()), mSize(other.getSize()), mStride(other.getStride())
+		{}
+
+
+		VectorView(VectorView<T> const & other) = default;
+
+
+		//Copies the components of other into the components of this view
+		VectorView<T>& operator=(VectorView<T> const & other)
+		{
+			return this->assign(other);
+		}
+
+
+		//Evaluates a vector expression into the components of this view (sizes have to match)
+		template <typename E> typename std::enable_if<std::is_same<typename E::ValueType, ValueType>::value, VectorView<T>&>::type
+		operator=(VectorExpression<E> const & expression)
+		{
+			return this->assign(expression);
+		}
+
+
+	public:
+		//Returns the number of components
+		VectorSize getSize() const
+		{
+			return mSize;
+		}
+
+
+		//Returns the distance between two consecutive components in elements
+		unsigned int getStride() const
+		{
+			return mStride;
+		}
+
+
+		//Returns a pointer to the first component
+		T* data() const
+		{
+			return mData;
+		}
+
+
+		//Gives access to the components
+		T& at(VectorEntry const & entry) const
+		{
+			if (entry >= mSize)
+			{
+				throw InvalidIndexException("VectorView<T>::at(VectorEntry const & entry) const: entry is not a valid index!", entry);
+			}
+			return mData[static_cast<std::size_t>(entry) * mStride];
+		}
+
+
+		//Gives access to the components, the bound is only checked in debug builds
+		T& operator[](VectorEntry const & entry) const
+		{
+#ifdef MATRIX_DEBUG_CHECKS
+			if (entry >= mSize)
+			{
+				throw InvalidIndexException("VectorView<T>::operator[](VectorEntry const & entry) const: entry is not a valid index!", entry);
+			}
+#endif
+			return mData[static_cast<std::size_t>(entry) * mStride];
+		}
+
+
+		//Iterators over the (strided) components
+		iterator begin() const
+		{
+			return iterator(mData, mStride);
+		}
+
+		iterator end() const
+		{
+			return iterator(mData, mStride) + mSize;
+		}
+
+		const_iterator cbegin() const
+		{
+			return this->begin();
+		}
+
+		const_iterator cend() const
+		{
+			return this->end();
+		}
+
+
+		//Returns the component at entry without bounds check (used by the expression evaluation)
+		ValueType const & evaluateAt(VectorEntry const & entry) const
+		{
+			return mData[static_cast<std::size_t>(entry) * mStride];
+		}
+
+
+		//Returns whether writing to the strided components beginning at data could change this before it is read
+		//Writing exactly the components of this view is fine, because every component is read right before it is written
+		bool mayAlias(ValueType const * data, unsigned int stride, VectorSize size) const
+		{
+			if ((data == mData) && (stride == mStride))
+			{
+				return false;
+			}
+			return rangesOverlap<ValueType>(mData, VectorView<T>::getEnd(mData, mStride, mSize), data, VectorView<T>::getEnd(data, stride, size));
+		}
+
+
+		//Returns a list of all VectorEntries whose values differ from val less or equal than tolerance
+		std::list<VectorEntry> find(ValueType const & val, ValueType const & tolerance = ValueType(0)) const
+		{
+			std::list<VectorEntry> list;
+			for (unsigned int i = 0; i < mSize; ++i)
+			{
+				if (std::abs(this->evaluateAt(i) - val) <= tolerance)
+				{
+					list.push_back(i);
+				}
+			}
+			return list;
+		}
+
+
+		//Fills all referenced components with value
+		void fillWith(ValueType const & value) const
+		{
+			if (mStride == 1)
+			{
+				std::fill(mData, mData + mSize, value);
+				return;
+			}
+			for (unsigned int i = 0; i < mSize; ++i)
+			{
+				mData[static_cast<std::size_t>(i) * mStride] = value;
+			}
+		}
+
+
+		//Returns a view of the components from origin on with size size (If it doesn't fit into this view, the resulting size will be smaller than size)
+		VectorView<T> getSubvectorView(VectorEntry const & origin, VectorSize const & size) const
+		{
+			if (origin >= mSize)
+			{
+				return VectorView<T>(mData, 0u, mStride);
+			}
+			return VectorView<T>(mData + static_cast<std::size_t>(origin) * mStride, std::min(size, mSize - origin), mStride);
+		}
+
+
+		//Copies the referenced components into a new Vector
+		Vector<ValueType> toVector() const
+		{
+			return Vector<ValueType>(*this);
+		}
+
+
+		//Adds vec to the referenced components
+		template <typename E> VectorView<T>& operator+=(VectorExpression<E> const & vec)
+		{
+			return *this = *this + vec;
+		}
+
+
+		//Subtracts vec from the referenced components
+		template <typename E> VectorView<T>& operator-=(VectorExpression<E> const & vec)
+		{
+			return *this = *this - vec;
+		}
+
+
+		//Multiplies the referenced components with scalar
+		VectorView<T>& operator*=(ValueType const & scalar)
+		{
+			return *this = *this * scalar;
+		}
+
+
+		//Divides the referenced components by scalar
+		VectorView<T>& operator/=(ValueType const & scalar)
+		{
+			return *this = *this / scalar;
+		}
+
+
+	private:
+		template <typename E> VectorView<T>& assign(VectorExpression<E> const & expression)
+		{
+			E const & e = expression.self();
+			if (e.getSize() != mSize)
+			{
+				throw IncompatibleVectorSizesException("VectorView<T>::operator=(VectorExpression<E> const & expression): expression and view don't have the same size!", mSize, e.getSize());
+			}
+
+			//Overlapping operands are evaluated into a temporary first, so that no component is overwritten before it is read
+			if (e.mayAlias(mData, mStride, mSize))
+			{
+				Vector<ValueType> const temporary(e);
+				evaluateVectorExpression(mData, mStride, temporary);
+			}
+			else
+			{
+				evaluateVectorExpression(mData, mStride, e);
+			}
+			return *this;
+		}
+
+
+		//Returns the pointer behind the last referenced component
+		template <typename P> static P* getEnd(P* data, unsigned int stride, VectorSize size)
+		{
+			return (size == 0) ? data : data + static_cast<std::size_t>(size - 1) * stride + 1;
+		}
+
+
+	}; //Class Template: VectorView
+
+
+	template <typename T> struct IsStoredVector<VectorView<T>> : std::true_type {};
+
+
+
+} //Namespace: Mat
+
+#endif //VECTOR_VIEW_HPP
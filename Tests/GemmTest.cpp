@@ -0,0 +1,72 @@
+#include <algorithm>
+#include <initializer_list>
+
+#include "Matrix.hpp"
+#include "ThreadPool.hpp"
+#include "TestUtilities.hpp"
+
+
+
+namespace
+{
+
+	//Small integer entries keep every product exact, so float and double results have to match the reference bit for bit
+	template <typename T> Mat::Matrix<T> makeMatrix(unsigned int m, unsigned int n, unsigned int seed)
+	{
+		Mat::Matrix<T> mat(Mat::MN(m, n));
+		unsigned int state = seed;
+		for (T& entry : mat)
+		{
+			state = state * 1664525u + 1013904223u;
+			entry = static_cast<T>(static_cast<int>(state >> 24) % 7 - 3);
+		}
+		return mat;
+	}
+
+
+	template <typename T> bool equal(Mat::Matrix<T> const & a, Mat::Matrix<T> const & b)
+	{
+		return (a.getSize() == b.getSize()) && std::equal(a.begin(), a.end(), b.begin());
+	}
+
+
+	//Shapes (m, k, n) that are no multiples of the register tile (MR x NR) or the cache blocks (MC, KC, NC), including
+	//empty inner dimensions, single rows and columns, and products large enough for the parallel split
+	struct Shape
+	{
+		unsigned int m;
+		unsigned int k;
+		unsigned int n;
+	};
+
+	Shape const Shapes[] = {
+		{ 1, 1, 1 }, { 3, 0, 5 }, { 0, 4, 3 }, { 1, 37, 19 }, { 23, 41, 1 }, { 1, 300, 1 }, { 5, 7, 9 },
+		{ 47, 49, 51 }, { 129, 257, 9 }, { 131, 389, 133 }, { 257, 130, 263 }, { 7, 1030, 13 }, { 200, 3, 600 }
+	};
+
+
+	template <typename T> void testProducts()
+	{
+		for (Shape const & shape : Shapes)
+		{
+			Mat::Matrix<T> const a = makeMatrix<T>(shape.m, shape.k, shape.m + 1);
+			Mat::Matrix<T> const b = makeMatrix<T>(shape.k, shape.n, shape.n + 2);
+			TEST_CHECK(equal(a * b, Mat::multiplyReference(a, b)));
+		}
+	}
+
+} //Anonymous namespace
+
+
+
+int main()
+{
+	for (unsigned int threadCount : { 1u, 2u, 3u, 8u })
+	{
+		Mat::setThreadCount(threadCount);
+		testProducts<double>();
+		testProducts<float>();
+		testProducts<int>();
+	}
+	return Test::result();
+}
@@ -0,0 +1,109 @@
+#include <vector>
+
+#include "AllocationCounter.hpp"
+#include "Krylov.hpp"
+#include "SparseMatrix.hpp"
+#include "ThreadPool.hpp"
+#include "TestUtilities.hpp"
+
+
+
+namespace
+{
+
+	//5-point Laplacian on a side x side grid (symmetric positive definite), large enough for the chunked parallel reductions
+	Mat::SparseMatrix<double> makePoisson(unsigned int side)
+	{
+		unsigned int const n = side * side;
+		std::vector<Mat::SparseTriplet<double>> triplets;
+		triplets.reserve(5 * n);
+		for (unsigned int y = 0; y < side; ++y)
+		{
+			for (unsigned int x = 0; x < side; ++x)
+			{
+				unsigned int const row = y * side + x;
+				triplets.emplace_back(Mat::MN(row, row), 4.0);
+				if (x > 0)
+				{
+					triplets.emplace_back(Mat::MN(row, row - 1), -1.0);
+				}
+				if (x + 1 < side)
+				{
+					triplets.emplace_back(Mat::MN(row, row + 1), -1.0);
+				}
+				if (y > 0)
+				{
+					triplets.emplace_back(Mat::MN(row, row - side), -1.0);
+				}
+				if (y + 1 < side)
+				{
+					triplets.emplace_back(Mat::MN(row, row + side), -1.0);
+				}
+			}
+		}
+		return Mat::SparseMatrix<double>(Mat::XY(n, n), triplets);
+	}
+
+
+	//Solves twice with a tolerance that is never reached; the second solve (workspace and x already sized) must not allocate
+	template <typename Solver, typename Preconditioner> void checkNoAllocations(Mat::SparseMatrix<double> const & A, Mat::Vector<double> const & b, Preconditioner const & M)
+	{
+		Mat::SolverSettings<double> const settings(20, 0.0, 5);
+		Solver solver(b.getSize(), settings);
+		Mat::Vector<double> x(b.getSize(), 0.0);
+		solver.solve(A, b, x, M);
+
+		x.fillWith(0.0);
+		std::size_t const before = Mat::getOperatorNewCount();
+		Mat::SolverStatistics<double> const statistics = solver.solve(A, b, x, M);
+		std::size_t const allocations = Mat::getOperatorNewCount() - before;
+		TEST_CHECK(statistics.iterations > 0);
+#ifndef MATRIX_ENABLE_PROFILING
+		TEST_CHECK(allocations == 0);
+#else
+		static_cast<void>(allocations); //The profiler allocates while it records the spans of the iterations
+#endif
+	}
+
+
+	void testNoAllocations(unsigned int threadCount)
+	{
+		Mat::setThreadCount(threadCount);
+		Mat::SparseMatrix<double> const A = makePoisson(200);
+		Mat::Vector<double> const b(A.getSize().m(), 1.0);
+		Mat::JacobiPreconditioner<double> const jacobi(A);
+		Mat::ILU0Preconditioner<double> const ilu(A);
+
+		checkNoAllocations<Mat::ConjugateGradient<double>>(A, b, Mat::IdentityPreconditioner<double>());
+		checkNoAllocations<Mat::ConjugateGradient<double>>(A, b, jacobi);
+		checkNoAllocations<Mat::BiCGSTAB<double>>(A, b, Mat::IdentityPreconditioner<double>());
+		checkNoAllocations<Mat::BiCGSTAB<double>>(A, b, ilu);
+		checkNoAllocations<Mat::GMRES<double>>(A, b, Mat::IdentityPreconditioner<double>());
+		checkNoAllocations<Mat::GMRES<double>>(A, b, jacobi);
+	}
+
+
+	void testConvergence()
+	{
+		Mat::SparseMatrix<double> const A = makePoisson(16);
+		Mat::Vector<double> const b(A.getSize().m(), 1.0);
+		Mat::Vector<double> x;
+		Mat::ConjugateGradient<double> cg;
+		Mat::SolverStatistics<double> const statistics = cg.solve(A, b, x);
+		TEST_CHECK(statistics.converged());
+		Mat::Vector<double> r = A * x;
+		Mat::axpy(-1.0, b, r);
+		TEST_CHECK(Mat::nrm2(r) <= 1e-6 * Mat::nrm2(b));
+	}
+
+} //Anonymous namespace
+
+
+
+int main()
+{
+	testNoAllocations(1);
+	testNoAllocations(4);
+	testConvergence();
+	return Test::result();
+}
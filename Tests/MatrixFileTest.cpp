@@ -0,0 +1,87 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "MatrixFile.hpp"
+#include "TestUtilities.hpp"
+
+
+
+namespace
+{
+
+	//Writes header followed by dataSize zero bytes (at header.dataOffset) to path
+	void writeRawFile(std::string const & path, Mat::MatrixFileHeader const & header, std::size_t dataSize)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+		std::string const padding(static_cast<std::size_t>(header.dataOffset) - sizeof(header) + dataSize, '\0');
+		file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+	}
+
+
+	void testRoundTrip(std::string const & path)
+	{
+		Mat::Matrix<double> mat(Mat::XY(5, 3));
+		for (unsigned int i = 0; i < mat.getNumberOfEntries(); ++i)
+		{
+			mat.data()[i] = 0.5 * i;
+		}
+		for (Mat::MatrixFileLayout layout : { Mat::MatrixFileLayout::RowMajor, Mat::MatrixFileLayout::ColumnMajor })
+		{
+			Mat::writeMatrixFile(path, mat, layout);
+			Mat::Matrix<double> const read = Mat::readMatrixFile<double>(path);
+			TEST_CHECK(read.getSize() == mat.getSize());
+			TEST_CHECK(std::equal(read.data(), read.data() + read.getNumberOfEntries(), mat.data()));
+		}
+
+		Mat::writeMatrixFile(path, mat);
+		Mat::MappedMatrix<double> const mapped(path);
+		TEST_CHECK(mapped.at(Mat::XY(4, 2)) == mat.at(Mat::XY(4, 2)));
+		TEST_CHECK_THROWS(Mat::readMatrixFile<float>(path), Mat::MatrixFileException);
+	}
+
+
+	//Headers that lie about the entry size must be rejected before any entry is touched
+	void testMalformedHeaders(std::string const & path)
+	{
+		Mat::MatrixFileHeader const valid = Mat::makeMatrixFileHeader(Mat::MatrixFileElementType::Float64, sizeof(double), Mat::XY(4, 4), Mat::MatrixFileLayout::RowMajor);
+
+		Mat::MatrixFileHeader zeroSize = valid;
+		zeroSize.elementSize = 0;
+		writeRawFile(path, zeroSize, 16 * sizeof(double));
+		TEST_CHECK_THROWS(Mat::readMatrixFile<double>(path), Mat::MatrixFileException);
+		TEST_CHECK_THROWS(Mat::MatrixFileReader<double> reader(path), Mat::MatrixFileException);
+		TEST_CHECK_THROWS(Mat::MappedMatrix<double> mapped(path), Mat::MatrixFileException);
+
+		//With one byte per entry, the 128 data bytes would pass for 8 times as many rows
+		Mat::MatrixFileHeader inflated = valid;
+		inflated.elementSize = 1;
+		inflated.sizeY = 32;
+		writeRawFile(path, inflated, 16 * sizeof(double));
+		TEST_CHECK_THROWS(Mat::readMatrixFile<double>(path), Mat::MatrixFileException);
+		TEST_CHECK_THROWS(Mat::MatrixFileReader<double> reader(path), Mat::MatrixFileException);
+		TEST_CHECK_THROWS(Mat::MappedMatrix<double> mapped(path), Mat::MatrixFileException);
+
+		Mat::MatrixFileHeader truncated = valid;
+		truncated.sizeY = 5;
+		writeRawFile(path, truncated, 16 * sizeof(double));
+		TEST_CHECK_THROWS(Mat::MappedMatrix<double> mapped(path), Mat::MatrixFileException);
+
+		writeRawFile(path, valid, 16 * sizeof(double));
+		Mat::MappedMatrix<double> const mapped(path);
+		TEST_CHECK(mapped.at(Mat::XY(3, 3)) == 0.0);
+	}
+
+} //Anonymous namespace
+
+
+
+int main()
+{
+	std::string const path = "MatrixFileTest.matrix";
+	testRoundTrip(path);
+	testMalformedHeaders(path);
+	std::remove(path.c_str());
+	return Test::result();
+}
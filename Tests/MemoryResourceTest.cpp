@@ -0,0 +1,86 @@
+#include "Matrix.hpp"
+#include "Vector.hpp"
+#include "MemoryResource.hpp"
+#include "TestUtilities.hpp"
+
+
+
+namespace
+{
+
+	//The in-place operations must reuse the storage of their target: a steady-state loop allocates no buffers
+	void testSteadyStateLoop()
+	{
+		Mat::CountingResource counter;
+		Mat::ScopedMemoryResource scope(counter);
+		Mat::Matrix<double> A(Mat::XY(96, 96), 1.0);
+		Mat::Matrix<double> B(Mat::XY(96, 96), 0.5);
+		Mat::Matrix<double> C(Mat::XY(96, 96), 0.0);
+		Mat::Vector<double> x(96, 1.0);
+		Mat::Vector<double> y(96, 0.0);
+
+		counter.resetCounts();
+		for (int i = 0; i < 10; ++i)
+		{
+			C += A;
+			C -= B;
+			C *= 0.5;
+			C /= 2.0;
+			Mat::gemm(1.0, A, B, 1.0, C);
+			Mat::gemv(1.0, A, x, 0.5, y);
+			y += x;
+			y -= x;
+			y *= 0.5;
+			y /= 2.0;
+		}
+		TEST_CHECK(counter.getAllocationCount() == 0);
+		TEST_CHECK(counter.getDeallocationCount() == 0);
+	}
+
+
+	//A * B allocates the product, + C then writes into its storage instead of allocating a second buffer
+	void testExpiringOperand()
+	{
+		Mat::CountingResource counter;
+		Mat::ScopedMemoryResource scope(counter);
+		Mat::Matrix<double> const A(Mat::XY(64, 64), 1.0);
+		Mat::Matrix<double> const B(Mat::XY(64, 64), 2.0);
+		Mat::Matrix<double> const C(Mat::XY(64, 64), 3.0);
+
+		counter.resetCounts();
+		Mat::Matrix<double> const D = A * B + C;
+		TEST_CHECK(counter.getAllocationCount() == 1);
+		TEST_CHECK(D.at(Mat::XY(5, 7)) == 64.0 * 2.0 + 3.0);
+	}
+
+
+	//resize works in place: the matrix keeps its resource, whatever the default resource of the calling thread is
+	void testResizeKeepsResource()
+	{
+		Mat::ArenaResource arena;
+		Mat::Matrix<double> onHeap(Mat::XY(4, 3), 1.0);
+		Mat::Matrix<double> inArena(Mat::XY(4, 3), 2.0, &arena);
+		{
+			Mat::ScopedMemoryResource scope(arena);
+			onHeap.resize(Mat::XY(6, 5), 7.0);
+		}
+		inArena.resize(Mat::XY(2, 5), 8.0);
+		TEST_CHECK(onHeap.getMemoryResource() == Mat::getHeapResource());
+		TEST_CHECK(inArena.getMemoryResource() == &arena);
+		TEST_CHECK(onHeap.at(Mat::XY(3, 2)) == 1.0);
+		TEST_CHECK(onHeap.at(Mat::XY(5, 4)) == 7.0);
+		TEST_CHECK(inArena.at(Mat::XY(1, 2)) == 2.0);
+		TEST_CHECK(inArena.at(Mat::XY(1, 4)) == 8.0);
+	}
+
+} //Anonymous namespace
+
+
+
+int main()
+{
+	testSteadyStateLoop();
+	testExpiringOperand();
+	testResizeKeepsResource();
+	return Test::result();
+}
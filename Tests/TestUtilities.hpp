@@ -0,0 +1,62 @@
+#ifndef TEST_UTILITIES_HPP
+#define TEST_UTILITIES_HPP
+
+#include <iostream>
+
+
+
+namespace Test
+{
+
+	//Number of failed checks of the running test executable
+	inline int& failures()
+	{
+		static int count = 0;
+		return count;
+	}
+
+
+	//Reports a failed check (tests also run in Release builds, so assert is no option)
+	inline void check(bool condition, char const * expression, char const * file, int line)
+	{
+		if (!condition)
+		{
+			std::cerr << file << ":" << line << ": check failed: " << expression << std::endl;
+			++failures();
+		}
+	}
+
+
+	//Returns the exit code of the test executable
+	inline int result()
+	{
+		if (failures() != 0)
+		{
+			std::cerr << failures() << " check(s) failed" << std::endl;
+			return 1;
+		}
+		return 0;
+	}
+
+} //Namespace: Test
+
+
+#define TEST_CHECK(expression) Test::check(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
+
+//Checks that statement throws an exception of type exception
+#define TEST_CHECK_THROWS(statement, exception) \
+	do \
+	{ \
+		bool thrown = false; \
+		try \
+		{ \
+			statement; \
+		} \
+		catch (exception const &) \
+		{ \
+			thrown = true; \
+		} \
+		Test::check(thrown, #statement " throws " #exception, __FILE__, __LINE__); \
+	} while (false)
+
+#endif //TEST_UTILITIES_HPP